@@ -0,0 +1,417 @@
+/**
+ * @file    main.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Implements synthetic allocation and garbage collection benchmarks for the managed heap.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "Array.hpp"
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Member.hpp"
+#include "Root.hpp"
+
+namespace {
+
+// Only address space is reserved up front, the heap grows as the workloads need it
+using H = ssw::GrowableHeap<1024 * 1024 * 1024>;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Measurements of a single workload.
+ */
+struct Result {
+	/** The number of allocated objects. */
+	std::uint64_t allocations = 0;
+	/** The net size of the allocated objects. */
+	std::uint64_t bytes = 0;
+	/** The durations of all garbage collection pauses in microseconds. */
+	std::vector<double> pauses;
+};
+
+/**
+ * The state shared by the workloads: the measurements, the random number generator and the scale.
+ */
+class Bench
+{
+	Result mResult;
+	std::mt19937_64 mRandom;
+	const std::uint64_t mGcInterval;
+	std::uint64_t mSinceGc;
+	
+public:
+	
+	Bench(std::uint64_t seed, std::uint64_t gcInterval) : mRandom(seed), mGcInterval(gcInterval), mSinceGc(0) {
+	}
+	
+	Result& result() noexcept {
+		return mResult;
+	}
+	
+	/**
+	 * Get a uniformly distributed random number in `[0, bound)`.
+	 */
+	std::size_t random(std::size_t bound) {
+		return std::uniform_int_distribution<std::size_t>(0, bound - 1)(mRandom);
+	}
+	
+	/**
+	 * Run and time a full garbage collection.
+	 */
+	void gc() {
+		const auto start = Clock::now();
+		H::instance().gc();
+		mResult.pauses.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+		mSinceGc = 0;
+	}
+	
+	/**
+	 * Allocate an object, collecting garbage every `gcInterval` allocations and when the heap is full.
+	 */
+	template <typename T, typename... Args>
+	T* make(Args&&... args) {
+		if(++mSinceGc >= mGcInterval) {
+			this->gc();
+		}
+		this->count(sizeof(T));
+		try {
+			return new T(std::forward<Args>(args)...);
+		} catch(const std::bad_alloc&) {
+			this->gc();
+			return new T(std::forward<Args>(args)...);
+		}
+	}
+	
+	/**
+	 * Count an allocation of the specified size.
+	 */
+	void count(std::size_t size) noexcept {
+		mResult.allocations++;
+		mResult.bytes += size;
+	}
+};
+
+// ---- Linked list churn, like the StudentList of the demo
+
+struct Payload : ssw::HeapObject<Payload, H>
+{
+	static const ssw::TypeDescriptor &type;
+	std::uint64_t data[4];
+};
+
+const ssw::TypeDescriptor &Payload::type = *ssw::TypeDescriptor::make<Payload>();
+
+struct ListNode : ssw::HeapObject<ListNode, H>
+{
+	static const ssw::TypeDescriptor &type;
+	ssw::Member<ListNode> next;
+	ssw::Member<Payload> payload;
+	
+	ListNode(ListNode *next, Payload *payload) : next(next), payload(payload) {
+	}
+};
+
+const ssw::TypeDescriptor &ListNode::type = *ssw::TypeDescriptor::make<ListNode>(&ListNode::next,
+		&ListNode::payload);
+		
+struct List : ssw::HeapObject<List, H>
+{
+	static const ssw::TypeDescriptor &type;
+	ssw::Member<ListNode> first;
+};
+
+const ssw::TypeDescriptor &List::type = *ssw::TypeDescriptor::make<List>(&List::first);
+
+// Keep a list of a fixed length, replacing a random node with a new one at the head in every step
+void listChurn(Bench &bench, std::size_t scale) {
+	const std::size_t length = 10000;
+	ssw::Root<List> list{bench.make<List>()};
+	for(std::size_t i = 0; i < length; i++) {
+		list->first = bench.make<ListNode>(list->first, bench.make<Payload>());
+	}
+	
+	for(std::size_t step = 0; step < 50 * scale; step++) {
+		// Short walks keep the benchmark about allocation rather than pointer chasing
+		ListNode *prev = list->first;
+		for(auto skip = bench.random(64); skip > 0 && prev->next && prev->next->next; skip--) {
+			prev = prev->next;
+		}
+		prev->next = prev->next->next;
+		list->first = bench.make<ListNode>(list->first, bench.make<Payload>());
+	}
+}
+
+// ---- Binary trees, a long-lived tree and many short-lived ones
+
+struct TreeNode : ssw::HeapObject<TreeNode, H>
+{
+	static const ssw::TypeDescriptor &type;
+	ssw::Member<TreeNode> left;
+	ssw::Member<TreeNode> right;
+	
+	TreeNode(TreeNode *left, TreeNode *right) : left(left), right(right) {
+	}
+};
+
+const ssw::TypeDescriptor &TreeNode::type = *ssw::TypeDescriptor::make<TreeNode>(&TreeNode::left,
+		&TreeNode::right);
+		
+TreeNode* makeTree(Bench &bench, unsigned depth) {
+	if(depth == 0) {
+		return bench.make<TreeNode>(nullptr, nullptr);
+	}
+	// The subtrees must be rooted while the parent is allocated
+	ssw::Root<TreeNode> left{makeTree(bench, depth - 1)};
+	ssw::Root<TreeNode> right{makeTree(bench, depth - 1)};
+	return bench.make<TreeNode>(left, right);
+}
+
+void binaryTrees(Bench &bench, std::size_t scale) {
+	ssw::Root<TreeNode> longLived{makeTree(bench, 16)};
+	for(std::size_t i = 0; i < 4 * scale; i++) {
+		for(unsigned depth = 4; depth <= 12; depth += 4) {
+			makeTree(bench, depth);
+		}
+	}
+}
+
+// ---- Random graph, rewired continuously
+
+struct GraphNode : ssw::HeapObject<GraphNode, H>
+{
+	static const ssw::TypeDescriptor &type;
+	ssw::Member<GraphNode> a, b, c, d;
+	std::uint64_t id;
+	
+	explicit GraphNode(std::uint64_t id) : id(id) {
+	}
+	
+	ssw::Member<GraphNode>& edge(std::size_t index) noexcept {
+		return index == 0 ? a : index == 1 ? b : index == 2 ? c : d;
+	}
+};
+
+const ssw::TypeDescriptor &GraphNode::type = *ssw::TypeDescriptor::make<GraphNode>(&GraphNode::a,
+		&GraphNode::b, &GraphNode::c, &GraphNode::d);
+		
+struct NodeRef
+{
+	using HeapType = H;
+	static const ssw::TypeDescriptor &type;
+	ssw::Member<GraphNode> node;
+};
+
+const ssw::TypeDescriptor &NodeRef::type = *ssw::TypeDescriptor::make<NodeRef>(&NodeRef::node);
+
+void randomGraph(Bench &bench, std::size_t scale) {
+	const std::size_t numNodes = 20000;
+	// The nodes are kept alive by a managed array with a reference to each of them
+	ssw::Root<ssw::Array<NodeRef>> nodes{ssw::Array<NodeRef>::make(numNodes)};
+	bench.count(sizeof(NodeRef) * numNodes);
+	for(std::size_t i = 0; i < numNodes; i++) {
+		(*nodes)[i].node = bench.make<GraphNode>(i);
+	}
+	
+	for(std::size_t step = 0; step < 50 * scale; step++) {
+		// Replace a node, and link it to random nodes and random nodes to it
+		auto node = bench.make<GraphNode>(step);
+		for(std::size_t i = 0; i < 4; i++) {
+			node->edge(i) = (*nodes)[bench.random(numNodes)].node;
+		}
+		(*nodes)[bench.random(numNodes)].node->edge(bench.random(4)) = node;
+		(*nodes)[bench.random(numNodes)].node = node;
+	}
+}
+
+// ---- Mix of small objects and large buffers
+
+struct Buffer : ssw::HeapObject<Buffer, H>
+{
+	static const ssw::TypeDescriptor &type;
+	ssw::Member<Payload> header;
+	char data[16 * 1024];
+};
+
+const ssw::TypeDescriptor &Buffer::type = *ssw::TypeDescriptor::make<Buffer>(&Buffer::header);
+
+void largeAndSmall(Bench &bench, std::size_t scale) {
+	// A ring of recent objects, most of which are small
+	std::vector<ssw::Root<Payload>> small(4096);
+	std::vector<ssw::Root<Buffer>> large(64);
+	for(std::size_t step = 0; step < 100 * scale; step++) {
+		if(bench.random(64) == 0) {
+			auto buffer = bench.make<Buffer>();
+			buffer->header = bench.make<Payload>();
+			large[bench.random(large.size())] = buffer;
+		} else {
+			small[bench.random(small.size())] = bench.make<Payload>();
+		}
+	}
+}
+
+// ---- Explicit deallocation of short-lived objects
+
+void explicitDelete(Bench &bench, std::size_t scale) {
+	std::vector<ListNode*> live;
+	live.reserve(1024);
+	for(std::size_t step = 0; step < 100 * scale; step++) {
+		if(live.size() < 1024 && bench.random(2) == 0) {
+			// Deleted objects are never reachable, so they need not be rooted
+			live.push_back(bench.make<ListNode>(nullptr, nullptr));
+		} else if(!live.empty()) {
+			const auto index = bench.random(live.size());
+			delete live[index];
+			live[index] = live.back();
+			live.pop_back();
+		}
+	}
+	for(auto node : live) {
+		delete node;
+	}
+}
+
+/**
+ * Get the peak resident set size of the process in bytes, or `0` if it is not available.
+ */
+std::uint64_t peakRss() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#else
+	rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+#if defined(__APPLE__)
+	return usage.ru_maxrss;
+#else
+	return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double percentile(std::vector<double> values, double percentile) {
+	if(values.empty()) {
+		return 0;
+	}
+	std::sort(values.begin(), values.end());
+	const auto index = static_cast<std::size_t>(percentile / 100 * (values.size() - 1) + 0.5);
+	return values[index];
+}
+
+struct Workload {
+	const char *name;
+	void (*run)(Bench&, std::size_t);
+};
+
+const Workload workloads[] = {
+	{"list-churn", listChurn},
+	{"binary-trees", binaryTrees},
+	{"random-graph", randomGraph},
+	{"large-small", largeAndSmall},
+	{"explicit-delete", explicitDelete},
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+	std::size_t scale = 1000;
+	std::uint64_t seed = 42;
+	std::uint64_t gcInterval = 100000;
+	std::size_t sampleInterval = 0;
+	std::size_t markStackSize = H::instance().markStackSize();
+	std::size_t releaseThreshold = 0;
+	bool hugePages = false;
+	bool profile = false;
+	const char *only = nullptr;
+	for(int i = 1; i < argc; i++) {
+		if(std::strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+			scale = std::strtoul(argv[++i], nullptr, 10);
+		} else if(std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		} else if(std::strcmp(argv[i], "--gc-interval") == 0 && i + 1 < argc) {
+			gcInterval = std::strtoull(argv[++i], nullptr, 10);
+		} else if(std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+			profile = true;
+			sampleInterval = std::strtoull(argv[++i], nullptr, 10);
+		} else if(std::strcmp(argv[i], "--mark-stack") == 0 && i + 1 < argc) {
+			markStackSize = std::strtoul(argv[++i], nullptr, 10);
+		} else if(std::strcmp(argv[i], "--release") == 0 && i + 1 < argc) {
+			releaseThreshold = std::strtoul(argv[++i], nullptr, 10);
+		} else if(std::strcmp(argv[i], "--huge-pages") == 0) {
+			hugePages = true;
+		} else if(argv[i][0] != '-') {
+			only = argv[i];
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--scale N] [--seed N] [--gc-interval N] [--profile SAMPLE-BYTES]"
+					" [--mark-stack N] [--release MIN-BYTES] [--huge-pages] [workload]\n";
+			return 2;
+		}
+	}
+	
+	auto &heap = H::instance();
+	heap.largeObjectThreshold(4096);
+	heap.profileAllocations(profile);
+	heap.allocationSampleInterval(sampleInterval);
+	heap.markStackSize(markStackSize);
+	heap.releaseThreshold(releaseThreshold);
+	heap.hugePages(hugePages);
+	
+	std::cout << std::left << std::setw(16) << "workload" << std::right << std::setw(12) << "allocs"
+			<< std::setw(10) << "Malloc/s" << std::setw(9) << "MB/s" << std::setw(6) << "gcs"
+			<< std::setw(10) << "p50 us" << std::setw(10) << "p90 us" << std::setw(10) << "p99 us"
+			<< std::setw(10) << "max us" << std::setw(10) << "heap MB" << std::setw(11) << "free blks"
+			<< std::setw(11) << "avg free" << '\n';
+	std::cout << std::fixed;
+	for(const auto &workload : workloads) {
+		if(only && std::strcmp(only, workload.name) != 0) {
+			continue;
+		}
+		
+		Bench bench{seed, gcInterval};
+		const auto start = Clock::now();
+		workload.run(bench, scale);
+		const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		// Fragmentation is measured before the final collection, while the workload's objects are alive
+		const auto stats = heap.stats();
+		bench.gc();
+		
+		const auto &result = bench.result();
+		std::cout << std::left << std::setw(16) << workload.name << std::right << std::setw(12)
+				<< result.allocations << std::setprecision(2) << std::setw(10) << result.allocations / seconds / 1e6
+				<< std::setprecision(1) << std::setw(9) << result.bytes / seconds / (1024 * 1024)
+				<< std::setw(6) << result.pauses.size() << std::setw(10) << percentile(result.pauses, 50)
+				<< std::setw(10) << percentile(result.pauses, 90) << std::setw(10) << percentile(result.pauses, 99)
+				<< std::setw(10) << percentile(result.pauses, 100) << std::setw(10)
+				<< stats.heapSize / (1024.0 * 1024) << std::setw(11) << stats.numFreeBlocks << std::setw(11)
+				<< (stats.numFreeBlocks ? stats.freeBlockSize / stats.numFreeBlocks : 0) << '\n';
+	}
+	if(profile) {
+		std::cout << '\n';
+		heap.allocationProfile().write(std::cout, 5);
+	}
+	std::cout << "peak RSS: " << std::setprecision(1) << peakRss() / (1024.0 * 1024) << " MB\n";
+	return 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file    AllocationProfile.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the allocation profiling functions of {@link HeapBase} and the {@link AllocationProfile}.
+ */
+
+#include "AllocationProfile.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+
+#include "Heap.hpp"
+#include "RestoreStream.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#endif
+
+namespace ssw {
+
+namespace {
+
+/** The maximum number of return addresses captured for an allocation site. */
+constexpr int MaxSiteFrames = 32;
+
+/**
+ * Capture the return addresses of the call stack of the calling thread, leaving out the frames of the
+ * profiler itself.
+ */
+std::vector<void*> captureStack() {
+	void *frames[MaxSiteFrames];
+	int count = 0;
+#if defined(_WIN32)
+	count = CaptureStackBackTrace(0, MaxSiteFrames, frames, nullptr);
+#elif defined(__GLIBC__) || defined(__APPLE__)
+	count = backtrace(frames, MaxSiteFrames);
+#endif
+	// This function and recordSamples()
+	constexpr int skip = 2;
+	return count > skip ? std::vector<void*>(frames + skip, frames + count) : std::vector<void*>();
+}
+
+} // namespace
+
+void AllocationProfile::write(std::ostream &os, std::size_t maxSites) const {
+	RestoreStream restore{os};
+	os << "==== Allocation profile (" << collections << " collections) ====\n";
+	os << std::left << std::setw(40) << "Type" << std::right << std::setw(12) << "Allocs" << std::setw(14)
+			<< "Bytes" << std::setw(12) << "Live" << std::setw(12) << "Survivors" << std::setw(10) << "Lifetime"
+			<< '\n';
+	os << std::fixed << std::setprecision(2);
+	for(const auto &type : types) {
+		os << std::left << std::setw(40) << (type.type->name() ? type.type->name() : "<unnamed>") << std::right
+				<< std::setw(12) << type.allocations << std::setw(14) << type.bytes << std::setw(12)
+				<< type.liveObjects << std::setw(12) << type.survivors << std::setw(10) << type.averageLifetime()
+				<< '\n';
+	}
+	
+	if(!sampleInterval) {
+		return;
+	}
+	os << "\n= Allocation sites (one sample per " << sampleInterval << " bytes) =\n";
+	for(std::size_t i = 0; i < sites.size() && i < maxSites; i++) {
+		const auto &site = sites[i];
+		os << site.samples << " samples, ~" << site.estimatedBytes(sampleInterval) << " bytes of "
+				<< (site.type->name() ? site.type->name() : "<unnamed>") << '\n';
+		for(auto frame : site.frames) {
+			os << "    " << frame << '\n';
+		}
+	}
+}
+
+void HeapBase::profileAllocations(bool enable) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mProfiling.store(enable, std::memory_order_relaxed);
+}
+
+void HeapBase::allocationSampleInterval(std::size_t bytes) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mSampleInterval.store(bytes, std::memory_order_relaxed);
+	mSampleCountdown = bytes;
+}
+
+AllocationProfile HeapBase::allocationProfile() {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	AllocationProfile result{};
+	result.collections = mProfiledCollections;
+	result.sampleInterval = mSampleInterval.load(std::memory_order_relaxed);
+	
+	for(const auto &entry : mTypeCounters) {
+		const auto &counters = entry.second;
+		const auto live = counters.liveObjects.load(std::memory_order_relaxed);
+		result.types.push_back({entry.first, counters.allocations.load(std::memory_order_relaxed),
+				counters.bytes.load(std::memory_order_relaxed), live > 0 ? static_cast<std::uint64_t>(live) : 0,
+				counters.survivors, counters.survivals});
+	}
+	std::sort(result.types.begin(), result.types.end(), [](const auto &a, const auto &b) {
+		return a.bytes > b.bytes;
+	});
+	
+	for(const auto &entry : mSites) {
+		result.sites.push_back({entry.first.first, entry.first.second, entry.second.samples, entry.second.bytes});
+	}
+	std::sort(result.sites.begin(), result.sites.end(), [](const auto &a, const auto &b) {
+		return a.samples > b.samples;
+	});
+	return result;
+}
+
+void HeapBase::resetAllocationProfile() noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	// The entries stay, allocation buffers point to them
+	for(auto &entry : mTypeCounters) {
+		auto &counters = entry.second;
+		counters.allocations.store(0, std::memory_order_relaxed);
+		counters.bytes.store(0, std::memory_order_relaxed);
+		counters.liveObjects.store(0, std::memory_order_relaxed);
+		counters.survivors = 0;
+		counters.survivals = 0;
+	}
+	mProfiledCollections = 0;
+	mSites.clear();
+}
+
+HeapBase::TypeCounters& HeapBase::typeCounters(const TypeDescriptor &type) {
+	return mTypeCounters[&type];
+}
+
+void HeapBase::profileAllocation(const TypeDescriptor &type, std::size_t size, std::size_t count) noexcept {
+	// The objects are allocated already, so running out of memory for the profile only makes it incomplete
+	try {
+		auto &counters = this->typeCounters(type);
+		counters.allocations.fetch_add(count, std::memory_order_relaxed);
+		counters.bytes.fetch_add(size * count, std::memory_order_relaxed);
+		counters.liveObjects.fetch_add(static_cast<std::int64_t>(count), std::memory_order_relaxed);
+		
+		const auto interval = mSampleInterval.load(std::memory_order_relaxed);
+		if(interval) {
+			if(const auto samples = countSamples(mSampleCountdown, interval, size * count)) {
+				this->recordSamples(type, size, samples);
+			}
+		}
+	} catch(const std::bad_alloc&) {
+	}
+}
+
+std::uint64_t HeapBase::countSamples(std::size_t &countdown, std::size_t interval, std::size_t bytes) noexcept {
+	if(!countdown) {
+		countdown = interval;
+	}
+	if(bytes < countdown) {
+		countdown -= bytes;
+		return 0;
+	}
+	// The allocation crosses the sampling point, and maybe more for objects larger than the interval
+	const auto excess = bytes - countdown;
+	countdown = interval - excess % interval;
+	return 1 + excess / interval;
+}
+
+void HeapBase::recordSamples(const TypeDescriptor &type, std::size_t size, std::uint64_t samples) {
+	auto &site = mSites[std::make_pair(&type, captureStack())];
+	site.samples += samples;
+	site.bytes += samples * size;
+}
+
+void HeapBase::recordSurvivors() noexcept {
+	mProfiledCollections++;
+	for(auto &entry : mTypeCounters) {
+		auto &counters = entry.second;
+		const auto live = counters.liveObjects.load(std::memory_order_relaxed);
+		counters.survivors = live > 0 ? static_cast<std::uint64_t>(live) : 0;
+		counters.survivals += counters.survivors;
+	}
+}
+
+} // namespace ssw
@@ -0,0 +1,91 @@
+/**
+ * @file    CardTable.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the card table functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+
+#include "HeapBlock.hpp"
+
+namespace ssw {
+
+namespace {
+
+/**
+ * Get the number of leading zero bits in the specified word, which must not be zero.
+ */
+inline std::size_t countLeadingZeros(std::uintptr_t word) noexcept {
+	assert(word != 0);
+#if defined(__GNUC__)
+	return static_cast<std::size_t>(__builtin_clzll(word))
+			- (sizeof(unsigned long long) - sizeof(word)) * CHAR_BIT;
+#else
+	std::size_t result = 0;
+	for(auto mask = std::uintptr_t{1} << (sizeof(word) * CHAR_BIT - 1); (word & mask) == 0; mask >>= 1) {
+		result++;
+	}
+	return result;
+#endif
+}
+
+} // namespace
+
+void HeapBase::cardTable(bool enable) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	this->stopTlabs();
+	mUseCards = enable && mCards;
+	if(mUseCards) {
+		// The bitmap is not maintained while the card table is disabled, and stores before enabling were
+		// not necessarily recorded
+		this->rebuildBlockStarts();
+		const auto cards = std::min(mNumCards, cardTableSize(this->storageSize()));
+		for(std::size_t i = 0; i < cards; i++) {
+			mCards[i].store(1, std::memory_order_relaxed);
+		}
+	}
+	this->resumeTlabs();
+}
+
+void HeapBase::clearCards() noexcept {
+	// Cards beyond the committed storage are cleared when the storage grows
+	const auto cards = std::min(mNumCards, cardTableSize(this->storageSize()));
+	for(std::size_t i = 0; i < cards; i++) {
+		mCards[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+HeapBase::Block* HeapBase::blockStart(const byte *ptr) const noexcept {
+	assert(mUseCards && ptr >= reinterpret_cast<const byte*>(mHeapStart));
+	
+	const auto bit = this->markBit(reinterpret_cast<const Block*>(ptr));
+	std::size_t index = bit / MarkBitsPerWord;
+	// Ignore blocks after the address in the first word, then scan whole words backwards
+	auto word = mBlockStarts[index].load(std::memory_order_relaxed);
+	word &= ~std::uintptr_t{0} >> (MarkBitsPerWord - 1 - bit % MarkBitsPerWord);
+	while(word == 0) {
+		// The first block always starts at the beginning of the heap
+		assert(index > 0);
+		word = mBlockStarts[--index].load(std::memory_order_relaxed);
+	}
+	return reinterpret_cast<Block*>(reinterpret_cast<byte*>(mHeapStart) +
+			(index * MarkBitsPerWord + MarkBitsPerWord - 1 - countLeadingZeros(word)) * Align);
+}
+
+void HeapBase::rebuildBlockStarts() noexcept {
+	const auto words = markBitmapWords(
+			reinterpret_cast<byte*>(mStorageEnd) - reinterpret_cast<byte*>(mHeapStart));
+	for(std::size_t i = 0; i < words; i++) {
+		mBlockStarts[i].store(0, std::memory_order_relaxed);
+	}
+	for(auto blk = mHeapStart; blk < mHeapEnd; blk = blk->following()) {
+		this->setBlockStart(blk);
+	}
+}
+
+} // namespace ssw
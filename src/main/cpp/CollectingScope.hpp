@@ -0,0 +1,44 @@
+/**
+ * @file    CollectingScope.hpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the {@link HeapBase::CollectingScope} class.
+ */
+
+#ifndef COLLECTINGSCOPE_HPP_
+#define COLLECTINGSCOPE_HPP_
+#pragma once
+
+#include <utility>
+
+#include "Heap.hpp"
+
+namespace ssw {
+
+/**
+ * Marks the heap as collecting from its construction to its destruction, so that allocations made by
+ * collection code, e.g. in destructors of garbage objects, do not start an automatic collection (see
+ * {@link HeapBase::collectForAllocation}). Scopes may be nested. Must only be used with the heap lock held.
+ */
+class HeapBase::CollectingScope
+{
+	HeapBase &mHeap;
+	const bool mOuter;
+	
+public:
+	
+	explicit CollectingScope(HeapBase &heap) noexcept
+			: mHeap(heap), mOuter(std::exchange(heap.mCollecting, true)) {
+	}
+	
+	~CollectingScope() {
+		mHeap.mCollecting = mOuter;
+	}
+	
+	CollectingScope(const CollectingScope&) = delete;
+	CollectingScope& operator=(const CollectingScope&) = delete;
+}; // class HeapBase::CollectingScope
+
+} // namespace ssw
+
+#endif /* COLLECTINGSCOPE_HPP_ */
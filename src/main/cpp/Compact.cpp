@@ -0,0 +1,183 @@
+/**
+ * @file    Compact.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the compaction functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "CollectingScope.hpp"
+#include "HeapBlock.hpp"
+#include "PhaseTimer.hpp"
+
+namespace ssw {
+
+/**
+ * The planned move of a live object during compaction.
+ */
+struct HeapBase::Relocation
+{
+	/** The current location of the object. */
+	Block *from;
+	/** The new location of the object, equal to {@link from} if the object is not moved. */
+	Block *to;
+	/** The usable size of the block at the new location, which may include padding. */
+	std::size_t size;
+};
+
+void HeapBase::compact() noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	CollectingScope collecting{*this};
+	PhaseTimer timer{*this, GcPhase::Compaction};
+	if(mMarking.load(std::memory_order_relaxed)) {
+		this->finishCollection();
+	}
+	this->beginCollection();
+	{
+		PhaseTimer markTimer{*this, GcPhase::Mark};
+		this->markRoots();
+	}
+	// Unreachable objects are destroyed while planning
+	this->clearWeakRefs();
+	
+	std::vector<Relocation> relocations;
+	this->planCompaction(relocations);
+	// Large objects are not moved, but their fields are updated like those of other live objects
+	this->sweepLargeObjects();
+	this->updatePointers(relocations);
+	this->moveObjects(relocations);
+	this->recordLiveObjects();
+	this->notifyWeakTables();
+	// Objects were moved all over the old generation
+	this->touchPages(mHeapStart, mHeapEnd);
+	this->releaseFreeMemory();
+	
+	// The free space is at the end of the old generation now, which is where the nursery is taken from and
+	// where the storage shrinks
+	this->resizeStorage();
+	this->ensureNursery();
+	this->resumeTlabs();
+}
+
+void HeapBase::pin(void *object) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	assert(!this->inNursery(static_cast<byte*>(object)) /* Young objects cannot be pinned */);
+	block(static_cast<byte*>(object)).pinned(true);
+}
+
+void HeapBase::unpin(void *object) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	block(static_cast<byte*>(object)).pinned(false);
+}
+
+void HeapBase::planCompaction(std::vector<Relocation> &relocations) noexcept {
+	// The gap before a pinned object or the end of the heap may be too small for a free block, in which
+	// case it becomes padding of the object before it. There always is one, because the gap would be as
+	// large as the blocks that were there otherwise.
+	const auto padGap = [&relocations](const byte *to, const Block *next) {
+		const auto gap = static_cast<std::size_t>(reinterpret_cast<const byte*>(next) - to);
+		if(gap > 0 && gap < Align + MinBlockSize) {
+			assert(!relocations.empty());
+			relocations.back().size += gap;
+		}
+	};
+	
+	byte *to = reinterpret_cast<byte*>(mHeapStart);
+	for(auto blk = mHeapStart; blk < mHeapEnd; blk = blk->following()) {
+		if(blk->free()) {
+			continue;
+		} else if(!this->marked(blk)) {
+			destroy(blk);
+			continue;
+		}
+		
+		const auto size = align(blk->size());
+		if(blk->pinned()) {
+			padGap(to, blk);
+			relocations.push_back({blk, blk, size});
+			to = reinterpret_cast<byte*>(blk->following());
+		} else {
+			// Sliding never moves an object to a higher address, so it always fits before the next pinned one
+			relocations.push_back({blk, reinterpret_cast<Block*>(to), size});
+			to += Align + size;
+		}
+	}
+	padGap(to, mHeapEnd);
+}
+
+void HeapBase::updatePointers(const std::vector<Relocation> &relocations) noexcept {
+	const auto relocate = [&relocations](byte *&ptr) {
+		if(!ptr) {
+			return;
+		}
+		const Block *target = &block(ptr);
+		auto it = std::lower_bound(relocations.begin(), relocations.end(), target,
+				[](const Relocation &relocation, const Block *blk) { return relocation.from < blk; });
+		if(it != relocations.end() && it->from == target) {
+			ptr = it->to->data();
+		}
+	};
+	
+	this->forEachRoot(relocate);
+	for(auto &ref : mWeakRefs) {
+		relocate(ref);
+	}
+	const auto relocateFields = [&relocate](Block *blk) {
+		// Marks may be kept in the block header, so type() cannot be used
+		forEachField(blk, blk->markedType(), relocate);
+	};
+	for(auto &relocation : relocations) {
+		relocateFields(relocation.from);
+	}
+	for(auto large = mLargeObjects; large; large = large->next) {
+		relocateFields(large->block());
+	}
+}
+
+void HeapBase::moveObjects(const std::vector<Relocation> &relocations) noexcept {
+	this->clearFreeLists();
+	
+	// Objects only move to lower addresses, so moving them in address order never overwrites one that has not
+	// been moved yet
+	Block *end = mHeapStart;
+	for(auto &relocation : relocations) {
+		Block *blk = relocation.to;
+		if(blk != relocation.from) {
+			std::memmove(blk, relocation.from, Align + align(relocation.from->size()));
+		}
+		blk->size(relocation.size);
+		blk->prevFree(false);
+		if(!mUseMarkBits) {
+			blk->mark(false);
+		}
+		
+		if(blk > end) {
+			this->addFreeBlock(new(end) Block(
+					reinterpret_cast<byte*>(blk) - reinterpret_cast<byte*>(end) - Align));
+		}
+		end = blk->following();
+	}
+	if(end < mHeapEnd) {
+		this->addFreeBlock(new(end) Block(
+				reinterpret_cast<byte*>(mHeapEnd) - reinterpret_cast<byte*>(end) - Align));
+	} else {
+		this->prevFree(mHeapEnd, false);
+	}
+	
+	if(mUseMarkBits) {
+		this->clearMarkBitmap();
+	}
+	if(mUseCards) {
+		this->rebuildBlockStarts();
+	}
+}
+
+} // namespace ssw
@@ -0,0 +1,112 @@
+/**
+ * @file    GcEvents.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the garbage collection event functions of {@link HeapBase} and the event types.
+ */
+
+#include "GcEvents.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "Heap.hpp"
+#include "RestoreStream.hpp"
+
+namespace ssw {
+
+const char* gcPhaseName(GcPhase phase) noexcept {
+	switch(phase) {
+	case GcPhase::Collection:
+		return "Collection";
+	case GcPhase::IncrementalStep:
+		return "IncrementalStep";
+	case GcPhase::MinorCollection:
+		return "MinorCollection";
+	case GcPhase::Compaction:
+		return "Compaction";
+	case GcPhase::Mark:
+		return "Mark";
+	case GcPhase::Sweep:
+		return "Sweep";
+	case GcPhase::Merge:
+		return "Merge";
+	}
+	return "Unknown";
+}
+
+void PauseHistogram::record(std::chrono::nanoseconds duration) noexcept {
+	const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+	std::size_t index = 0;
+	while(index + 1 < NumBuckets && (std::int64_t{2} << index) <= us) {
+		index++;
+	}
+	mBuckets[index]++;
+	mCount++;
+	mTotal += duration;
+	mMax = std::max(mMax, duration);
+}
+
+std::chrono::nanoseconds PauseHistogram::percentile(double percentile) const noexcept {
+	// The number of pauses that are at most as long as the percentile
+	const auto rank = static_cast<std::uint64_t>(percentile / 100 * mCount + 0.5);
+	std::uint64_t seen = 0;
+	for(std::size_t i = 0; i + 1 < NumBuckets; i++) {
+		seen += mBuckets[i];
+		if(seen >= rank) {
+			return std::min<std::chrono::nanoseconds>(bucketStart(i + 1), mMax);
+		}
+	}
+	return mMax;
+}
+
+ChromeTraceWriter::ChromeTraceWriter(std::ostream &os)
+		: mStream(os), mEpoch(std::chrono::steady_clock::now()), mFirst(true) {
+	mStream << "[";
+}
+
+ChromeTraceWriter::~ChromeTraceWriter() {
+	mStream << "\n]\n";
+	mStream.flush();
+}
+
+void ChromeTraceWriter::gcEvent(const GcEvent &event) noexcept {
+	RestoreStream restore{mStream};
+	const auto ts = std::chrono::duration<double, std::micro>(event.start - mEpoch).count();
+	const auto dur = std::chrono::duration<double, std::micro>(event.duration).count();
+	mStream << (mFirst ? "\n" : ",\n") << std::fixed;
+	mStream.precision(3);
+	mStream << "{\"name\":\"" << gcPhaseName(event.phase) << "\",\"cat\":\"gc\",\"ph\":\"X\",\"ts\":" << ts
+			<< ",\"dur\":" << dur << ",\"pid\":0,\"tid\":" << std::hash<std::thread::id>()(std::this_thread::get_id())
+			<< ",\"args\":{\"reclaimed\":" << event.reclaimed << "}}";
+	mFirst = false;
+}
+
+void HeapBase::gcListener(GcListener *listener) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mGcListener = listener;
+}
+
+PauseHistogram HeapBase::pauseHistogram() noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	return mPauseHistogram;
+}
+
+std::size_t HeapBase::currentObjectSize() noexcept {
+	HeapStats counts{};
+	this->countTlabObjects(counts);
+	return mStats.objectSize + counts.objectSize;
+}
+
+void HeapBase::gcEvent(const GcEvent &event) noexcept {
+	if(gcPhaseIsPause(event.phase)) {
+		mPauseHistogram.record(event.duration);
+	}
+	if(mGcListener) {
+		mGcListener->gcEvent(event);
+	}
+}
+
+} // namespace ssw
@@ -0,0 +1,71 @@
+/**
+ * @file    GcPolicy.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the functions of {@link HeapBase} that run garbage collection automatically.
+ */
+
+#include "Heap.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace ssw {
+
+void HeapBase::gcPolicy(const GcPolicy &policy) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mGcPolicy = policy;
+	mAllocationBudget = policy.minBudget;
+}
+
+HeapBase::GcPolicy HeapBase::gcPolicy() noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	return mGcPolicy;
+}
+
+std::size_t HeapBase::allocationBudget() noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	return mAllocationBudget;
+}
+
+double HeapBase::survivalRate() noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	return mSurvivalRate;
+}
+
+bool HeapBase::collectForAllocation(bool failed) noexcept {
+	if(!(failed ? mGcPolicy.collectOnFailure : mGcPolicy.collectOnBudget)) {
+		return false;
+	}
+	if(mCollecting || mNoAutoGc) {
+		return false;
+	}
+	// There is no safepoint to stop the other threads, which may hold objects they have just bump allocated
+	// in plain pointers (see tlabSize)
+	if(mTlabSize.load(std::memory_order_relaxed) && mTlabs.size() > 1) {
+		return false;
+	}
+	if(!failed) {
+		// Objects in allocation buffers are only counted when the buffer is retired, which happens whenever
+		// a thread needs a new one, so the budget is checked at least that often
+		if(mAllocatedSize < mAllocationBudget || mMarking.load(std::memory_order_relaxed)) {
+			return false;
+		}
+	}
+	this->gc();
+	return true;
+}
+
+void HeapBase::tuneAllocationBudget() noexcept {
+	const auto live = static_cast<double>(mStats.liveObjectSize);
+	mSurvivalRate = mObjectSizeBeforeGc ? std::min(live / mObjectSizeBeforeGc, 1.0) : 0;
+	
+	// With budget b and live size l, the next collection starts at l + b and has the survival rate
+	// l / (l + b) if the live size stays the same
+	const auto target = std::min(std::max(mGcPolicy.targetSurvivalRate, 0.01), 0.99);
+	const auto budget = live * (1 - target) / target;
+	mAllocationBudget = budget >= static_cast<double>(mGcPolicy.maxBudget) ? mGcPolicy.maxBudget
+			: std::max(static_cast<std::size_t>(budget), mGcPolicy.minBudget);
+}
+
+} // namespace ssw
@@ -9,13 +9,18 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iomanip>
 #include <iterator>
 #include <utility>
 #include <type_traits>
 
+#include "CollectingScope.hpp"
+#include "HeapBlock.hpp"
+#include "PhaseTimer.hpp"
 #include "RestoreStream.hpp"
 #include "TaggedPointer.hpp"
+#include "VirtualMemory.hpp"
 
 namespace ssw {
 
@@ -35,307 +40,878 @@ std::ostream& operator<<(std::ostream &os, FixedWidthSize<Width> size) {
 	return os << std::setw(Width) << size.value;
 }
 
-} // namespace
-
 /**
- * Represents a block of memory in the heap. This class holds the block size and either a pointer to the
- * type of the stored object (in case the block is used) or a pointer to the next free block.
+ * Get the number of trailing zero bits in the specified word, which must not be zero.
  */
-class alignas(HeapBase::Align) HeapBase::Block
-{
-	std::size_t mSize;
-	TaggedPointer mPtr;
-	
-public:
-	
-	/**
-	 * Initialize a new, free block with the specified size.
-	 * 
-	 * @param size The usable size of the block (will be properly aligned).
-	 * @param next (optional) The next block in the free list.
-	 */
-	explicit Block(std::size_t size, Block *next = nullptr) noexcept 
-			: mSize(size), mPtr(next) {
-		assert(size >= Align);
-		mPtr.free(true);
+inline std::size_t countTrailingZeros(std::uintptr_t word) noexcept {
+	assert(word != 0);
+#if defined(__GNUC__)
+	return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+	std::size_t result = 0;
+	for(; (word & 1) == 0; word >>= 1) {
+		result++;
 	}
+	return result;
+#endif
+}
+
+} // namespace
+
+constexpr std::size_t HeapBase::NoRootHandle;
+constexpr std::size_t ThreadHeap::NoRootHandle;
+
+HeapBase::HeapBase(byte *storage, std::size_t size, std::atomic<std::uintptr_t> *markBits,
+		std::atomic<std::uint8_t> *cards, std::atomic<std::uintptr_t> *blockStarts, std::size_t maxSize) noexcept
+		: mFreeLists(),
+		  mHeapStart(reinterpret_cast<Block*>(storage)),
+		  mHeapEnd(reinterpret_cast<Block*>(storage + (size & ~(Align - 1)))),
+		  mLastBlockFree(false),
+		  mStorageEnd(mHeapEnd),
+		  mStorageLimit(maxSize ? reinterpret_cast<Block*>(storage + (maxSize & ~(Align - 1))) : mHeapEnd),
+		  mMinStorageSize(size & ~(Align - 1)),
+		  mReservedSize(0),
+		  mRoots(),
+		  mRootHandles(),
+		  mRootSlots(),
+		  mFreeRootHandle(NoRootHandle),
+		  mShadowStacks(),
+		  mWeakRefs(),
+		  mFreeWeakRefs(),
+		  mWeakTables(),
+		  mSweepCursor(mHeapEnd),
+		  mLazySweep(false),
+		  mReleaseThreshold(0),
+		  mHugePages(false),
+		  mReleasedPages(),
+		  mSweeper(),
+		  mSweepWork(),
+		  mSweeperExit(false),
+		  mMarkBits(markBits),
+		  mMarkWords(markBits ? markBitmapWords(maxSize ? maxSize : size) : 0),
+		  mUseMarkBits(false),
+		  mMarkThreads(1),
+		  mMarkStackSize(DefaultMarkStackSize),
+		  mMarkStack(),
+		  mMarking(false),
+		  mGreyObjects(),
+		  mDeferredFrees(),
+		  mMutex(),
+		  mTlabs(),
+		  mTlabSize(0),
+		  mTlabStops(0),
+		  mTlabsStopped(false),
+		  mNurseryTop(mHeapEnd),
+		  mNurserySize(0),
+		  mCards(blockStarts ? cards : nullptr),
+		  mNumCards(mCards ? cardTableSize(maxSize ? maxSize : size) : 0),
+		  mBlockStarts(mCards ? blockStarts : nullptr),
+		  mUseCards(false),
+		  mLargeObjects(nullptr),
+		  mLargeObjectThreshold(0),
+		  mLargeObjectsSize(0),
+		  mStats(),
+		  mGcListener(nullptr),
+		  mPauseHistogram(),
+		  mGcPolicy(),
+		  mAllocationBudget(mGcPolicy.minBudget),
+		  mAllocatedSize(0),
+		  mObjectSizeBeforeGc(0),
+		  mSurvivalRate(0),
+		  mNoAutoGc(false),
+		  mCollecting(false),
+		  mProfiling(false),
+		  mTypeCounters(),
+		  mProfiledCollections(0),
+		  mSampleInterval(0),
+		  mSampleCountdown(0),
+		  mSites() {
+	static_assert(sizeof(Block) <= Align, "Block class is too large");
+	static_assert(sizeof(Block*) + sizeof(std::size_t) <= MinBlockSize,
+			"Free blocks are too small for boundary tags");
+			
+	assert((reinterpret_cast<std::uintptr_t>(storage) & (Align - 1)) == 0);
+	assert(size >= Align + MinBlockSize && (!maxSize || maxSize >= size));
 	
-	/**
-	 * Get the data size of this block.
-	 * 
-	 * @return The usable size of this block, not including the block descriptor.
-	 */
-	std::size_t size() const noexcept {
-		return mSize;
+	this->addFreeBlock(new(mHeapStart) Block(
+			reinterpret_cast<byte*>(mHeapEnd) - reinterpret_cast<byte*>(mHeapStart) - Align));
+	this->clearMarkBitmap();
+	this->clearCards();
+	// Construct the mutex before any heap is done, so it outlives static heaps
+	threadRecordMutex();
+}
+
+HeapBase::HeapBase(std::size_t size, std::size_t maxSize)
+		: HeapBase(reserveStorage(size, maxSize), size, maxSize) {
+}
+
+HeapBase::HeapBase(byte *reservation, std::size_t size, std::size_t maxSize) noexcept
+		: HeapBase(reservation, size,
+				reinterpret_cast<std::atomic<std::uintptr_t>*>(reservation + maxSize),
+				reinterpret_cast<std::atomic<std::uint8_t>*>(
+						reservation + maxSize + 2 * markBitmapWords(maxSize) * sizeof(std::uintptr_t)),
+				reinterpret_cast<std::atomic<std::uintptr_t>*>(
+						reservation + maxSize + markBitmapWords(maxSize) * sizeof(std::uintptr_t)),
+				maxSize) {
+	mReservedSize = reservationSize(maxSize);
+}
+
+HeapBase::~HeapBase() {
+	this->detachShadowStacks();
+	this->detachTlabs();
+	std::unique_lock<std::recursive_mutex> lock{mMutex};
+	this->stopSweeper(lock);
+	while(mLargeObjects) {
+		this->freeLarge(mLargeObjects->block());
 	}
-	
-	/**
-	 * Mark this block as free and set the next block in the free list.
-	 * 
-	 * @param next The next block in the free list, or `nullptr`.
-	 */
-	void next(Block *next) noexcept {
-		assert(next != this);
-		mPtr = next;
-		mPtr.free(true);
+	if(mReservedSize) {
+		VirtualMemory::unmap(mHeapStart, mReservedSize);
 	}
+}
+
+std::mutex& HeapBase::threadRecordMutex() noexcept {
+	static std::mutex mutex;
+	return mutex;
+}
+
+std::size_t HeapBase::sizeClass(std::size_t size) noexcept {
+	assert(size >= Align && size == align(size));
 	
-	/**
-	 * Mark this block as free and set its successor and size.
-	 * 
-	 * @param next The next block in the free list, or `nullptr`.
-	 * @param size The usable size of this block, not including the block descriptor.
-	 */
-	void next(Block *next, std::size_t size) noexcept {
-		this->next(next);
-		assert(size >= Align);
-		mSize = size;
+	if(size <= MaxExactSize) {
+		return size / Align - 1;
 	}
-	
-	/**
-	 * Get the next block in the free list. This block must represent a free block.
-	 * 
-	 * @return Pointer to the next block in the free list.
-	 */
-	Block* next() const noexcept {
-		assert(this->free() && !this->mark());
-		return mPtr.get<Block>();
+	// Power-of-two bins, the first one starts right after the largest exact size
+	std::size_t bin = NumExactClasses;
+	for(auto limit = 2 * MaxExactSize; size >= limit && bin < NumSizeClasses - 1; limit <<= 1) {
+		bin++;
 	}
-	
-	/**
-	 * Get a pointer to the block following this block in the heap.
-	 * 
-	 * @return Pointer to the physically next block in the heap.
-	 */
-	Block* following() const noexcept {
-		return reinterpret_cast<Block*>(this->data() + align(mSize));
+	return bin;
+}
+
+void HeapBase::addFreeBlock(Block *blk) noexcept {
+	auto &list = mFreeLists[sizeClass(blk->size())];
+	blk->next(list);
+	blk->prev(nullptr);
+	if(list) {
+		list->prev(blk);
 	}
-	
-	/**
-	 * Mark this block as used and set the data type.
-	 * 
-	 * @param type The type descriptor for the data in this block.
-	 */
-	void type(const TypeDescriptor &type) noexcept {
-		mPtr = &type;
-		mPtr.free(false);
+	list = blk;
+	this->prevFree(blk->following(), true);
+	mStats.numFreeBlocks++;
+	mStats.freeBlockSize += blk->size();
+}
+
+void HeapBase::removeFreeBlock(Block *blk) noexcept {
+	const auto next = blk->next();
+	const auto prev = blk->prev();
+	if(prev) {
+		prev->next(next);
+	} else {
+		assert(mFreeLists[sizeClass(blk->size())] == blk);
+		mFreeLists[sizeClass(blk->size())] = next;
 	}
-	
-	/**
-	 * Get the data type in this block. This block must represent a used block.
-	 * 
-	 * @return Reference to the type descriptor for the data in this block.
-	 */
-	const TypeDescriptor& type() const noexcept {
-		assert(this->used() && !this->mark());
-		return *mPtr.get<const TypeDescriptor>();
+	if(next) {
+		next->prev(prev);
 	}
-	
-	/**
-	 * Get whether this block is free.
-	 * 
-	 * @return `true` if this block is part of the free list and does not hold an object.
-	 */
-	bool free() const noexcept {
-		return mPtr.free();
+	mStats.numFreeBlocks--;
+	mStats.freeBlockSize -= blk->size();
+}
+
+void HeapBase::prevFree(Block *blk, bool prevFree) noexcept {
+	if(blk < mHeapEnd) {
+		blk->prevFree(prevFree);
+	} else if(blk == mHeapEnd) {
+		mLastBlockFree = prevFree;
 	}
-	
-	/**
-	 * Get whether this block is used.
-	 * 
-	 * @return `true` if this block contains an object and is not part of the free list.
-	 */
-	bool used() const noexcept {
-		return mPtr.used();
+}
+
+void* HeapBase::allocate(const TypeDescriptor &type, bool isRoot) noexcept {
+	const auto threshold = mLargeObjectThreshold.load(std::memory_order_relaxed);
+	if(threshold && type.size() > threshold) {
+		std::lock_guard<std::recursive_mutex> lock{mMutex};
+		this->collectForAllocation(false);
+		void *result = this->allocateLarge(type, type.size());
+		if(!result) {
+			result = this->allocateAfterCollection([this, &type] {
+				return this->allocateLarge(type, type.size());
+			});
+		}
+		if(result) {
+			mStats.numObjects++;
+			mStats.objectSize += type.size();
+			mAllocatedSize += type.size();
+			if(mProfiling.load(std::memory_order_relaxed)) {
+				this->profileAllocation(type, type.size());
+			}
+		}
+		if(result && isRoot) {
+			this->registerRoot(result);
+		}
+		return result;
 	}
 	
-	/**
-	 * Get the GC mark for this block.
-	 * 
-	 * @return `true` if the mark is set, `false` otherwise.
-	 */
-	bool mark() const noexcept {
-		return mPtr.mark();
+	const bool young = !isRoot && mNurserySize.load(std::memory_order_relaxed);
+	if(!isRoot && !young && mTlabSize.load(std::memory_order_relaxed)) {
+		if(auto result = this->allocateFromTlab(type)) {
+			return result;
+		}
 	}
 	
-	/**
-	 * Get the pointer in this block.
-	 * 
-	 * @return Reference to the pointer.
-	 */
-	TaggedPointer& ptr() noexcept {
-		return mPtr;
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	this->collectForAllocation(false);
+	const bool marking = mMarking.load(std::memory_order_relaxed);
+	if(marking) {
+		// Allocation paces incremental marking
+		this->markIncrementally(AllocationMarkWork);
+	}
+	// Incremental marking only deals with the old generation, so the nursery stays empty until it is done
+	void *result = (young && !marking) ? this->allocateYoung(type) : nullptr;
+	if(!result && !isRoot && (result = this->refillTlab(type))) {
+		// Objects in allocation buffers are counted by the buffer, except in the allocation profile
+		if(mProfiling.load(std::memory_order_relaxed)) {
+			this->profileAllocation(type, type.size());
+		}
+		return result;
+	}
+	if(!result) {
+		result = this->allocateOld(type, align(type.size()));
+	}
+	if(result) {
+		mStats.numObjects++;
+		mStats.objectSize += type.size();
+		mAllocatedSize += type.size();
+		if(mProfiling.load(std::memory_order_relaxed)) {
+			this->profileAllocation(type, type.size());
+		}
+	}
+	if(result && isRoot) {
+		this->registerRoot(result);
+	}
+	return result;
+}
+
+std::size_t HeapBase::allocateBatch(const TypeDescriptor &type, std::size_t count, void **objects) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	this->collectForAllocation(false);
+	// The objects allocated first are not constructed while the others are allocated
+	const bool noAutoGc = std::exchange(mNoAutoGc, true);
+	std::size_t allocated = 0;
+	const auto threshold = mLargeObjectThreshold.load(std::memory_order_relaxed);
+	if(threshold && type.size() > threshold) {
+		// Large objects have a mapping of their own each
+		for(; allocated < count && (objects[allocated] = this->allocateLarge(type, type.size())); allocated++) {
+		}
+		std::fill(objects + allocated, objects + count, nullptr);
+		mStats.numObjects += allocated;
+		mStats.objectSize += allocated * type.size();
+		mAllocatedSize += allocated * type.size();
+		mNoAutoGc = noAutoGc;
+		if(allocated && mProfiling.load(std::memory_order_relaxed)) {
+			this->profileAllocation(type, type.size(), allocated);
+		}
+		return allocated;
 	}
 	
-	/**
-	 * Get a pointer to the data portion of this block.
-	 * 
-	 * @return Pointer to the data portion of this block.
-	 */
-	byte* data() const noexcept {
-		return const_cast<byte*>(reinterpret_cast<const byte*>(this) + Align);
+	const bool marking = mMarking.load(std::memory_order_relaxed);
+	if(marking) {
+		this->markIncrementally(AllocationMarkWork);
+	}
+	if(mNurserySize.load(std::memory_order_relaxed) && !marking) {
+		for(; allocated < count && (objects[allocated] = this->allocateYoung(type)); allocated++) {
+		}
 	}
 	
-	/**
-	 * Split this block in two blocks if possible. If there is enough space for another block, then this
-	 * block will be resized to the new size and a new block will be added after it; if there is not enough
-	 * space then nothing will be changed. This block must be a free block.
-	 * 
-	 * @param newSize The new size of this block, will be properly aligned.
-	 */
-	void split(std::size_t newSize) noexcept {
-		assert(this->free());
-		
-		const auto alignedSize = align(newSize);
-		if(align(mSize) > alignedSize + 2 * Align) {
-			Block *newBlock = reinterpret_cast<Block*>(reinterpret_cast<byte*>(this) + Align + alignedSize);
-			new(newBlock) Block(align(mSize) - alignedSize - Align, mPtr.get<Block>());
-			mPtr = newBlock;
-			mSize = alignedSize;
+	// Ask for a block for all remaining objects, and for fewer when there is none that large. Single objects
+	// go through the regular slow path, which sweeps, merges and grows the heap as needed.
+	const auto size = align(type.size());
+	std::size_t chunk = count - allocated;
+	while(allocated < count) {
+		chunk = std::min(chunk, count - allocated);
+		Block *blk = nullptr;
+		while(chunk > 1 && !(blk = this->findFreeBlock(chunk * (size + Align) - Align))) {
+			chunk /= 2;
+		}
+		if(blk) {
+			allocated += this->carveBatch(blk, type, count - allocated, objects + allocated);
+			chunk *= 2;
+		} else if((objects[allocated] = this->allocateOld(type, size))) {
+			allocated++;
+		} else {
+			break;
 		}
 	}
-}; // class HeapBase::Block
-
-HeapBase::HeapBase(byte *storage, std::size_t size) noexcept
-		: mFreeList(reinterpret_cast<Block*>(storage)),
-		  mHeapStart(reinterpret_cast<Block*>(storage)),
-		  mHeapEnd(reinterpret_cast<Block*>(storage + (size & ~(Align - 1)))),
-		  mRoots() {
-	static_assert(sizeof(Block) <= Align, "Block class is too large");
+	std::fill(objects + allocated, objects + count, nullptr);
+	mStats.numObjects += allocated;
+	mStats.objectSize += allocated * type.size();
+	mAllocatedSize += allocated * type.size();
+	mNoAutoGc = noAutoGc;
+	if(allocated && mProfiling.load(std::memory_order_relaxed)) {
+		this->profileAllocation(type, type.size(), allocated);
+	}
+	return allocated;
+}
 
-	assert((reinterpret_cast<std::uintptr_t>(storage) & (Align - 1)) == 0);
-	assert(size >= 2 * Align);
-	
-	new(mFreeList) Block(size - Align);
+std::size_t HeapBase::carveBatch(Block *blk, const TypeDescriptor &type, std::size_t count,
+		void **objects) noexcept {
+	const auto size = align(type.size());
+	const bool marking = mMarking.load(std::memory_order_relaxed);
+	std::size_t allocated = 0;
+	while(true) {
+		auto rest = blk->split(size);
+		this->touchBlock(blk);
+		blk->type(type);
+		if(blk >= mSweepCursor || marking) {
+			// See tryAllocate
+			this->setMark(blk);
+		}
+		objects[allocated++] = blk->data();
+		if(!rest) {
+			// The whole block is used
+			this->prevFree(blk->following(), false);
+			return allocated;
+		}
+		
+		this->setBlockStart(rest);
+		if(allocated == count || rest->size() < size) {
+			this->addFreeBlock(rest);
+			return allocated;
+		}
+		blk = rest;
+	}
 }
 
-void* HeapBase::allocate(const TypeDescriptor &type, bool isRoot) noexcept {
-	if(mFreeList == nullptr) {
-		// There are no free blocks at all, don't even try
+void* HeapBase::allocateArray(const TypeDescriptor &elementType, std::size_t length) noexcept {
+	if(elementType.size() && length > (SIZE_MAX / 2 - ArrayElementsOffset) / elementType.size()) {
 		return nullptr;
 	}
+	const auto size = ArrayElementsOffset + length * elementType.size();
 	
-	auto result = this->tryAllocate(type);
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	this->collectForAllocation(false);
+	const auto threshold = mLargeObjectThreshold.load(std::memory_order_relaxed);
+	void *result = nullptr;
+	if(threshold && size > threshold) {
+		result = this->allocateLarge(elementType, size);
+		if(!result) {
+			result = this->allocateAfterCollection([this, &elementType, size] {
+				return this->allocateLarge(elementType, size);
+			});
+		}
+	} else {
+		if(mMarking.load(std::memory_order_relaxed)) {
+			this->markIncrementally(AllocationMarkWork);
+		}
+		result = this->allocateOld(elementType, align(size));
+	}
+	if(!result) {
+		return nullptr;
+	}
+	
+	block(static_cast<byte*>(result)).array(true);
+	std::memset(result, 0, size);
+	arrayHeader(static_cast<byte*>(result)).length = length;
+	mStats.numObjects++;
+	mStats.objectSize += size;
+	mAllocatedSize += size;
+	if(mProfiling.load(std::memory_order_relaxed)) {
+		this->profileAllocation(elementType, size);
+	}
+	return result;
+}
+
+void* HeapBase::allocateOld(const TypeDescriptor &type, std::size_t size) noexcept {
+	void *result = this->tryAllocate(type, size);
 	if(!result) {
-		// No sufficiently sized block found using first-fit, merge blocks and try again
+		// No sufficiently sized block found in the free lists, merge blocks and try again
+		this->stopTlabs();
 		this->mergeBlocks();
-		result = this->tryAllocate(type);
+		this->resumeTlabs();
+		result = this->tryAllocate(type, size);
 	}
-	if(result && isRoot) {
-		this->registerRoot(result);
+	if(!result) {
+		result = this->allocateAfterCollection([this, &type, size] {
+			return this->tryAllocate(type, size);
+		});
+	}
+	if(!result && mGcPolicy.growOnFailure) {
+		// Still no space, grow the storage if possible
+		this->stopTlabs();
+		const bool grown = this->grow(size);
+		this->resumeTlabs();
+		result = grown ? this->tryAllocate(type, size) : nullptr;
 	}
 	return result;
 }
 
-void* HeapBase::tryAllocate(const TypeDescriptor &type) noexcept {
-	Block *prev = nullptr;
-	Block *cur = mFreeList;
-	// Use first-fit method to find a block
-	while(cur && cur->size() < type.size()) {
-		prev = std::exchange(cur, cur->next());
+HeapBase::Block* HeapBase::findFreeBlock(std::size_t size) noexcept {
+	const auto cls = sizeClass(size);
+	
+	Block *cur = nullptr;
+	if(cls < NumExactClasses && mFreeLists[cls]) {
+		// Exact size class: all blocks fit, just take the first one
+		cur = mFreeLists[cls];
+		
+	} else {
+		// Search larger classes, the first block of an exact class always fits, bins use first-fit
+		for(auto i = (cls < NumExactClasses ? cls + 1 : cls); i < NumSizeClasses && !cur; i++) {
+			for(auto it = mFreeLists[i]; it; it = it->next()) {
+				if(it->size() >= size) {
+					cur = it;
+					break;
+				}
+			}
+		}
 	}
 	if(cur) {
-		cur->split(type.size());
-		if(prev) {
-			prev->next(cur->next());
-		} else {
-			mFreeList = cur->next();
-		}
-		cur->type(type);
-		return cur->data();
+		this->removeFreeBlock(cur);
 	}
-	return nullptr;
+	return cur;
 }
 
+void* HeapBase::tryAllocate(const TypeDescriptor &type, std::size_t size) noexcept {
+	assert(size == align(size));
+	
+	Block *cur = this->findFreeBlock(size);
+	if(!cur && (cur = this->sweep(size))) {
+		// Lazy sweeping created a block that is large enough
+		this->removeFreeBlock(cur);
+	}
+	if(!cur) {
+		return nullptr;
+	}
+	
+	if(auto rest = cur->split(size)) {
+		this->setBlockStart(rest);
+		this->addFreeBlock(rest);
+	}
+	this->touchBlock(cur);
+	cur->type(type);
+	if(cur >= mSweepCursor || mMarking.load(std::memory_order_relaxed)) {
+		// Blocks that have not been swept yet must be allocated marked or they would be swept, and so must
+		// blocks allocated during incremental marking or they would never be marked
+		this->setMark(cur);
+	}
+	this->prevFree(cur->following(), false);
+	return cur->data();
+}
+
+// Address-ordered merge pass: coalesce all runs of adjacent free blocks and rebuild the free lists
 void HeapBase::mergeBlocks() noexcept {
-	// TODO implement merging of free blocks
+	PhaseTimer timer{*this, GcPhase::Merge};
+	this->clearFreeLists();
+	
+	for(Block *blk = mHeapStart; blk < mHeapEnd;) {
+		if(blk->used()) {
+			blk = blk->following();
+		} else {
+			auto end = blk->following();
+			while(end < mHeapEnd && end->free()) {
+				this->clearBlockStart(end);
+				end = end->following();
+			}
+			blk->next(nullptr, reinterpret_cast<byte*>(end) - reinterpret_cast<byte*>(blk) - Align);
+			this->addFreeBlock(blk);
+			blk = end;
+		}
+	}
 }
 
 void HeapBase::deallocate(byte *obj) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
 	Block &blk = block(obj);
 	assert(blk.used() /* Tried to deallocate an unused block */);
-	assert(!blk.mark() /* Tried to deallocate during garbage collection (GC builds a new free list itself) */);
+	assert((!this->marked(&blk) || &blk >= mSweepCursor || mMarking.load(std::memory_order_relaxed))
+			/* Tried to deallocate during garbage collection (GC builds a new free list itself) */);
+			
+	mStats.numObjects--;
+	mStats.objectSize -= objectSize(&blk, blk.markedType());
+	if(mProfiling.load(std::memory_order_relaxed)) {
+		this->profileFree(blk.markedType());
+	}
+	if(mMarking.load(std::memory_order_relaxed)) {
+		// The object may be on the grey worklist
+		mDeferredFrees.push_back(&blk);
+	} else if(this->isLarge(&blk)) {
+		this->freeLarge(&blk);
+	} else if(this->inNursery(obj)) {
+		// Young objects are not reused before the next minor collection, unless they are at the top
+		blk.forward(nullptr);
+		if(blk.following() == mNurseryTop) {
+			mNurseryTop = &blk;
+		}
+	} else if(!this->deferFree(&blk)) {
+		this->freeBlock(&blk);
+	}
+}
+
+std::size_t HeapBase::addRoot(void *object) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	assert(object);
+	
+	auto handle = mFreeRootHandle;
+	if(handle != NoRootHandle) {
+		mFreeRootHandle = mRootSlots[handle];
+		mRootSlots[handle] = mRoots.size();
+	} else {
+		handle = mRootSlots.size();
+		mRootSlots.push_back(mRoots.size());
+	}
+	this->insertRoot(object, handle);
+	return handle;
+}
+
+void HeapBase::removeRoot(std::size_t handle) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	assert(handle < mRootSlots.size() && mRootHandles[mRootSlots[handle]] == handle);
 	
-	blk.next(mFreeList);
-	mFreeList = &blk;
+	this->eraseRoot(mRootSlots[handle]);
+	mRootSlots[handle] = mFreeRootHandle;
+	mFreeRootHandle = handle;
+}
+
+void HeapBase::insertRoot(void *object, std::size_t handle) noexcept {
+	mRoots.push_back(static_cast<byte*>(object));
+	mRootHandles.push_back(handle);
+	if(mMarking.load(std::memory_order_relaxed)) {
+		this->shade(object);
+	}
+}
+
+void HeapBase::eraseRoot(std::size_t index) noexcept {
+	mRoots[index] = mRoots.back();
+	mRootHandles[index] = mRootHandles.back();
+	if(mRootHandles[index] != NoRootHandle) {
+		mRootSlots[mRootHandles[index]] = index;
+	}
+	mRoots.pop_back();
+	mRootHandles.pop_back();
+}
+
+void HeapBase::freeBlock(Block *blk) noexcept {
+	// Live objects that have not been swept yet are still marked
+	this->clearMark(blk);
+	
+	// Coalesce with free neighbors using the boundary tags
+	Block *start = blk;
+	Block *end = blk->following();
+	if(blk->prevFree()) {
+		start = blk->preceding();
+		this->removeFreeBlock(start);
+		this->clearBlockStart(blk);
+	}
+	if(end < mHeapEnd && end->free()) {
+		this->removeFreeBlock(end);
+		this->clearBlockStart(end);
+		end = end->following();
+	}
+	start->next(nullptr, reinterpret_cast<byte*>(end) - reinterpret_cast<byte*>(start) - Align);
+	this->addFreeBlock(start);
+	if(blk == mSweepCursor) {
+		// The sweep cursor must not point into the middle of the new free block
+		mSweepCursor = end;
+	}
 }
 
 void HeapBase::gc() noexcept {
-	for(auto root : mRoots) {
-		this->mark(root);
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	CollectingScope collecting{*this};
+	PhaseTimer timer{*this, GcPhase::Collection};
+	if(!mMarking.load(std::memory_order_relaxed)) {
+		this->beginCollection();
+		PhaseTimer markTimer{*this, GcPhase::Mark};
+		this->markRoots();
+	}
+	this->finishCollection();
+}
+
+void HeapBase::beginCollection() noexcept {
+	this->stopTlabs();
+	// Marks left over from the last cycle need to be cleared before marking again
+	this->rebuildFreeList();
+	// The objects of this cycle include the young ones
+	mAllocatedSize = 0;
+	mObjectSizeBeforeGc = this->currentObjectSize();
+	// Promote young objects first, so marking only needs to deal with the old generation
+	this->collectNursery();
+	this->ensureNursery();
+}
+
+void HeapBase::finishCollection() noexcept {
+	this->markIncrementally(SIZE_MAX);
+	mMarking.store(false, std::memory_order_relaxed);
+	if(this->clearWeakRefs()) {
+		this->notifyWeakTables();
+	}
+	for(auto blk : mDeferredFrees) {
+		if(this->isLarge(blk)) {
+			this->freeLarge(blk);
+		} else {
+			this->freeBlock(blk);
+		}
+	}
+	mDeferredFrees.clear();
+	this->sweepLargeObjects();
+	
+	mSweepCursor = mHeapStart;
+	if(mSweeper.joinable()) {
+		mSweepWork.notify_one();
+	} else if(!mLazySweep) {
+		{
+			PhaseTimer timer{*this, GcPhase::Sweep};
+			this->rebuildFreeList();
+		}
+		this->resizeStorage();
+		this->ensureNursery();
+	}
+	this->resumeTlabs();
+}
+
+void HeapBase::lazySweep(bool enable) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mLazySweep = enable;
+	if(!enable) {
+		this->rebuildFreeList();
+	}
+}
+
+void HeapBase::markBitmap(bool enable) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	if(mMarking.load(std::memory_order_relaxed)) {
+		// The marks of the incremental cycle cannot be moved
+		this->finishCollection();
 	}
 	this->rebuildFreeList();
+	mUseMarkBits = enable && mMarkBits;
+}
+
+// Marks in the bitmap are only accessed with atomic operations by parallel marking, relaxed loads and stores
+// are sufficient everywhere else
+bool HeapBase::marked(const Block *blk) const noexcept {
+	if(this->isLarge(blk)) {
+		return LargeObject::of(blk).mark.load(std::memory_order_relaxed);
+	} else if(mUseMarkBits) {
+		const auto bit = this->markBit(blk);
+		const auto word = mMarkBits[bit / MarkBitsPerWord].load(std::memory_order_relaxed);
+		return (word >> (bit % MarkBitsPerWord)) & 1;
+	}
+	return blk->mark();
+}
+
+void HeapBase::setMark(Block *blk) noexcept {
+	if(this->isLarge(blk)) {
+		LargeObject::of(blk).mark.store(true, std::memory_order_relaxed);
+	} else if(mUseMarkBits) {
+		const auto bit = this->markBit(blk);
+		auto &word = mMarkBits[bit / MarkBitsPerWord];
+		word.store(word.load(std::memory_order_relaxed) | (std::uintptr_t{1} << (bit % MarkBitsPerWord)),
+				std::memory_order_relaxed);
+	} else {
+		blk->mark(true);
+	}
+}
+
+bool HeapBase::tryMark(Block *blk) noexcept {
+	assert(mUseMarkBits);
+	if(this->isLarge(blk)) {
+		return !LargeObject::of(blk).mark.exchange(true, std::memory_order_relaxed);
+	}
+	const auto bit = this->markBit(blk);
+	const auto mask = std::uintptr_t{1} << (bit % MarkBitsPerWord);
+	return (mMarkBits[bit / MarkBitsPerWord].fetch_or(mask, std::memory_order_relaxed) & mask) == 0;
+}
+
+void HeapBase::clearMark(Block *blk) noexcept {
+	if(this->isLarge(blk)) {
+		LargeObject::of(blk).mark.store(false, std::memory_order_relaxed);
+	} else if(mUseMarkBits) {
+		const auto bit = this->markBit(blk);
+		auto &word = mMarkBits[bit / MarkBitsPerWord];
+		word.store(word.load(std::memory_order_relaxed) & ~(std::uintptr_t{1} << (bit % MarkBitsPerWord)),
+				std::memory_order_relaxed);
+	} else {
+		blk->mark(false);
+	}
+}
+
+void HeapBase::clearMarkBitmap() noexcept {
+	// Marks beyond the committed storage are cleared when the storage grows
+	const auto words = std::min(mMarkWords, markBitmapWords(this->storageSize()));
+	for(std::size_t i = 0; i < words; i++) {
+		mMarkBits[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+void HeapBase::setBlockStart(const Block *blk) noexcept {
+	if(mUseCards) {
+		const auto bit = this->markBit(blk);
+		mBlockStarts[bit / MarkBitsPerWord].fetch_or(std::uintptr_t{1} << (bit % MarkBitsPerWord),
+				std::memory_order_relaxed);
+	}
+}
+
+void HeapBase::clearBlockStart(const Block *blk) noexcept {
+	if(mUseCards) {
+		const auto bit = this->markBit(blk);
+		mBlockStarts[bit / MarkBitsPerWord].fetch_and(~(std::uintptr_t{1} << (bit % MarkBitsPerWord)),
+				std::memory_order_relaxed);
+	}
 }
 
+HeapBase::Block* HeapBase::nextMarked(const Block *blk) const noexcept {
+	assert(mUseMarkBits);
+	
+	const auto bit = this->markBit(blk);
+	const auto words = std::min(mMarkWords, markBitmapWords(this->storageSize()));
+	std::size_t index = bit / MarkBitsPerWord;
+	// Ignore marks before the block in the first word, then scan whole words
+	auto word = mMarkBits[index].load(std::memory_order_relaxed);
+	word &= ~std::uintptr_t{0} << (bit % MarkBitsPerWord);
+	while(word == 0) {
+		if(++index >= words) {
+			return mHeapEnd;
+		}
+		word = mMarkBits[index].load(std::memory_order_relaxed);
+	}
+	auto result = reinterpret_cast<Block*>(reinterpret_cast<byte*>(mHeapStart) +
+			(index * MarkBitsPerWord + countTrailingZeros(word)) * Align);
+	return std::min(result, mHeapEnd);
+}
+
+void HeapBase::markRoots() noexcept {
+	if(mUseMarkBits && mMarkThreads > 1 && this->markParallel()) {
+		return;
+	}
+	this->forEachRoot([this](byte *root) {
+		// Roots may be reachable from other roots (or registered more than once)
+		if(!this->marked(&block(root))) {
+			this->markWithStack(root);
+		}
+	});
+}
 // Mark the object graph for the specified heap root object using the Deutsch-Schorr-Waite marking algorithm
 void HeapBase::mark(byte *root) noexcept {
 	assert(root);
-	assert(!block(root).mark());
+	assert(!this->marked(&block(root)));
 	
+	if(leaf(&block(root), block(root).type())) {
+		// Nothing to trace
+		this->setMark(&block(root));
+		return;
+	}
 	byte *cur = root;
 	byte *prev = nullptr;
 	while(true) {
 		auto &blk = block(cur);
-		if(!blk.mark()) {
+		if(!this->marked(&blk)) {
 			// Mark the object and begin iteration
-			blk.ptr() = blk.type().begin();
-			blk.ptr().mark(true);
+			blk.scanPosition(blk.type().begin());
+			this->setMark(&blk);
 		} else {
-			blk.ptr() = blk.ptr().get<const std::ptrdiff_t>() + 1;
+			blk.scanPosition(blk.scanPosition() + 1);
 		}
 		
-		auto offset = *blk.ptr().get<const std::ptrdiff_t>();
+		auto offset = *blk.scanPosition();
+		if(offset < 0 && blk.array()) {
+			// Continue with the next element of an array, its header records which element is traced
+			auto &header = arrayHeader(cur);
+			const auto &type = *reinterpret_cast<const TypeDescriptor*>(
+					reinterpret_cast<const byte*>(blk.scanPosition()) + offset);
+			header.scanOffset += type.size();
+			if(header.scanOffset < header.length * type.size()) {
+				blk.scanPosition(type.begin());
+				offset = *type.begin();
+			} else {
+				header.scanOffset = 0;
+			}
+		}
 		if(offset >= 0) {
 			// Advance
-			auto &field = *reinterpret_cast<byte**>(cur + offset);
-			if(field && !block(field).mark()) {
+			auto &field = *reinterpret_cast<byte**>(cur + fieldBase(blk) + offset);
+			if(!field || this->marked(&block(field))) {
+				// Nothing to do
+			} else if(leaf(&block(field), block(field).type())) {
+				// Leaf objects are only marked, the pointer reversal would immediately retreat from them
+				this->setMark(&block(field));
+			} else {
 				auto tmp = std::exchange(field, prev);
 				prev = std::exchange(cur, tmp);
 			}
 		} else {
 			// Retreat
-			blk.ptr() = reinterpret_cast<const TypeDescriptor*>(
-					reinterpret_cast<const byte*>(blk.ptr().get<const std::ptrdiff_t>()) + offset);
+			blk.endScan(*reinterpret_cast<const TypeDescriptor*>(
+					reinterpret_cast<const byte*>(blk.scanPosition()) + offset));
 			if(!prev) {
 				return;
 			}
 			auto tmp = std::exchange(cur, prev);
-			offset = *block(cur).ptr().get<std::ptrdiff_t>();
-			prev = std::exchange(*reinterpret_cast<byte**>(cur + offset), tmp);
+			offset = *block(cur).scanPosition();
+			prev = std::exchange(*reinterpret_cast<byte**>(cur + fieldBase(block(cur)) + offset), tmp);
 		}
 	} // while(true)
 }
 
-// Rebuild the free list while destroying garbage objects
-void HeapBase::rebuildFreeList() noexcept {
-	Block *freeList = nullptr;
-	
-	for(Block *blk = mHeapStart; blk < mHeapEnd;) {
-		if(blk->mark()) {
-			blk->ptr().mark(false);
-			blk = blk->following();
-			
-		} else {
-			auto free = blk;
-			// Extend the free block, destroying garbage objects as necessary
-			do {
-				if(free->used()) {
-					free->type().destroy(free->data());
-				}
-				free = free->following();
-			} while(free < mHeapEnd && !free->mark());
-
-			static_assert(std::is_trivially_destructible<Block>::value, "Block must be trivially destructible.");
-			blk->next(freeList, reinterpret_cast<byte*>(free) - reinterpret_cast<byte*>(blk) - Align);
-			freeList = blk;
-			blk = free;
+// Sweep the heap from the sweep cursor, building free blocks while destroying garbage objects
+HeapBase::Block* HeapBase::sweep(std::size_t size, const Block *stop) noexcept {
+	// Destructors of garbage objects may allocate
+	CollectingScope collecting{*this};
+	const bool sweeping = mSweepCursor < mHeapEnd;
+	Block *found = nullptr;
+	while(mSweepCursor < mHeapEnd && !found && (!stop || mSweepCursor < stop)) {
+		Block *blk = mSweepCursor;
+		if(this->marked(blk)) {
+			if(!mUseMarkBits) {
+				blk->mark(false);
+			}
+			mSweepCursor = blk->following();
+			continue;
+		}
+		
+		if(blk->prevFree()) {
+			// Extend a free block left before the sweep cursor by deallocate
+			blk = blk->preceding();
+			this->removeFreeBlock(blk);
 		}
+		auto free = mSweepCursor;
+		// With the mark bitmap, the end of the garbage run is known in advance
+		const auto limit = mUseMarkBits ? this->nextMarked(free) : mHeapEnd;
+		// Extend the free block, destroying garbage objects as necessary
+		do {
+			if(free->used()) {
+				destroy(free);
+			} else {
+				this->removeFreeBlock(free);
+			}
+			if(free != blk) {
+				this->clearBlockStart(free);
+			}
+			free = free->following();
+		} while(free < limit && !this->marked(free));
+		
+		static_assert(std::is_trivially_destructible<Block>::value, "Block must be trivially destructible.");
+		blk->next(nullptr, reinterpret_cast<byte*>(free) - reinterpret_cast<byte*>(blk) - Align);
+		this->addFreeBlock(blk);
+		mSweepCursor = free;
+		if(blk->size() >= size) {
+			found = blk;
+		}
+	}
+	
+	if(mSweepCursor == mHeapEnd && mUseMarkBits) {
+		// Sweeping is complete, clear all marks at once
+		this->clearMarkBitmap();
+	}
+	if(mSweepCursor == mHeapEnd && sweeping) {
+		this->recordLiveObjects();
+		this->releaseFreeMemory();
 	}
-	mFreeList = freeList;
+	return found;
 }
 
 void HeapBase::dump(std::ostream &os) {
 	RestoreStream osRestore{os};
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	// Allocation buffers must not change the heap while it is written
+	this->stopTlabs();
 	
 	const HeapStats stats = this->collectHeapStats(true);
 	
@@ -350,11 +926,13 @@ void HeapBase::dump(std::ostream &os) {
 	os << '\n';
 	os << "= Free Blocks =\nAddress    Size(net)\n";
 	
-	// Print free blocks: just use the free list
+	// Print free blocks: just use the free lists
 	os.fill('0');
-	for(auto blk = mFreeList; blk; blk = blk->next()) {
-		os << std::hex << std::setw(sizeof(void*)) << blk
-				<< ' ' << std::dec << blk->size() << '\n';
+	for(auto list : mFreeLists) {
+		for(auto blk = list; blk; blk = blk->next()) {
+			os << std::hex << std::setw(sizeof(void*)) << blk
+					<< ' ' << std::dec << blk->size() << '\n';
+		}
 	}
 	os << std::setfill(' ') << '\n';
 	
@@ -366,66 +944,139 @@ void HeapBase::dump(std::ostream &os) {
 		os << "  none\n";
 	}
 	os << '\n';
+	this->resumeTlabs();
 }
 
 void HeapBase::dumpLiveObjects(std::ostream &os) {
 	constexpr std::size_t numDataBytes = 4;
 	static const std::string indent(4, ' ');
 	
-	for(auto root : mRoots) {
-		this->mark(root);
-	}
+	const auto dumpObject = [&](const Block *blk) {
+		const auto &type = blk->type();
+		const auto size = objectSize(blk, type);
+		os << static_cast<void*>(blk->data()) << ' ' << (type.name() ? type.name() : "<unnamed>");
+		if(blk->array()) {
+			os << '[' << std::dec << arrayHeader(blk->data()).length << std::hex << ']';
+		}
+		os << "\n  Data: ";
+		std::copy_n(blk->data(), std::min(size, numDataBytes), std::ostream_iterator<FixedWidthSize<2>>(os, " "));
+		if(size > numDataBytes) {
+			os << "...";
+		}
+		os << "\n  Pointers: ";
+		if(!leaf(blk, type)) {
+			os << "\n";
+			forEachField(const_cast<Block*>(blk), type, [&os](byte *field) {
+				os << indent << static_cast<void*>(field) << '\n';
+			});
+		} else {
+			os << "none\n";
+		}
+	};
+	
+	this->markRoots();
 	os << std::hex << std::setfill('0');
-	for(auto blk = mHeapStart; blk < mHeapEnd; blk = blk->following()) {
-		if(blk->mark()) {
-			blk->ptr().mark(false);
-			os << static_cast<void*>(blk->data()) << ' ' << blk->type().name() << '\n';
-			os << "  Data: ";
-			std::copy_n(blk->data(), std::min(blk->type().size(), numDataBytes),
-					std::ostream_iterator<FixedWidthSize<2>>(os, " "));
-			if(blk->type().size() > numDataBytes) {
-				os << "...";
+	// The nursery directly follows the old generation, so this also walks young objects
+	for(auto blk = mHeapStart; blk < mNurseryTop; blk = blk->following()) {
+		if(this->marked(blk)) {
+			if(!mUseMarkBits) {
+				blk->mark(false);
 			}
-			os << "\n  Pointers: ";
-			if(blk->type().offsets() > 0) {
-				os << "\n";
-				for(auto offset : blk->type()) {
-					os << indent << *reinterpret_cast<void**>(blk->data() + offset) << '\n';
-				}
-			} else {
-				os << "none\n";
-			}
-		} // if(blk->mark())
+			dumpObject(blk);
+		}
+	}
+	for(auto large = mLargeObjects; large; large = large->next) {
+		if(large->mark.exchange(false, std::memory_order_relaxed)) {
+			dumpObject(large->block());
+		}
+	}
+	if(mUseMarkBits) {
+		this->clearMarkBitmap();
 	}
 	os << std::dec << std::setfill(' ');
 }
 
+HeapBase::HeapStats HeapBase::stats() noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	HeapStats result = mStats;
+	this->countTlabObjects(result);
+	
+	result.heapSize = this->storageSize() + mLargeObjectsSize;
+	// Free blocks and the unused space in the nursery
+	result.freeSize = result.freeBlockSize + result.numFreeBlocks * Align
+			+ (reinterpret_cast<byte*>(mStorageEnd) - reinterpret_cast<byte*>(mNurseryTop));
+	result.usedSize = result.heapSize - result.freeSize;
+	return result;
+}
+
+void HeapBase::recordLiveObjects() noexcept {
+	HeapStats counts = mStats;
+	this->countTlabObjects(counts);
+	mStats.numLiveObjects = counts.numObjects;
+	mStats.liveObjectSize = counts.objectSize;
+	this->tuneAllocationBudget();
+	if(mProfiling.load(std::memory_order_relaxed)) {
+		this->recordSurvivors();
+	}
+}
+
 HeapBase::HeapStats HeapBase::collectHeapStats(bool countLiveObjects) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	if(mMarking.load(std::memory_order_relaxed)) {
+		// Counting objects uses the marks, so an incremental cycle has to be completed first
+		this->finishCollection();
+	}
+	// The unused space of allocation buffers is returned to the free lists, so it counts as free
+	this->stopTlabs();
+	// Marks from an unfinished lazy sweep would get in the way
+	this->rebuildFreeList();
+	
 	HeapStats result{};
-	result.heapSize = reinterpret_cast<byte*>(mHeapEnd) - reinterpret_cast<byte*>(mHeapStart);
+	result.heapSize = reinterpret_cast<byte*>(mStorageEnd) - reinterpret_cast<byte*>(mHeapStart);
+	// Unused space in the nursery
+	result.freeSize = reinterpret_cast<byte*>(mStorageEnd) - reinterpret_cast<byte*>(mNurseryTop);
 	
 	if(countLiveObjects) {
-		for(auto root : mRoots) {
-			this->mark(root);
-		}
+		this->markRoots();
 	}
-	for(auto blk = mHeapStart; blk < mHeapEnd; blk = blk->following()) {
+	for(auto blk = mHeapStart; blk < mNurseryTop; blk = blk->following()) {
 		if(blk->free()) {
-			result.numFreeBlocks++;
-			result.freeBlockSize += blk->size();
+			// Deallocated young objects are not available before the next minor collection
+			if(blk < mHeapEnd) {
+				result.numFreeBlocks++;
+				result.freeBlockSize += blk->size();
+			}
 			result.freeSize += Align + align(blk->size());
 		} else {
-			if(blk->mark()) {
-				blk->ptr().mark(false);
+			if(this->marked(blk)) {
+				if(!mUseMarkBits) {
+					blk->mark(false);
+				}
 				result.numLiveObjects++;
-				result.liveObjectSize += blk->type().size();
+				result.liveObjectSize += objectSize(blk, blk->type());
 			}
 			result.numObjects++;
-			result.objectSize += blk->type().size();
+			result.objectSize += objectSize(blk, blk->type());
 			result.usedSize += Align + align(blk->size());
 		}
 	}
+	// Large objects use all of their mappings
+	for(auto large = mLargeObjects; large; large = large->next) {
+		const auto size = objectSize(large->block(), large->block()->type());
+		if(large->mark.exchange(false, std::memory_order_relaxed)) {
+			result.numLiveObjects++;
+			result.liveObjectSize += size;
+		}
+		result.numObjects++;
+		result.objectSize += size;
+		result.usedSize += large->mappedSize;
+		result.heapSize += large->mappedSize;
+	}
 	assert(result.freeSize + result.usedSize == result.heapSize);
+	if(mUseMarkBits) {
+		this->clearMarkBitmap();
+	}
+	this->resumeTlabs();
 	
 	return result;
 }
@@ -0,0 +1,860 @@
+/**
+ * @file    HeapBlock.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the {@link HeapBase::Block} and {@link HeapBase::LargeObject} classes, which are private
+ *          to the heap implementation.
+ */
+
+#ifndef HEAPBLOCK_HPP_
+#define HEAPBLOCK_HPP_
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "Heap.hpp"
+#include "TaggedPointer.hpp"
+#include "TypeDescriptor.hpp"
+
+namespace ssw {
+
+#if SSW_COMPACT_HEADERS
+/**
+ * Represents a block of memory in the heap, with a compact header of a single word. The lowest two bits of
+ * the header are the mark and the free bit, like in a {@link TaggedPointer}, followed by the flags that
+ * record whether the physically preceding block is free, and whether the object in a used block is pinned
+ * or a managed array.
+ * 
+ * In a used block, the rest of the header holds the index of the type descriptor (see
+ * {@link TypeDescriptor::index}), the field that is being traced while marking, and the size of the block
+ * in units of {@link Align}, so used blocks are limited to 32 GiB. In a free block, the rest of the header
+ * holds a pointer to the next free block, shifted into place.
+ * 
+ * Free blocks use their data portion for the size and for boundary tags: the first word holds a pointer
+ * to the previous block in the free list, the second word holds the size of the block, and the last word
+ * also holds the size (the footer), which is the same word for the smallest blocks.
+ */
+class alignas(HeapBase::Align) HeapBase::Block
+{
+	static constexpr std::uintptr_t sMaskMark{1};
+	static constexpr std::uintptr_t sMaskFree{2};
+	static constexpr std::uintptr_t sMaskPrevFree{4};
+	static constexpr std::uintptr_t sMaskPinned{8};
+	static constexpr std::uintptr_t sMaskArray{16};
+	static constexpr std::uintptr_t sMaskFlags{sMaskPrevFree | sMaskPinned | sMaskArray};
+	static constexpr std::uintptr_t sMaskTags{sMaskMark | sMaskFree | sMaskFlags};
+	static constexpr unsigned sShiftNext{2};
+	static constexpr unsigned sShiftType{5};
+	static constexpr unsigned sShiftCursor{21};
+	static constexpr unsigned sShiftSize{32};
+	static constexpr std::uintptr_t sMaskType{std::uintptr_t{TypeDescriptor::MaxIndex} << sShiftType};
+	static constexpr std::uintptr_t sMaskCursor{std::uintptr_t{TypeDescriptor::MaxOffsets} << sShiftCursor};
+	
+	static_assert(sizeof(std::uintptr_t) == 8 && Align == 8, "Compact block headers need 64-bit pointers.");
+	static_assert((sMaskType & sMaskCursor) == 0 && (sMaskCursor >> sShiftSize) == 0,
+			"Fields of the block header overlap.");
+			
+	std::uintptr_t mHeader;
+	
+	/**
+	 * Get a reference to the footer of this block, which is only valid for free blocks.
+	 */
+	std::size_t& footer() const noexcept {
+		return *reinterpret_cast<std::size_t*>(this->data() + align(this->size()) - sizeof(std::size_t));
+	}
+	
+	/**
+	 * Get a reference to the size of this block, which is only valid for free blocks.
+	 */
+	std::size_t& freeSize() const noexcept {
+		return reinterpret_cast<std::size_t*>(this->data())[1];
+	}
+	
+	/**
+	 * Mark this block as free, moving the size from the header to the data portion if it is used. The mark
+	 * and the flags are kept, the rest of the header is cleared.
+	 */
+	void makeFree() noexcept {
+		if(this->used()) {
+			this->freeSize() = this->size();
+		}
+		mHeader = (mHeader & (sMaskMark | sMaskFlags)) | sMaskFree;
+	}
+	
+public:
+	
+	/**
+	 * Initialize a new, free block with the specified size.
+	 * 
+	 * @param size The usable size of the block (will be properly aligned).
+	 * @param next (optional) The next block in the free list.
+	 */
+	explicit Block(std::size_t size, Block *next = nullptr) noexcept 
+			: mHeader((reinterpret_cast<std::uintptr_t>(next) << sShiftNext) | sMaskFree) {
+		assert(size >= MinBlockSize);
+		this->freeSize() = size;
+	}
+	
+	/**
+	 * Get the data size of this block.
+	 * 
+	 * @return The usable size of this block, not including the block descriptor.
+	 */
+	std::size_t size() const noexcept {
+		return this->free() ? this->freeSize() : (mHeader >> sShiftSize) * Align;
+	}
+	
+	/**
+	 * Set the data size of this block, keeping the boundary tag, the pin and the array flag. This does not
+	 * create a block for the remaining space, which is the responsibility of the caller.
+	 * 
+	 * @param size The usable size of this block, must be aligned.
+	 */
+	void size(std::size_t size) noexcept {
+		assert(size >= MinBlockSize && size == align(size));
+		if(this->free()) {
+			this->freeSize() = size;
+		} else {
+			assert(size / Align <= (~std::uintptr_t{0} >> sShiftSize));
+			mHeader = (mHeader & ~(~std::uintptr_t{0} << sShiftSize))
+					| (std::uintptr_t{size / Align} << sShiftSize);
+		}
+	}
+	
+	/**
+	 * Set whether the physically preceding block in the heap is free.
+	 * 
+	 * @param prevFree `true` if the preceding block is free, `false` otherwise.
+	 */
+	void prevFree(bool prevFree) noexcept {
+		if(prevFree) {
+			mHeader |= sMaskPrevFree;
+		} else {
+			mHeader &= ~sMaskPrevFree;
+		}
+	}
+	
+	/**
+	 * Get whether the physically preceding block in the heap is free.
+	 * 
+	 * @return `true` if the preceding block is free, in which case {@link preceding} may be used.
+	 */
+	bool prevFree() const noexcept {
+		return mHeader & sMaskPrevFree;
+	}
+	
+	/**
+	 * Set whether the object in this block is pinned, i.e. must not be moved by compaction. The pin is
+	 * cleared when the block becomes free.
+	 * 
+	 * @param pinned `true` to pin the object, `false` to unpin it.
+	 */
+	void pinned(bool pinned) noexcept {
+		if(pinned) {
+			mHeader |= sMaskPinned;
+		} else {
+			mHeader &= ~sMaskPinned;
+		}
+	}
+	
+	/**
+	 * Get whether the object in this block is pinned.
+	 * 
+	 * @return `true` if the object must not be moved, `false` otherwise.
+	 */
+	bool pinned() const noexcept {
+		return mHeader & sMaskPinned;
+	}
+	
+	/**
+	 * Mark the object in this used block as a managed array, whose type is the type of its elements. The flag
+	 * is cleared when the block becomes free.
+	 */
+	void array(bool array) noexcept {
+		if(array) {
+			mHeader |= sMaskArray;
+		} else {
+			mHeader &= ~sMaskArray;
+		}
+	}
+	
+	/**
+	 * Get whether the object in this block is a managed array.
+	 */
+	bool array() const noexcept {
+		return mHeader & sMaskArray;
+	}
+	
+	/**
+	 * Get a pointer to the block preceding this block in the heap. The preceding block must be free.
+	 * 
+	 * @return Pointer to the physically previous block in the heap.
+	 */
+	Block* preceding() const noexcept {
+		assert(this->prevFree());
+		const auto prevSize = reinterpret_cast<const std::size_t*>(this)[-1];
+		return reinterpret_cast<Block*>(
+				const_cast<byte*>(reinterpret_cast<const byte*>(this)) - align(prevSize) - Align);
+	}
+	
+	/**
+	 * Set the previous block in the free list and update the footer. This block must be a free block.
+	 * 
+	 * @param prev The previous block in the free list, or `nullptr`.
+	 */
+	void prev(Block *prev) noexcept {
+		assert(this->free() && prev != this);
+		*reinterpret_cast<Block**>(this->data()) = prev;
+		this->footer() = this->size();
+	}
+	
+	/**
+	 * Get the previous block in the free list. This block must represent a free block.
+	 * 
+	 * @return Pointer to the previous block in the free list.
+	 */
+	Block* prev() const noexcept {
+		assert(this->free() && !this->mark());
+		return *reinterpret_cast<Block* const*>(this->data());
+	}
+	
+	/**
+	 * Mark this block as free and set the next block in the free list.
+	 * 
+	 * @param next The next block in the free list, or `nullptr`.
+	 */
+	void next(Block *next) noexcept {
+		assert(next != this);
+		this->makeFree();
+		mHeader |= reinterpret_cast<std::uintptr_t>(next) << sShiftNext;
+	}
+	
+	/**
+	 * Mark this block as free and set its successor and size.
+	 * 
+	 * @param next The next block in the free list, or `nullptr`.
+	 * @param size The usable size of this block, not including the block descriptor.
+	 */
+	void next(Block *next, std::size_t size) noexcept {
+		this->next(next);
+		assert(size >= MinBlockSize);
+		this->freeSize() = size;
+		mHeader &= ~(sMaskPinned | sMaskArray);
+	}
+	
+	/**
+	 * Get the next block in the free list. This block must represent a free block.
+	 * 
+	 * @return Pointer to the next block in the free list.
+	 */
+	Block* next() const noexcept {
+		assert(this->free() && !this->mark());
+		return reinterpret_cast<Block*>((mHeader & ~sMaskTags) >> sShiftNext);
+	}
+	
+	/**
+	 * Get a pointer to the block following this block in the heap.
+	 * 
+	 * @return Pointer to the physically next block in the heap.
+	 */
+	Block* following() const noexcept {
+		return reinterpret_cast<Block*>(this->data() + align(this->size()));
+	}
+	
+	/**
+	 * Mark this block as used and set the data type.
+	 * 
+	 * @param type The type descriptor for the data in this block.
+	 */
+	void type(const TypeDescriptor &type) noexcept {
+		const std::uintptr_t size = this->size() / Align;
+		assert(size <= (~std::uintptr_t{0} >> sShiftSize));
+		mHeader = (mHeader & (sMaskMark | sMaskFlags)) | (std::uintptr_t{type.index()} << sShiftType)
+				| (size << sShiftSize);
+	}
+	
+	/**
+	 * Get the data type in this block. This block must represent a used block.
+	 * 
+	 * @return Reference to the type descriptor for the data in this block.
+	 */
+	const TypeDescriptor& type() const noexcept {
+		assert(this->used() && !this->mark());
+		return this->markedType();
+	}
+	
+	/**
+	 * Record that the object in this block, which must be in the nursery, was moved to another block. In the
+	 * nursery, free blocks are objects that were moved or deallocated.
+	 * 
+	 * @param to The block the object was moved to, or `nullptr` if the object was deallocated.
+	 */
+	void forward(Block *to) noexcept {
+		this->makeFree();
+		mHeader |= reinterpret_cast<std::uintptr_t>(to) << sShiftNext;
+	}
+	
+	/**
+	 * Get the block the object in this block was moved to. This block must be in the nursery and free.
+	 * 
+	 * @return Pointer to the block holding the moved object, or `nullptr` if the object was deallocated.
+	 */
+	Block* forwardee() const noexcept {
+		assert(this->free());
+		return reinterpret_cast<Block*>((mHeader & ~sMaskTags) >> sShiftNext);
+	}
+	
+	/**
+	 * Get whether this block is free.
+	 * 
+	 * @return `true` if this block is part of the free list and does not hold an object.
+	 */
+	bool free() const noexcept {
+		return mHeader & sMaskFree;
+	}
+	
+	/**
+	 * Get whether this block is used.
+	 * 
+	 * @return `true` if this block contains an object and is not part of the free list.
+	 */
+	bool used() const noexcept {
+		return !this->free();
+	}
+	
+	/**
+	 * Get the GC mark for this block.
+	 * 
+	 * @return `true` if the mark is set, `false` otherwise.
+	 */
+	bool mark() const noexcept {
+		return mHeader & sMaskMark;
+	}
+	
+	/**
+	 * Set the GC mark for this block, if marks are kept in block headers.
+	 * 
+	 * @param mark `true` to set the mark, `false` to clear it.
+	 */
+	void mark(bool mark) noexcept {
+		if(mark) {
+			mHeader |= sMaskMark;
+		} else {
+			mHeader &= ~sMaskMark;
+		}
+	}
+	
+	/**
+	 * Get the data type in this block regardless of its mark. This block must represent a used block.
+	 * 
+	 * @return Reference to the type descriptor for the data in this block.
+	 */
+	const TypeDescriptor& markedType() const noexcept {
+		assert(this->used());
+		return TypeDescriptor::byIndex(static_cast<std::uint32_t>((mHeader & sMaskType) >> sShiftType));
+	}
+	
+	/**
+	 * Set the pointer offset of the field that is being traced by Deutsch-Schorr-Waite marking. The block
+	 * keeps its type while it is traced, the header records the index of the offset.
+	 * 
+	 * @param position Pointer into the offset list of the type of this block, which may be the end sentinel.
+	 */
+	void scanPosition(const std::ptrdiff_t *position) noexcept {
+		const std::uintptr_t index = position - this->markedType().begin();
+		assert(index <= TypeDescriptor::MaxOffsets);
+		mHeader = (mHeader & ~sMaskCursor) | (index << sShiftCursor);
+	}
+	
+	/**
+	 * Get the pointer offset of the field that is being traced, see {@link scanPosition}.
+	 */
+	const std::ptrdiff_t* scanPosition() const noexcept {
+		return this->markedType().begin() + ((mHeader & sMaskCursor) >> sShiftCursor);
+	}
+	
+	/**
+	 * Finish tracing the fields of this block.
+	 * 
+	 * @param type The type descriptor for the data in this block.
+	 */
+	void endScan(const TypeDescriptor &type) noexcept {
+		assert(&type == &this->markedType());
+		static_cast<void>(type);
+		mHeader &= ~sMaskCursor;
+	}
+	
+	/**
+	 * Get a pointer to the data portion of this block.
+	 * 
+	 * @return Pointer to the data portion of this block.
+	 */
+	byte* data() const noexcept {
+		return const_cast<byte*>(reinterpret_cast<const byte*>(this) + Align);
+	}
+	
+	/**
+	 * Split this block in two blocks if possible. If there is enough space for another block, then this
+	 * block will be resized to the new size and a new free block will be created after it; if there is not
+	 * enough space then nothing will be changed. This block must be a free block.
+	 * 
+	 * The new block is not added to any free list, that is the responsibility of the caller.
+	 * 
+	 * @param newSize The new size of this block, will be properly aligned.
+	 * @return Pointer to the newly created block, or `nullptr` if the block was not split.
+	 */
+	Block* split(std::size_t newSize) noexcept {
+		assert(this->free());
+		
+		const auto alignedSize = align(newSize);
+		const auto oldSize = align(this->size());
+		if(oldSize >= alignedSize + Align + MinBlockSize) {
+			Block *newBlock = reinterpret_cast<Block*>(reinterpret_cast<byte*>(this) + Align + alignedSize);
+			new(newBlock) Block(oldSize - alignedSize - Align);
+			this->freeSize() = alignedSize;
+			mHeader &= ~(sMaskPinned | sMaskArray);
+			return newBlock;
+		}
+		return nullptr;
+	}
+}; // class HeapBase::Block
+#else
+/**
+ * Represents a block of memory in the heap. This class holds the block size and either a pointer to the
+ * type of the stored object (in case the block is used) or a pointer to the next free block.
+ * 
+ * Free blocks additionally use their data portion for boundary tags: the first word holds a pointer to the
+ * previous block in the free list, the last word holds the size of the block (the footer). The lowest bit
+ * of the size records whether the physically preceding block is free, so its footer can be used to find it.
+ * The next bits record whether the object in a used block is pinned, and whether it is a managed array.
+ */
+class alignas(HeapBase::Align) HeapBase::Block
+{
+	static constexpr std::size_t sMaskPrevFree{1};
+	static constexpr std::size_t sMaskPinned{2};
+	static constexpr std::size_t sMaskArray{4};
+	static constexpr std::size_t sMaskFlags{sMaskPrevFree | sMaskPinned | sMaskArray};
+	
+	std::size_t mSize;
+	TaggedPointer mPtr;
+	
+	/**
+	 * Get a reference to the footer of this block, which is only valid for free blocks.
+	 */
+	std::size_t& footer() const noexcept {
+		return *reinterpret_cast<std::size_t*>(this->data() + align(this->size()) - sizeof(std::size_t));
+	}
+	
+public:
+	
+	/**
+	 * Initialize a new, free block with the specified size.
+	 * 
+	 * @param size The usable size of the block (will be properly aligned).
+	 * @param next (optional) The next block in the free list.
+	 */
+	explicit Block(std::size_t size, Block *next = nullptr) noexcept 
+			: mSize(size), mPtr(next) {
+		assert(size >= MinBlockSize);
+		mPtr.free(true);
+	}
+	
+	/**
+	 * Get the data size of this block.
+	 * 
+	 * @return The usable size of this block, not including the block descriptor.
+	 */
+	std::size_t size() const noexcept {
+		return mSize & ~sMaskFlags;
+	}
+	
+	/**
+	 * Set the data size of this block, keeping the boundary tag, the pin and the array flag. This does not
+	 * create a block for the remaining space, which is the responsibility of the caller.
+	 * 
+	 * @param size The usable size of this block, must be aligned.
+	 */
+	void size(std::size_t size) noexcept {
+		assert(size >= MinBlockSize && size == align(size));
+		mSize = size | (mSize & sMaskFlags);
+	}
+	
+	/**
+	 * Set whether the physically preceding block in the heap is free.
+	 * 
+	 * @param prevFree `true` if the preceding block is free, `false` otherwise.
+	 */
+	void prevFree(bool prevFree) noexcept {
+		if(prevFree) {
+			mSize |= sMaskPrevFree;
+		} else {
+			mSize &= ~sMaskPrevFree;
+		}
+	}
+	
+	/**
+	 * Get whether the physically preceding block in the heap is free.
+	 * 
+	 * @return `true` if the preceding block is free, in which case {@link preceding} may be used.
+	 */
+	bool prevFree() const noexcept {
+		return mSize & sMaskPrevFree;
+	}
+	
+	/**
+	 * Set whether the object in this block is pinned, i.e. must not be moved by compaction. The pin is
+	 * cleared when the block becomes free.
+	 * 
+	 * @param pinned `true` to pin the object, `false` to unpin it.
+	 */
+	void pinned(bool pinned) noexcept {
+		if(pinned) {
+			mSize |= sMaskPinned;
+		} else {
+			mSize &= ~sMaskPinned;
+		}
+	}
+	
+	/**
+	 * Get whether the object in this block is pinned.
+	 * 
+	 * @return `true` if the object must not be moved, `false` otherwise.
+	 */
+	bool pinned() const noexcept {
+		return mSize & sMaskPinned;
+	}
+	
+	/**
+	 * Mark the object in this used block as a managed array, whose type is the type of its elements. The flag
+	 * is cleared when the block becomes free.
+	 */
+	void array(bool array) noexcept {
+		if(array) {
+			mSize |= sMaskArray;
+		} else {
+			mSize &= ~sMaskArray;
+		}
+	}
+	
+	/**
+	 * Get whether the object in this block is a managed array.
+	 */
+	bool array() const noexcept {
+		return mSize & sMaskArray;
+	}
+	
+	/**
+	 * Get a pointer to the block preceding this block in the heap. The preceding block must be free.
+	 * 
+	 * @return Pointer to the physically previous block in the heap.
+	 */
+	Block* preceding() const noexcept {
+		assert(this->prevFree());
+		const auto prevSize = reinterpret_cast<const std::size_t*>(this)[-1];
+		return reinterpret_cast<Block*>(
+				const_cast<byte*>(reinterpret_cast<const byte*>(this)) - align(prevSize) - Align);
+	}
+	
+	/**
+	 * Set the previous block in the free list and update the footer. This block must be a free block.
+	 * 
+	 * @param prev The previous block in the free list, or `nullptr`.
+	 */
+	void prev(Block *prev) noexcept {
+		assert(this->free() && prev != this);
+		*reinterpret_cast<Block**>(this->data()) = prev;
+		this->footer() = this->size();
+	}
+	
+	/**
+	 * Get the previous block in the free list. This block must represent a free block.
+	 * 
+	 * @return Pointer to the previous block in the free list.
+	 */
+	Block* prev() const noexcept {
+		assert(this->free() && !this->mark());
+		return *reinterpret_cast<Block* const*>(this->data());
+	}
+	
+	/**
+	 * Mark this block as free and set the next block in the free list.
+	 * 
+	 * @param next The next block in the free list, or `nullptr`.
+	 */
+	void next(Block *next) noexcept {
+		assert(next != this);
+		mPtr = next;
+		mPtr.free(true);
+	}
+	
+	/**
+	 * Mark this block as free and set its successor and size.
+	 * 
+	 * @param next The next block in the free list, or `nullptr`.
+	 * @param size The usable size of this block, not including the block descriptor.
+	 */
+	void next(Block *next, std::size_t size) noexcept {
+		this->next(next);
+		assert(size >= MinBlockSize && (size & sMaskPrevFree) == 0);
+		mSize = size | (mSize & sMaskPrevFree);
+	}
+	
+	/**
+	 * Get the next block in the free list. This block must represent a free block.
+	 * 
+	 * @return Pointer to the next block in the free list.
+	 */
+	Block* next() const noexcept {
+		assert(this->free() && !this->mark());
+		return mPtr.get<Block>();
+	}
+	
+	/**
+	 * Get a pointer to the block following this block in the heap.
+	 * 
+	 * @return Pointer to the physically next block in the heap.
+	 */
+	Block* following() const noexcept {
+		return reinterpret_cast<Block*>(this->data() + align(this->size()));
+	}
+	
+	/**
+	 * Mark this block as used and set the data type.
+	 * 
+	 * @param type The type descriptor for the data in this block.
+	 */
+	void type(const TypeDescriptor &type) noexcept {
+		mPtr = &type;
+		mPtr.free(false);
+	}
+	
+	/**
+	 * Get the data type in this block. This block must represent a used block.
+	 * 
+	 * @return Reference to the type descriptor for the data in this block.
+	 */
+	const TypeDescriptor& type() const noexcept {
+		assert(this->used() && !this->mark());
+		return *mPtr.get<const TypeDescriptor>();
+	}
+	
+	/**
+	 * Record that the object in this block, which must be in the nursery, was moved to another block. In the
+	 * nursery, free blocks are objects that were moved or deallocated.
+	 * 
+	 * @param to The block the object was moved to, or `nullptr` if the object was deallocated.
+	 */
+	void forward(Block *to) noexcept {
+		mPtr = to;
+		mPtr.free(true);
+	}
+	
+	/**
+	 * Get the block the object in this block was moved to. This block must be in the nursery and free.
+	 * 
+	 * @return Pointer to the block holding the moved object, or `nullptr` if the object was deallocated.
+	 */
+	Block* forwardee() const noexcept {
+		assert(this->free());
+		return mPtr.get<Block>();
+	}
+	
+	/**
+	 * Get whether this block is free.
+	 * 
+	 * @return `true` if this block is part of the free list and does not hold an object.
+	 */
+	bool free() const noexcept {
+		return mPtr.free();
+	}
+	
+	/**
+	 * Get whether this block is used.
+	 * 
+	 * @return `true` if this block contains an object and is not part of the free list.
+	 */
+	bool used() const noexcept {
+		return mPtr.used();
+	}
+	
+	/**
+	 * Get the GC mark for this block.
+	 * 
+	 * @return `true` if the mark is set, `false` otherwise.
+	 */
+	bool mark() const noexcept {
+		return mPtr.mark();
+	}
+	
+	/**
+	 * Set the GC mark for this block, if marks are kept in block headers.
+	 * 
+	 * @param mark `true` to set the mark, `false` to clear it.
+	 */
+	void mark(bool mark) noexcept {
+		mPtr.mark(mark);
+	}
+	
+	/**
+	 * Get the data type in this block regardless of its mark. This block must represent a used block that is
+	 * not being traced (see {@link scanPosition}).
+	 * 
+	 * @return Reference to the type descriptor for the data in this block.
+	 */
+	const TypeDescriptor& markedType() const noexcept {
+		assert(this->used());
+		return *mPtr.get<const TypeDescriptor>();
+	}
+	
+	/**
+	 * Set the pointer offset of the field that is being traced by Deutsch-Schorr-Waite marking. While the
+	 * block is traced, it does not record its type.
+	 * 
+	 * @param position Pointer into the offset list of the type of this block, which may be the end sentinel.
+	 */
+	void scanPosition(const std::ptrdiff_t *position) noexcept {
+		mPtr = position;
+	}
+	
+	/**
+	 * Get the pointer offset of the field that is being traced, see {@link scanPosition}.
+	 */
+	const std::ptrdiff_t* scanPosition() const noexcept {
+		return mPtr.get<const std::ptrdiff_t>();
+	}
+	
+	/**
+	 * Finish tracing the fields of this block, which records its type again.
+	 * 
+	 * @param type The type descriptor for the data in this block.
+	 */
+	void endScan(const TypeDescriptor &type) noexcept {
+		mPtr = &type;
+	}
+	
+	/**
+	 * Get a pointer to the data portion of this block.
+	 * 
+	 * @return Pointer to the data portion of this block.
+	 */
+	byte* data() const noexcept {
+		return const_cast<byte*>(reinterpret_cast<const byte*>(this) + Align);
+	}
+	
+	/**
+	 * Split this block in two blocks if possible. If there is enough space for another block, then this
+	 * block will be resized to the new size and a new free block will be created after it; if there is not
+	 * enough space then nothing will be changed. This block must be a free block.
+	 * 
+	 * The new block is not added to any free list, that is the responsibility of the caller.
+	 * 
+	 * @param newSize The new size of this block, will be properly aligned.
+	 * @return Pointer to the newly created block, or `nullptr` if the block was not split.
+	 */
+	Block* split(std::size_t newSize) noexcept {
+		assert(this->free());
+		
+		const auto alignedSize = align(newSize);
+		const auto oldSize = align(this->size());
+		if(oldSize > alignedSize + 2 * Align) {
+			Block *newBlock = reinterpret_cast<Block*>(reinterpret_cast<byte*>(this) + Align + alignedSize);
+			new(newBlock) Block(oldSize - alignedSize - Align);
+			mSize = alignedSize | (mSize & sMaskPrevFree);
+			return newBlock;
+		}
+		return nullptr;
+	}
+}; // class HeapBase::Block
+#endif
+
+/**
+ * The header of an object in the large object space. Each large object has its own mapping, which starts
+ * with this header, followed by a regular block holding the object. The object is therefore not
+ * page-aligned itself, the header and the block header come first. Large objects keep their mark here
+ * instead of in the block header or the mark bitmap.
+ */
+struct HeapBase::LargeObject
+{
+	/** The previous large object in the list of all large objects, or `nullptr`. */
+	LargeObject *prev;
+	/** The next large object in the list of all large objects, or `nullptr`. */
+	LargeObject *next;
+	/** The size of the mapping in bytes. */
+	std::size_t mappedSize;
+	/** The GC mark of the object. */
+	std::atomic<bool> mark;
+	
+	/**
+	 * Get the block holding the object.
+	 */
+	Block* block() noexcept {
+		return reinterpret_cast<Block*>(reinterpret_cast<byte*>(this) + align(sizeof(LargeObject)));
+	}
+	
+	/**
+	 * Get the large object header for the specified block, which must be in the large object space.
+	 */
+	static LargeObject& of(const Block *blk) noexcept {
+		return *reinterpret_cast<LargeObject*>(
+				const_cast<byte*>(reinterpret_cast<const byte*>(blk)) - align(sizeof(LargeObject)));
+	}
+}; // struct HeapBase::LargeObject
+
+inline std::size_t HeapBase::objectSize(const Block *blk, const TypeDescriptor &type) noexcept {
+	if(!blk->array()) {
+		return type.size();
+	}
+	return ArrayElementsOffset + arrayHeader(blk->data()).length * type.size();
+}
+
+inline std::size_t HeapBase::fieldBase(Block &blk) noexcept {
+	return blk.array() ? ArrayElementsOffset + arrayHeader(blk.data()).scanOffset : 0;
+}
+
+inline bool HeapBase::leaf(const Block *blk, const TypeDescriptor &type) noexcept {
+	return type.leaf() || (blk->array() && arrayHeader(blk->data()).length == 0);
+}
+
+inline void HeapBase::touchBlock(const Block *blk) noexcept {
+	this->touchPages(blk, reinterpret_cast<const byte*>(blk->following()) + Align + MinBlockSize);
+}
+
+template <typename F>
+void HeapBase::forEachField(Block *blk, const TypeDescriptor &type, F f) noexcept {
+	byte *obj = blk->data();
+	std::size_t count = 1;
+	if(blk->array()) {
+		count = arrayHeader(obj).length;
+		obj += ArrayElementsOffset;
+	}
+	for(; count > 0; count--, obj += type.size()) {
+		for(auto offset : type) {
+			f(*reinterpret_cast<byte**>(obj + offset));
+		}
+	}
+}
+
+inline void HeapBase::destroy(Block *blk) noexcept {
+	const auto &type = blk->type();
+	mStats.numObjects--;
+	mStats.objectSize -= objectSize(blk, type);
+	if(mProfiling.load(std::memory_order_relaxed)) {
+		this->profileFree(type);
+	}
+	if(!blk->array()) {
+		type.destroy(blk->data());
+	} else if(!type.triviallyDestructible()) {
+		const auto length = arrayHeader(blk->data()).length;
+		for(std::size_t i = 0; i < length; i++) {
+			type.destroy(blk->data() + ArrayElementsOffset + i * type.size());
+		}
+	}
+}
+
+} // namespace ssw
+
+#endif /* HEAPBLOCK_HPP_ */
@@ -0,0 +1,160 @@
+/**
+ * @file    HeapGrowth.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the functions of {@link HeapBase} that grow and shrink reserved heap storage.
+ */
+
+#include "Heap.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+#include "HeapBlock.hpp"
+#include "VirtualMemory.hpp"
+
+namespace ssw {
+
+namespace {
+
+/**
+ * Round the specified size up to a multiple of the page size.
+ */
+inline std::size_t pageRound(std::size_t size) noexcept {
+	const auto pageSize = VirtualMemory::pageSize();
+	return (size + pageSize - 1) / pageSize * pageSize;
+}
+
+} // namespace
+
+byte* HeapBase::reserveStorage(std::size_t size, std::size_t maxSize) {
+	assert(size <= maxSize && size % VirtualMemory::pageSize() == 0 && maxSize % VirtualMemory::pageSize() == 0);
+	
+	const auto reservedSize = reservationSize(maxSize);
+	const auto result = static_cast<byte*>(VirtualMemory::reserve(pageRound(reservedSize)));
+	if(!result) {
+		throw std::bad_alloc();
+	}
+	// A heap cannot be constructed without its storage
+	if(!VirtualMemory::commit(result, size)
+			|| !VirtualMemory::commit(result + maxSize, pageRound(reservedSize - maxSize))) {
+		VirtualMemory::unmap(result, pageRound(reservedSize));
+		throw std::bad_alloc();
+	}
+	return result;
+}
+
+bool HeapBase::grow(std::size_t minSize) noexcept {
+	assert(mTlabStops > 0);
+	if(mStorageEnd == mStorageLimit) {
+		return false;
+	}
+	
+	const auto end = reinterpret_cast<byte*>(mStorageEnd);
+	const auto available = static_cast<std::size_t>(reinterpret_cast<byte*>(mStorageLimit) - end);
+	const auto size = std::min(pageRound(std::max(minSize + Align, this->storageSize() / 2)), available);
+	if(size < minSize + Align || !VirtualMemory::commit(end, size)) {
+		return false;
+	}
+	if(mHugePages) {
+		// Decommitting replaced the mapping, which dropped the advice
+		VirtualMemory::hugePages(end, size, true);
+	}
+	
+	// The new space is added after the nursery, which becomes part of the old generation. Young objects are
+	// tenured where they are, as if they were retained by a minor collection.
+	for(auto blk = mHeapEnd; blk < mNurseryTop; blk = blk->following()) {
+		if(blk->used()) {
+			blk->mark(true);
+		}
+	}
+	this->absorbNursery();
+	this->clearSideTables(mStorageEnd, reinterpret_cast<Block*>(end + size));
+	Block* const blk = mStorageEnd;
+	if(mSweepCursor == mHeapEnd) {
+		mSweepCursor = reinterpret_cast<Block*>(end + size);
+	}
+	mStorageEnd = mHeapEnd = mNurseryTop = reinterpret_cast<Block*>(end + size);
+	
+	// The block before the new one may be free, but it is merged with the new one later anyway
+	this->setBlockStart(blk);
+	this->addFreeBlock(new(blk) Block(size - Align));
+	return true;
+}
+
+void HeapBase::resizeStorage() noexcept {
+	assert(mTlabStops > 0 && mSweepCursor == mHeapEnd);
+	if((mStorageEnd == mStorageLimit && this->storageSize() == mMinStorageSize) || mNurseryTop != mHeapEnd) {
+		return;
+	}
+	
+	this->absorbNursery();
+	std::size_t freeSize = 0;
+	// The first of the free blocks at the end of the heap, which are not necessarily merged
+	Block *tail = nullptr;
+	for(auto blk = mHeapStart; blk < mHeapEnd; blk = blk->following()) {
+		if(blk->used()) {
+			tail = nullptr;
+			continue;
+		}
+		freeSize += blk->size() + Align;
+		if(!tail) {
+			tail = blk;
+		}
+	}
+	
+	const auto size = this->storageSize();
+	if(4 * freeSize < size) {
+		this->grow(0);
+		return;
+	} else if(4 * freeSize <= 3 * size || !tail || size <= mMinStorageSize) {
+		return;
+	}
+	
+	// Keep twice the used space, and at least the smallest possible free block in place of the tail
+	const auto start = reinterpret_cast<byte*>(mHeapStart);
+	const auto end = std::max({
+			start + mMinStorageSize,
+			start + pageRound(2 * (size - freeSize)),
+			start + pageRound(reinterpret_cast<byte*>(tail) - start + Align + MinBlockSize)});
+	if(end >= reinterpret_cast<byte*>(mStorageEnd)) {
+		return;
+	}
+	
+	for(auto blk = tail; blk < mHeapEnd;) {
+		Block* const next = blk->following();
+		this->removeFreeBlock(blk);
+		if(blk != tail) {
+			this->clearBlockStart(blk);
+		}
+		blk = next;
+	}
+	// Including the page of the new boundary tag of the tail
+	this->touchPages(end - sizeof(std::size_t), mStorageEnd);
+	VirtualMemory::decommit(end, reinterpret_cast<byte*>(mStorageEnd) - end);
+	mStorageEnd = mHeapEnd = mNurseryTop = mSweepCursor = reinterpret_cast<Block*>(end);
+	this->addFreeBlock(new(tail) Block(end - reinterpret_cast<byte*>(tail) - Align));
+}
+
+void HeapBase::clearSideTables(const Block *start, const Block *end) noexcept {
+	const auto first = static_cast<std::size_t>(reinterpret_cast<const byte*>(start)
+			- reinterpret_cast<const byte*>(mHeapStart));
+	const auto last = static_cast<std::size_t>(reinterpret_cast<const byte*>(end)
+			- reinterpret_cast<const byte*>(mHeapStart));
+			
+	// Both ends are page-aligned, so no bitmap word or card is shared with the storage outside the range
+	for(auto i = markBitmapWords(first); i < std::min(mMarkWords, markBitmapWords(last)); i++) {
+		mMarkBits[i].store(0, std::memory_order_relaxed);
+	}
+	if(mCards) {
+		for(auto i = cardTableSize(first); i < std::min(mNumCards, cardTableSize(last)); i++) {
+			mCards[i].store(0, std::memory_order_relaxed);
+		}
+		for(auto i = markBitmapWords(first); i < markBitmapWords(last); i++) {
+			mBlockStarts[i].store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+} // namespace ssw
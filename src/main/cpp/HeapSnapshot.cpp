@@ -0,0 +1,248 @@
+/**
+ * @file    HeapSnapshot.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the functions of {@link HeapSnapshot}.
+ */
+
+#include "HeapSnapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace ssw {
+
+namespace {
+
+/**
+ * Read a little-endian 64 bit number.
+ */
+bool readNumber(std::istream &is, std::uint64_t &value) {
+	unsigned char bytes[8];
+	if(!is.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+		return false;
+	}
+	value = 0;
+	for(std::size_t i = sizeof(bytes); i > 0; i--) {
+		value = (value << 8) | bytes[i - 1];
+	}
+	return true;
+}
+
+} // namespace
+
+constexpr HeapSnapshot::Index HeapSnapshot::Unreachable;
+
+bool HeapSnapshot::read(std::istream &is) {
+	mTypes.clear();
+	mObjects.clear();
+	mEdges.clear();
+	mRoots.clear();
+	mReachableSize = 0;
+	
+	char magic[8];
+	if(!is.read(magic, sizeof(magic)) || std::memcmp(magic, "SSWSNAP1", sizeof(magic)) != 0) {
+		return false;
+	}
+	
+	// References and roots are addresses until all objects are known
+	std::vector<std::uint64_t> edges;
+	std::vector<std::uint64_t> roots;
+	bool complete = false;
+	while(!complete) {
+		const auto tag = is.get();
+		std::uint64_t id, size, length, count;
+		if(tag == 'T') {
+			if(!readNumber(is, id) || !readNumber(is, size) || !readNumber(is, length)
+					|| id != mTypes.size() || length > 65536) {
+				return false;
+			}
+			std::string name(length, '\0');
+			if(!is.read(&name[0], length)) {
+				return false;
+			}
+			mTypes.push_back({std::move(name), size});
+		} else if(tag == 'O') {
+			Object obj{};
+			if(!readNumber(is, obj.address) || !readNumber(is, obj.type) || !readNumber(is, obj.size)
+					|| !readNumber(is, obj.flags) || !readNumber(is, obj.length) || !readNumber(is, count)
+					|| obj.type >= mTypes.size() || mObjects.size() >= Unreachable - 1) {
+				return false;
+			}
+			obj.firstEdge = edges.size();
+			obj.numEdges = count;
+			for(; count > 0; count--) {
+				std::uint64_t address;
+				if(!readNumber(is, address)) {
+					return false;
+				}
+				edges.push_back(address);
+			}
+			mObjects.push_back(obj);
+		} else if(tag == 'R') {
+			std::uint64_t address;
+			if(!readNumber(is, address)) {
+				return false;
+			}
+			roots.push_back(address);
+		} else if(tag == 'E') {
+			complete = true;
+		} else {
+			return false;
+		}
+	}
+	
+	// Resolve addresses, dropping those that do not belong to an object in the snapshot
+	std::vector<std::pair<std::uint64_t, Index>> byAddress;
+	byAddress.reserve(mObjects.size());
+	for(std::size_t i = 0; i < mObjects.size(); i++) {
+		byAddress.emplace_back(mObjects[i].address, static_cast<Index>(i));
+	}
+	std::sort(byAddress.begin(), byAddress.end());
+	const auto find = [&byAddress](std::uint64_t address) {
+		auto it = std::lower_bound(byAddress.begin(), byAddress.end(), std::make_pair(address, Index{0}));
+		return it != byAddress.end() && it->first == address ? it->second : Unreachable;
+	};
+	
+	mEdges.reserve(edges.size());
+	for(auto &obj : mObjects) {
+		const auto first = obj.firstEdge;
+		obj.firstEdge = mEdges.size();
+		for(std::size_t i = first; i < first + obj.numEdges; i++) {
+			const auto target = find(edges[i]);
+			if(target != Unreachable) {
+				mEdges.push_back(target);
+			}
+		}
+		obj.numEdges = mEdges.size() - obj.firstEdge;
+	}
+	for(auto address : roots) {
+		const auto root = find(address);
+		if(root != Unreachable) {
+			mRoots.push_back(root);
+		}
+	}
+	return true;
+}
+
+// Iterative dominator algorithm by Cooper, Harvey and Kennedy, on the graph with a virtual root (index N)
+// whose successors are the roots
+void HeapSnapshot::computeDominators() {
+	const auto numObjects = mObjects.size();
+	const auto virtualRoot = static_cast<Index>(numObjects);
+	const auto successors = [this, virtualRoot](Index node) {
+		if(node == virtualRoot) {
+			return std::make_pair(mRoots.data(), mRoots.data() + mRoots.size());
+		}
+		const auto &obj = mObjects[node];
+		return std::make_pair(mEdges.data() + obj.firstEdge, mEdges.data() + obj.firstEdge + obj.numEdges);
+	};
+	
+	// Depth-first search for the postorder numbers, without recursion since object graphs may be deep
+	std::vector<Index> postorder(numObjects + 1, Unreachable);
+	std::vector<Index> order;
+	order.reserve(numObjects + 1);
+	{
+		std::vector<bool> visited(numObjects + 1, false);
+		std::vector<std::pair<Index, const Index*>> stack;
+		visited[virtualRoot] = true;
+		stack.emplace_back(virtualRoot, successors(virtualRoot).first);
+		while(!stack.empty()) {
+			auto &top = stack.back();
+			const auto end = successors(top.first).second;
+			while(top.second != end && visited[*top.second]) {
+				top.second++;
+			}
+			if(top.second == end) {
+				postorder[top.first] = static_cast<Index>(order.size());
+				order.push_back(top.first);
+				stack.pop_back();
+			} else {
+				const auto next = *top.second++;
+				visited[next] = true;
+				stack.emplace_back(next, successors(next).first);
+			}
+		}
+	}
+	
+	// Predecessors of reachable nodes
+	std::vector<std::size_t> predStart(numObjects + 2, 0);
+	for(auto node : order) {
+		const auto succ = successors(node);
+		for(auto it = succ.first; it != succ.second; it++) {
+			predStart[*it + 1]++;
+		}
+	}
+	for(std::size_t i = 1; i < predStart.size(); i++) {
+		predStart[i] += predStart[i - 1];
+	}
+	std::vector<Index> preds(predStart.back());
+	{
+		auto fill = predStart;
+		for(auto node : order) {
+			const auto succ = successors(node);
+			for(auto it = succ.first; it != succ.second; it++) {
+				preds[fill[*it]++] = node;
+			}
+		}
+	}
+	
+	std::vector<Index> dominators(numObjects + 1, Unreachable);
+	dominators[virtualRoot] = virtualRoot;
+	const auto intersect = [&dominators, &postorder](Index a, Index b) {
+		while(a != b) {
+			while(postorder[a] < postorder[b]) {
+				a = dominators[a];
+			}
+			while(postorder[b] < postorder[a]) {
+				b = dominators[b];
+			}
+		}
+		return a;
+	};
+	bool changed = true;
+	while(changed) {
+		changed = false;
+		// Reverse postorder, skipping the virtual root which comes last in postorder
+		for(auto it = order.rbegin() + 1; it != order.rend(); it++) {
+			Index dominator = Unreachable;
+			for(auto i = predStart[*it]; i < predStart[*it + 1]; i++) {
+				const auto pred = preds[i];
+				if(dominators[pred] != Unreachable) {
+					dominator = dominator == Unreachable ? pred : intersect(pred, dominator);
+				}
+			}
+			if(dominators[*it] != dominator) {
+				dominators[*it] = dominator;
+				changed = true;
+			}
+		}
+	}
+	
+	// Dominators come after the objects they dominate in postorder
+	mReachableSize = 0;
+	for(auto &obj : mObjects) {
+		obj.retainedSize = 0;
+	}
+	for(auto node : order) {
+		if(node == virtualRoot) {
+			continue;
+		}
+		auto &obj = mObjects[node];
+		obj.dominator = dominators[node];
+		obj.retainedSize += obj.size;
+		if(obj.dominator == virtualRoot) {
+			mReachableSize += obj.retainedSize;
+		} else {
+			mObjects[obj.dominator].retainedSize += obj.retainedSize;
+		}
+	}
+	for(std::size_t i = 0; i < numObjects; i++) {
+		if(postorder[i] == Unreachable) {
+			mObjects[i].dominator = Unreachable;
+		}
+	}
+}
+
+} // namespace ssw
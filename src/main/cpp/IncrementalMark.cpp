@@ -0,0 +1,76 @@
+/**
+ * @file    IncrementalMark.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the incremental marking functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <mutex>
+#include <vector>
+
+#include "CollectingScope.hpp"
+#include "HeapBlock.hpp"
+#include "PhaseTimer.hpp"
+
+namespace ssw {
+
+bool HeapBase::gcStep(std::size_t budget) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	CollectingScope collecting{*this};
+	PhaseTimer timer{*this, GcPhase::IncrementalStep};
+	if(!mMarking.load(std::memory_order_relaxed)) {
+		this->beginCollection();
+		mMarking.store(true, std::memory_order_relaxed);
+		this->forEachRoot([this](byte *root) {
+			this->shade(root);
+		});
+	}
+	
+	if(!this->markIncrementally(budget)) {
+		return false;
+	}
+	this->finishCollection();
+	return true;
+}
+
+void HeapBase::shade(void *obj) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	const auto ptr = static_cast<byte*>(obj);
+	if(ptr >= reinterpret_cast<byte*>(mHeapEnd) && ptr < reinterpret_cast<byte*>(mStorageEnd)) {
+		// Young objects are not marked
+		return;
+	}
+	
+	Block &blk = block(ptr);
+	if(!this->marked(&blk)) {
+		// Leaf objects are black right away
+		const bool leaf = HeapBase::leaf(&blk, blk.type());
+		this->setMark(&blk);
+		if(!leaf) {
+			mGreyObjects.push_back(ptr);
+		}
+	}
+}
+
+bool HeapBase::markIncrementally(std::size_t budget) noexcept {
+	for(; budget > 0 && !mGreyObjects.empty(); budget--) {
+		const auto obj = mGreyObjects.back();
+		mGreyObjects.pop_back();
+		// Marks may be kept in the block header, so type() cannot be used
+		forEachField(&block(obj), block(obj).markedType(), [this](byte *child) {
+			// The nursery is empty while marking, so all children are old or large objects
+			if(child && !this->marked(&block(child))) {
+				const bool leaf = HeapBase::leaf(&block(child), block(child).type());
+				this->setMark(&block(child));
+				if(!leaf) {
+					mGreyObjects.push_back(child);
+				}
+			}
+		});
+	}
+	return mGreyObjects.empty();
+}
+
+} // namespace ssw
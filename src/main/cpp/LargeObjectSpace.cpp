@@ -0,0 +1,75 @@
+/**
+ * @file    LargeObjectSpace.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the large object space functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <new>
+
+#include "HeapBlock.hpp"
+#include "VirtualMemory.hpp"
+
+namespace ssw {
+
+void* HeapBase::allocateLarge(const TypeDescriptor &type, std::size_t size) noexcept {
+	const auto pageSize = VirtualMemory::pageSize();
+	const auto mappedSize = (align(sizeof(LargeObject)) + Align + align(size) + pageSize - 1) / pageSize * pageSize;
+	void *mem = VirtualMemory::map(mappedSize);
+	if(!mem) {
+		return nullptr;
+	}
+	
+	auto large = new(mem) LargeObject();
+	large->prev = nullptr;
+	large->next = mLargeObjects;
+	large->mappedSize = mappedSize;
+	large->mark.store(false, std::memory_order_relaxed);
+	if(mLargeObjects) {
+		mLargeObjects->prev = large;
+	}
+	mLargeObjects = large;
+	mLargeObjectsSize += mappedSize;
+	
+	// Large objects are never split, so the block spans the rest of the mapping
+	Block *blk = new(large->block()) Block(mappedSize - align(sizeof(LargeObject)) - Align);
+	blk->type(type);
+	// Blocks allocated during incremental marking must be marked, like in the old generation
+	if(mMarking.load(std::memory_order_relaxed)) {
+		large->mark.store(true, std::memory_order_relaxed);
+	}
+	return blk->data();
+}
+
+void HeapBase::freeLarge(Block *blk) noexcept {
+	auto &large = LargeObject::of(blk);
+	if(large.prev) {
+		large.prev->next = large.next;
+	} else {
+		mLargeObjects = large.next;
+	}
+	if(large.next) {
+		large.next->prev = large.prev;
+	}
+	
+	const auto mappedSize = large.mappedSize;
+	mLargeObjectsSize -= mappedSize;
+	large.~LargeObject();
+	VirtualMemory::unmap(&large, mappedSize);
+}
+
+void HeapBase::sweepLargeObjects() noexcept {
+	for(auto large = mLargeObjects; large;) {
+		const auto next = large->next;
+		if(!large->mark.exchange(false, std::memory_order_relaxed)) {
+			Block *blk = large->block();
+			destroy(blk);
+			this->freeLarge(blk);
+		}
+		large = next;
+	}
+}
+
+} // namespace ssw
@@ -0,0 +1,106 @@
+/**
+ * @file    MarkStack.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the serial marking with a bounded mark stack of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <cassert>
+
+#include "HeapBlock.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace ssw {
+
+namespace {
+
+/** The number of discovered objects whose headers are prefetched before the first of them is visited. */
+constexpr std::size_t PrefetchDistance = 8;
+
+/**
+ * Prefetch the cache line at the specified address for writing, if the platform supports it.
+ */
+inline void prefetch(const void *ptr) noexcept {
+#if defined(__GNUC__)
+	__builtin_prefetch(ptr, 1);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#else
+	static_cast<void>(ptr);
+#endif
+}
+
+} // namespace
+
+// Mark the object graph for the specified heap root depth-first with a bounded mark stack. Discovered children
+// wait in a small FIFO queue while their headers are prefetched, objects that do not fit onto the stack are
+// marked with the Deutsch-Schorr-Waite algorithm.
+void HeapBase::markWithStack(byte *root) noexcept {
+	assert(root);
+	assert(!this->marked(&block(root)));
+	
+	const auto capacity = mMarkStackSize;
+	if(!capacity) {
+		this->mark(root);
+		return;
+	}
+	if(mMarkStack.size() != capacity) {
+		mMarkStack.resize(capacity);
+	}
+	byte** const stack = mMarkStack.data();
+	std::size_t top = 0;
+	
+	// Objects on the stack are marked, so pointer reversal never enters them and they stay intact
+	const auto visit = [this, stack, capacity, &top](byte *obj) {
+		Block &blk = block(obj);
+		if(this->marked(&blk)) {
+			return;
+		} else if(leaf(&blk, blk.type())) {
+			this->setMark(&blk);
+		} else if(top < capacity) {
+			this->setMark(&blk);
+			stack[top++] = obj;
+		} else {
+			this->mark(obj);
+		}
+	};
+	
+	byte *queue[PrefetchDistance];
+	std::size_t head = 0;
+	std::size_t queued = 0;
+	visit(root);
+	while(top > 0 || queued > 0) {
+		if(top == 0) {
+			// Out of objects to scan, visit the queued ones even if their headers may not be cached yet
+			queued--;
+			const auto obj = queue[head];
+			head = (head + 1) % PrefetchDistance;
+			visit(obj);
+			continue;
+		}
+		
+		Block &blk = block(stack[--top]);
+		// Marks may be kept in the block header, so type() cannot be used
+		forEachField(&blk, blk.markedType(), [&visit, &queue, &head, &queued](byte *child) {
+			if(!child) {
+				return;
+			}
+			prefetch(&block(child));
+			if(queued < PrefetchDistance) {
+				queue[(head + queued++) % PrefetchDistance] = child;
+			} else {
+				const auto obj = queue[head];
+				queue[head] = child;
+				head = (head + 1) % PrefetchDistance;
+				visit(obj);
+			}
+		});
+	}
+}
+
+} // namespace ssw
@@ -0,0 +1,269 @@
+/**
+ * @file    Nursery.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the nursery (young generation) functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "CollectingScope.hpp"
+#include "HeapBlock.hpp"
+#include "PhaseTimer.hpp"
+
+namespace ssw {
+
+/**
+ * The state of a minor collection.
+ */
+struct HeapBase::PromotionState
+{
+	/** Promoted (or retained) objects whose fields have not been updated yet. */
+	std::vector<byte*> worklist;
+	/** Whether free blocks were merged already because promotion failed. */
+	bool merged = false;
+	/** Whether any young objects could not be promoted. */
+	bool retained = false;
+};
+
+void HeapBase::nurserySize(std::size_t size) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	CollectingScope collecting{*this};
+	this->stopTlabs();
+	this->rebuildFreeList();
+	
+	// Empty the nursery and give its space back to the old generation
+	this->collectNursery();
+	this->absorbNursery();
+	
+	// A nursery must at least hold its four largest objects
+	mNurserySize.store(size ? align(size < 8 * Align ? 8 * Align : size) : 0, std::memory_order_relaxed);
+	this->ensureNursery();
+	this->resumeTlabs();
+}
+
+void HeapBase::minorGc() noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	CollectingScope collecting{*this};
+	PhaseTimer timer{*this, GcPhase::MinorCollection};
+	this->stopTlabs();
+	this->collectNursery();
+	this->resumeTlabs();
+}
+
+void* HeapBase::allocateYoung(const TypeDescriptor &type) noexcept {
+	const auto size = align(type.size());
+	if(size > mNurserySize.load(std::memory_order_relaxed) / 4) {
+		return nullptr;
+	}
+	// Always leave room for a free block at the end, in case the nursery becomes part of the old generation
+	const auto top = reinterpret_cast<byte*>(mNurseryTop);
+	if(top + Align + size + Align + MinBlockSize > reinterpret_cast<byte*>(mStorageEnd)) {
+		return nullptr;
+	}
+	
+	Block *blk = new(mNurseryTop) Block(size);
+	blk->type(type);
+	mNurseryTop = blk->following();
+	return blk->data();
+}
+
+void HeapBase::collectNursery() noexcept {
+	if(mNurseryTop == mHeapEnd) {
+		return;
+	}
+	
+	PromotionState state{};
+	this->forEachRoot([this, &state](byte *&root) {
+		this->promote(state, root);
+	});
+	// The card table does not cover large objects, which are all live outside of garbage collection
+	for(auto large = mLargeObjects; large; large = large->next) {
+		this->promoteChildren(state, large->block()->data());
+	}
+	if(mUseCards) {
+		this->scanCards(state);
+	} else {
+		// Without the card table, all live objects of the old generation may point into the nursery
+		for(auto blk = mHeapStart; blk < mHeapEnd; blk = blk->following()) {
+			if(this->maybeLive(blk)) {
+				this->promoteChildren(state, blk->data());
+			}
+		}
+	}
+	// Promoted objects may point to other young objects
+	while(!state.worklist.empty()) {
+		const auto obj = state.worklist.back();
+		state.worklist.pop_back();
+		this->promoteChildren(state, obj);
+	}
+	const bool weakRefsChanged = this->updateYoungWeakRefs();
+	// Pointers from the old generation cannot point into the nursery anymore
+	this->clearCards();
+	
+	// All young objects that were neither moved nor retained are garbage
+	for(auto blk = mHeapEnd; blk < mNurseryTop; blk = blk->following()) {
+		if(blk->used() && !blk->mark()) {
+			destroy(blk);
+		}
+	}
+	
+	if(state.retained) {
+		this->absorbNursery();
+	} else {
+		mNurseryTop = mHeapEnd;
+	}
+	if(weakRefsChanged) {
+		this->notifyWeakTables();
+	}
+}
+
+bool HeapBase::maybeLive(const Block *blk) const noexcept {
+	return blk->used() && (blk < mSweepCursor || this->marked(blk));
+}
+
+void HeapBase::promoteChildren(PromotionState &state, byte *obj) noexcept {
+	// Retained objects and objects that have not been swept yet may be marked, so type() cannot be used
+	forEachField(&block(obj), block(obj).markedType(), [this, &state](byte *&field) {
+		this->promote(state, field);
+	});
+}
+
+void HeapBase::scanCards(PromotionState &state) noexcept {
+	const auto base = reinterpret_cast<byte*>(mHeapStart);
+	// Blocks before this one have been scanned already
+	Block *scanned = mHeapStart;
+	for(std::size_t card = 0; card < mNumCards; card++) {
+		const auto cardStart = base + (card << CardShift);
+		if(cardStart >= reinterpret_cast<byte*>(mHeapEnd)) {
+			break;
+		} else if(!mCards[card].load(std::memory_order_relaxed)) {
+			continue;
+		}
+		
+		const auto cardEnd = reinterpret_cast<Block*>(cardStart + (std::size_t{1} << CardShift));
+		const bool merged = state.merged;
+		Block *blk = (scanned >= reinterpret_cast<Block*>(cardStart))
+				? scanned : this->blockStart(cardStart);
+		for(; blk < cardEnd && blk < mHeapEnd; blk = blk->following()) {
+			if(this->maybeLive(blk)) {
+				this->promoteChildren(state, blk->data());
+			}
+		}
+		// Merging free blocks for promotion may have removed the block after the last scanned one
+		scanned = (state.merged == merged) ? blk : mHeapStart;
+	}
+}
+
+void HeapBase::promote(PromotionState &state, byte *&field) noexcept {
+	if(!field || !this->inNursery(field)) {
+		return;
+	}
+	
+	Block &blk = block(field);
+	if(blk.free()) {
+		// Already promoted
+		assert(blk.forwardee() /* Pointer to a deallocated young object */);
+		field = blk.forwardee()->data();
+		return;
+	} else if(blk.mark()) {
+		// Already retained
+		return;
+	}
+	
+	// Arrays are never young, so the size of the object is the size of its type
+	const auto &type = blk.type();
+	auto copy = static_cast<byte*>(this->tryAllocate(type, align(type.size())));
+	if(!copy && !state.merged) {
+		state.merged = true;
+		this->mergeBlocks();
+		copy = static_cast<byte*>(this->tryAllocate(type, align(type.size())));
+	}
+	
+	if(copy) {
+		std::memcpy(copy, field, type.size());
+		blk.forward(&block(copy));
+		field = copy;
+	} else {
+		// The old generation is full, keep the object where it is
+		blk.mark(true);
+		state.retained = true;
+	}
+	state.worklist.push_back(field);
+}
+
+void HeapBase::absorbNursery() noexcept {
+	if(mHeapEnd == mStorageEnd) {
+		return;
+	}
+	
+	Block* const start = mHeapEnd;
+	Block* const top = mNurseryTop;
+	if(mSweepCursor == mHeapEnd) {
+		mSweepCursor = mStorageEnd;
+	}
+	mHeapEnd = mNurseryTop = mStorageEnd;
+	
+	// The state of the block before the nursery is unknown, so the first block never claims it is free
+	Block *free = nullptr;
+	for(auto blk = start; blk < top; blk = blk->following()) {
+		if(blk->free() || !blk->mark()) {
+			// Moved, deallocated or destroyed object
+			if(!free) {
+				free = blk;
+			}
+			continue;
+		}
+		
+		blk->mark(false);
+		this->setBlockStart(blk);
+		if(free) {
+			this->setBlockStart(free);
+			this->addFreeBlock(new(free) Block(
+					reinterpret_cast<byte*>(blk) - reinterpret_cast<byte*>(free) - Align));
+			free = nullptr;
+		} else {
+			blk->prevFree(false);
+		}
+		if(blk >= mSweepCursor) {
+			// Blocks that have not been swept yet must be marked or they would be swept
+			this->setMark(blk);
+		}
+	}
+	if(!free) {
+		free = top;
+	}
+	this->setBlockStart(free);
+	this->addFreeBlock(new(free) Block(
+			reinterpret_cast<byte*>(mStorageEnd) - reinterpret_cast<byte*>(free) - Align));
+}
+
+void HeapBase::ensureNursery() noexcept {
+	const auto size = mNurserySize.load(std::memory_order_relaxed);
+	if(!size || mHeapEnd != mStorageEnd || mSweepCursor != mHeapEnd || !mLastBlockFree) {
+		return;
+	}
+	
+	// The footer of the last block is right before the end of the old generation
+	const auto lastSize = reinterpret_cast<const std::size_t*>(mHeapEnd)[-1];
+	Block *last = reinterpret_cast<Block*>(reinterpret_cast<byte*>(mHeapEnd) - align(lastSize) - Align);
+	assert(last->free() && last->following() == mHeapEnd);
+	if(last->size() < size + Align) {
+		return;
+	}
+	
+	this->removeFreeBlock(last);
+	last->size(last->size() - size);
+	mHeapEnd = mNurseryTop = mSweepCursor = last->following();
+	// The boundary tag of the shortened block is right before the nursery
+	this->touchPages(reinterpret_cast<byte*>(mHeapEnd) - sizeof(std::size_t), mStorageEnd);
+	this->addFreeBlock(last);
+}
+
+} // namespace ssw
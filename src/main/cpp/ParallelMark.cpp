@@ -0,0 +1,257 @@
+/**
+ * @file    ParallelMark.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the parallel marking functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "HeapBlock.hpp"
+
+namespace ssw {
+
+namespace {
+
+/**
+ * A bounded work-stealing deque of grey objects (Chase-Lev deque with a fixed-size buffer).
+ * 
+ * The owning thread pushes and pops objects at the bottom, other threads steal objects from the top. When
+ * the deque is full, {@link push} fails instead of growing the buffer.
+ */
+class MarkDeque
+{
+	const std::size_t mMask;
+	std::unique_ptr<std::atomic<byte*>[]> mBuffer;
+	std::atomic<std::ptrdiff_t> mTop;
+	std::atomic<std::ptrdiff_t> mBottom;
+	
+public:
+	
+	/**
+	 * Initialize an empty deque with the specified capacity.
+	 * 
+	 * @param capacity The maximum number of objects in the deque, must be a power of two.
+	 */
+	explicit MarkDeque(std::size_t capacity)
+			: mMask(capacity - 1), mBuffer(new std::atomic<byte*>[capacity]), mTop(0), mBottom(0) {
+		assert((capacity & mMask) == 0);
+	}
+	
+	/**
+	 * Push an object onto the bottom of the deque, may only be called by the owning thread.
+	 * 
+	 * @param obj The object to push.
+	 * @return `true` if the object was pushed, `false` if the deque is full.
+	 */
+	bool push(byte *obj) noexcept {
+		const auto b = mBottom.load(std::memory_order_relaxed);
+		const auto t = mTop.load(std::memory_order_acquire);
+		if(static_cast<std::size_t>(b - t) > mMask) {
+			return false;
+		}
+		mBuffer[b & mMask].store(obj, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		mBottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+	
+	/**
+	 * Pop an object from the bottom of the deque, may only be called by the owning thread.
+	 * 
+	 * @param obj Receives the popped object.
+	 * @return `true` if an object was popped, `false` if the deque is empty.
+	 */
+	bool pop(byte *&obj) noexcept {
+		const auto b = mBottom.load(std::memory_order_relaxed) - 1;
+		mBottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = mTop.load(std::memory_order_relaxed);
+		if(t > b) {
+			mBottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+		obj = mBuffer[b & mMask].load(std::memory_order_relaxed);
+		if(t == b) {
+			// Last object, this may race with a thief
+			const bool won = mTop.compare_exchange_strong(t, t + 1,
+					std::memory_order_seq_cst, std::memory_order_relaxed);
+			mBottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+	
+	/**
+	 * Steal an object from the top of the deque, may be called by any thread.
+	 * 
+	 * @param obj Receives the stolen object.
+	 * @return `true` if an object was stolen, `false` if the deque is empty or another thread got it first.
+	 */
+	bool steal(byte *&obj) noexcept {
+		auto t = mTop.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto b = mBottom.load(std::memory_order_acquire);
+		if(t >= b) {
+			return false;
+		}
+		obj = mBuffer[t & mMask].load(std::memory_order_relaxed);
+		return mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+	
+	/**
+	 * Get whether the deque is (probably) empty.
+	 */
+	bool empty() const noexcept {
+		return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+	}
+}; // class MarkDeque
+
+/** The capacity of the mark stack of each marker thread. */
+constexpr std::size_t MarkStackSize = 4096;
+
+} // namespace
+
+struct HeapBase::ParallelMarkState
+{
+	/** One mark stack per marker thread. */
+	std::vector<std::unique_ptr<MarkDeque>> stacks;
+	/** The number of marker threads that are currently working (or trying to steal work). */
+	std::atomic<std::size_t> active;
+	/** Set if an object could not be pushed onto a mark stack. */
+	std::atomic<bool> overflow;
+	
+	explicit ParallelMarkState(std::size_t threads)
+			: stacks(), active(threads), overflow(false) {
+		stacks.reserve(threads);
+		for(std::size_t i = 0; i < threads; i++) {
+			stacks.emplace_back(new MarkDeque(MarkStackSize));
+		}
+	}
+}; // struct HeapBase::ParallelMarkState
+
+bool HeapBase::markParallel() noexcept {
+	std::unique_ptr<ParallelMarkState> stateHolder;
+	try {
+		stateHolder.reset(new ParallelMarkState{mMarkThreads});
+	} catch(const std::bad_alloc&) {
+		// Nothing is marked yet, the caller marks serially
+		return false;
+	}
+	auto &state = *stateHolder;
+	
+	// Partition the roots across the mark stacks before any marker thread is started
+	std::size_t next = 0;
+	this->forEachRoot([this, &state, &next](byte *root) {
+		if(this->tryMark(&block(root)) && !leaf(&block(root), block(root).type())) {
+			if(!state.stacks[next]->push(root)) {
+				state.overflow = true;
+			}
+			next = (next + 1) % mMarkThreads;
+		}
+	});
+	
+	std::vector<std::thread> threads;
+	threads.reserve(mMarkThreads - 1);
+	for(std::size_t i = 1; i < mMarkThreads; i++) {
+		try {
+			threads.emplace_back(&HeapBase::markWorker, this, std::ref(state), i);
+		} catch(const std::system_error&) {
+			// Continue with the threads we have, they will steal the roots of the missing ones
+			state.active -= mMarkThreads - i;
+			break;
+		}
+	}
+	
+	this->markWorker(state, 0);
+	for(auto &thread : threads) {
+		thread.join();
+	}
+	
+	if(state.overflow) {
+		this->markOverflowed();
+	}
+	return true;
+}
+
+void HeapBase::markWorker(ParallelMarkState &state, std::size_t index) noexcept {
+	auto &stack = *state.stacks[index];
+	const auto numStacks = state.stacks.size();
+	
+	byte *obj = nullptr;
+	while(true) {
+		while(stack.pop(obj)) {
+			// Grey the children of the object, marking is an atomic test-and-set
+			forEachField(&block(obj), block(obj).type(), [this, &state, &stack](byte *child) {
+				// Leaf objects are marked but not pushed, there is nothing to trace
+				if(child && this->tryMark(&block(child)) && !leaf(&block(child), block(child).type())
+						&& !stack.push(child)) {
+					// The child is marked but not traced, this is fixed up after parallel marking
+					state.overflow.store(true, std::memory_order_relaxed);
+				}
+			});
+		}
+		
+		// Out of work: steal from another thread, or stop when no thread has any work left. Stacks of
+		// working threads only fill up while they are active, so all work is done when no thread is active
+		// and all stacks are empty.
+		state.active.fetch_sub(1);
+		bool stolen = false;
+		while(!stolen) {
+			bool empty = true;
+			for(std::size_t i = 1; i < numStacks && !stolen; i++) {
+				auto &victim = *state.stacks[(index + i) % numStacks];
+				if(!victim.empty()) {
+					empty = false;
+					state.active.fetch_add(1);
+					stolen = victim.steal(obj);
+					if(!stolen) {
+						state.active.fetch_sub(1);
+					}
+				}
+			}
+			if(!stolen) {
+				if(empty && state.active.load() == 0) {
+					return;
+				}
+				std::this_thread::yield();
+			}
+		}
+		// Our own stack is empty, so this cannot overflow
+		stack.push(obj);
+	} // while(true)
+}
+
+// Complete marking after mark stack overflows using serial marking
+void HeapBase::markOverflowed() noexcept {
+	const auto markChildren = [this](Block *blk) {
+		forEachField(blk, blk->type(), [this](byte *child) {
+			if(child && !this->marked(&block(child))) {
+				this->markWithStack(child);
+			}
+		});
+	};
+	
+	// Includes the nursery, which is only marked when counting live objects
+	for(auto blk = mHeapStart; blk < mNurseryTop; blk = blk->following()) {
+		if(blk->used() && this->marked(blk)) {
+			markChildren(blk);
+		}
+	}
+	for(auto large = mLargeObjects; large; large = large->next) {
+		if(large->mark.load(std::memory_order_relaxed)) {
+			markChildren(large->block());
+		}
+	}
+}
+
+} // namespace ssw
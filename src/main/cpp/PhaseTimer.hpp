@@ -0,0 +1,57 @@
+/**
+ * @file    PhaseTimer.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the {@link HeapBase::PhaseTimer} class.
+ */
+
+#ifndef PHASETIMER_HPP_
+#define PHASETIMER_HPP_
+#pragma once
+
+#include <chrono>
+
+#include "GcEvents.hpp"
+#include "Heap.hpp"
+
+namespace ssw {
+
+/**
+ * Measures a phase of garbage collection from its construction to its destruction and reports it as an
+ * event of the heap. Must only be used with the heap lock held. If {@link SSW_GC_EVENTS} is not set, timers
+ * are empty and do nothing.
+ */
+class HeapBase::PhaseTimer
+{
+#if SSW_GC_EVENTS
+	HeapBase &mHeap;
+	const GcPhase mPhase;
+	const std::chrono::steady_clock::time_point mStart;
+	const std::size_t mObjectSize;
+	
+public:
+	
+	PhaseTimer(HeapBase &heap, GcPhase phase) noexcept
+			: mHeap(heap), mPhase(phase), mStart(std::chrono::steady_clock::now()),
+			  mObjectSize(heap.currentObjectSize()) {
+	}
+	
+	~PhaseTimer() {
+		const auto objectSize = mHeap.currentObjectSize();
+		mHeap.gcEvent({mPhase, mStart, std::chrono::steady_clock::now() - mStart,
+				mObjectSize > objectSize ? mObjectSize - objectSize : 0});
+	}
+#else
+public:
+	
+	PhaseTimer(HeapBase&, GcPhase) noexcept {
+	}
+#endif
+	
+	PhaseTimer(const PhaseTimer&) = delete;
+	PhaseTimer& operator=(const PhaseTimer&) = delete;
+}; // class HeapBase::PhaseTimer
+
+} // namespace ssw
+
+#endif /* PHASETIMER_HPP_ */
@@ -0,0 +1,121 @@
+/**
+ * @file    ReleaseMemory.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the functions of {@link HeapBase} that return free memory to the operating system.
+ */
+
+#include "Heap.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+#include "HeapBlock.hpp"
+#include "VirtualMemory.hpp"
+
+namespace ssw {
+
+namespace {
+
+/**
+ * Get the page size of the operating system, without asking it every time.
+ */
+std::size_t pageSize() noexcept {
+	static const std::size_t size = VirtualMemory::pageSize();
+	return size;
+}
+
+/**
+ * Round the specified address down to a multiple of the specified power of two.
+ */
+inline std::uintptr_t roundDown(const void *ptr, std::size_t granule) noexcept {
+	return reinterpret_cast<std::uintptr_t>(ptr) & ~(granule - 1);
+}
+
+/**
+ * Round the specified address up to a multiple of the specified power of two.
+ */
+inline std::uintptr_t roundUp(const void *ptr, std::size_t granule) noexcept {
+	return (reinterpret_cast<std::uintptr_t>(ptr) + granule - 1) & ~(granule - 1);
+}
+
+} // namespace
+
+void HeapBase::releaseThreshold(std::size_t size) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mReleaseThreshold = size;
+	if(!size) {
+		// Discarded pages need no tracking, they are backed by memory again on their own
+		mReleasedPages = std::vector<bool>();
+	} else if(mReleasedPages.empty()) {
+		const auto pages = (roundUp(mStorageLimit, pageSize()) - roundDown(mHeapStart, pageSize())) / pageSize();
+		mReleasedPages.resize(pages, false);
+	}
+}
+
+void HeapBase::hugePages(bool enable) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	if(!VirtualMemory::hugePageSize()) {
+		return;
+	}
+	
+	mHugePages = enable;
+	// Only whole pages of the committed storage, the storage of a static heap need not be page-aligned. The
+	// reserved address space after it is advised when it is committed by grow().
+	const auto start = roundUp(mHeapStart, pageSize());
+	const auto end = roundDown(mStorageEnd, pageSize());
+	if(start < end) {
+		VirtualMemory::hugePages(reinterpret_cast<void*>(start), end - start, enable);
+	}
+}
+
+void HeapBase::releaseFreeMemory() noexcept {
+	if(!mReleaseThreshold) {
+		return;
+	}
+	
+	const auto page = pageSize();
+	const auto granule = mHugePages ? std::max(VirtualMemory::hugePageSize(), page) : page;
+	const auto base = roundDown(mHeapStart, page);
+	// The nursery is taken from the end of the old generation next, and would be touched right away
+	const auto nurserySize = mNurserySize.load(std::memory_order_relaxed);
+	const auto limit = reinterpret_cast<std::uintptr_t>(mHeapEnd)
+			- (mHeapEnd == mStorageEnd ? std::min(nurserySize, this->storageSize()) : 0);
+			
+	const auto minSize = align(std::max(mReleaseThreshold, std::size_t{Align}));
+	for(auto i = sizeClass(minSize); i < NumSizeClasses; i++) {
+		for(auto blk = mFreeLists[i]; blk; blk = blk->next()) {
+			if(blk->size() < minSize) {
+				continue;
+			}
+			
+			const auto start = roundUp(blk->data() + MinBlockSize, granule);
+			const auto end = std::min(roundDown(reinterpret_cast<byte*>(blk->following()) - sizeof(std::size_t),
+					granule), limit);
+			// Discard runs of pages that are not discarded yet with a single call each
+			for(auto run = start; run < end;) {
+				auto runEnd = run;
+				for(; runEnd < end && !mReleasedPages[(runEnd - base) / page]; runEnd += page) {
+					mReleasedPages[(runEnd - base) / page] = true;
+				}
+				if(runEnd > run) {
+					VirtualMemory::discard(reinterpret_cast<void*>(run), runEnd - run);
+				}
+				run = runEnd + page;
+			}
+		}
+	}
+}
+
+void HeapBase::clearReleasedPages(const void *start, const void *end) noexcept {
+	const auto page = pageSize();
+	const auto base = roundDown(mHeapStart, page);
+	const auto first = (std::max(reinterpret_cast<std::uintptr_t>(start), base) - base) / page;
+	const auto last = std::min((roundUp(end, page) - base) / page, mReleasedPages.size());
+	for(auto i = first; i < last; i++) {
+		mReleasedPages[i] = false;
+	}
+}
+
+} // namespace ssw
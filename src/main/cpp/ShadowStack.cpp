@@ -0,0 +1,63 @@
+/**
+ * @file    ShadowStack.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the shadow stack functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ssw {
+
+HeapBase::ShadowStack::~ShadowStack() {
+	assert(!top /* Local roots must not outlive their thread */);
+	std::lock_guard<std::mutex> recordLock{threadRecordMutex()};
+	if(const auto owner = heap.load(std::memory_order_relaxed)) {
+		std::lock_guard<std::recursive_mutex> lock{owner->mMutex};
+		owner->mShadowStacks.erase(std::remove(owner->mShadowStacks.begin(), owner->mShadowStacks.end(), this),
+				owner->mShadowStacks.end());
+	}
+}
+
+HeapBase::ShadowStack& HeapBase::shadowStack() noexcept {
+	thread_local std::vector<std::unique_ptr<ShadowStack>> stacks;
+	ShadowStack *detached = nullptr;
+	for(auto &stack : stacks) {
+		const auto owner = stack->heap.load(std::memory_order_relaxed);
+		if(owner == this) {
+			return *stack;
+		} else if(!owner && !detached) {
+			detached = stack.get();
+		}
+	}
+	
+	// Reuse the stack of a destroyed heap instead of freeing it, locals may still have it cached
+	if(detached) {
+		assert(!detached->top);
+		detached->heap.store(this, std::memory_order_relaxed);
+	} else {
+		stacks.emplace_back(new ShadowStack(*this));
+		detached = stacks.back().get();
+	}
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mShadowStacks.push_back(detached);
+	return *detached;
+}
+
+void HeapBase::detachShadowStacks() noexcept {
+	std::lock_guard<std::mutex> recordLock{threadRecordMutex()};
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	for(auto stack : mShadowStacks) {
+		stack->heap.store(nullptr, std::memory_order_relaxed);
+	}
+	mShadowStacks.clear();
+}
+
+} // namespace ssw
@@ -0,0 +1,146 @@
+/**
+ * @file    Snapshot.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the binary snapshot functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "HeapBlock.hpp"
+#include "HeapSnapshot.hpp"
+
+namespace ssw {
+
+namespace {
+
+/**
+ * A buffered writer for the records of a snapshot.
+ */
+class SnapshotOutput
+{
+	static constexpr std::size_t BufferSize = 64 * 1024;
+	
+	std::ostream &mStream;
+	char mBuffer[BufferSize];
+	std::size_t mUsed;
+	
+public:
+	
+	explicit SnapshotOutput(std::ostream &os) noexcept : mStream(os), mUsed(0) {
+	}
+	
+	~SnapshotOutput() {
+		this->flush();
+	}
+	
+	void flush() {
+		mStream.write(mBuffer, mUsed);
+		mUsed = 0;
+	}
+	
+	void put(const char *data, std::size_t size) {
+		if(mUsed + size > BufferSize) {
+			this->flush();
+			if(size > BufferSize) {
+				mStream.write(data, size);
+				return;
+			}
+		}
+		std::memcpy(mBuffer + mUsed, data, size);
+		mUsed += size;
+	}
+	
+	void tag(char tag) {
+		this->put(&tag, 1);
+	}
+	
+	// Numbers are little-endian regardless of the byte order of the machine
+	void number(std::uint64_t value) {
+		char bytes[8];
+		for(auto &byte : bytes) {
+			byte = static_cast<char>(value & 0xFF);
+			value >>= 8;
+		}
+		this->put(bytes, sizeof(bytes));
+	}
+};
+
+} // namespace
+
+bool HeapBase::writeSnapshot(std::ostream &os) {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	// Allocation buffers must not change the heap while it is written
+	this->stopTlabs();
+	
+	// The buffer is too large for the stack of every thread
+	std::unique_ptr<SnapshotOutput> out{new SnapshotOutput(os)};
+	std::unordered_map<const TypeDescriptor*, std::uint64_t> typeIds;
+	out->put("SSWSNAP1", 8);
+	
+	const auto writeObject = [this, &out, &typeIds](Block *blk, std::uint64_t flags) {
+		// Marks may be kept in the block header, so type() cannot be used
+		const auto &type = blk->markedType();
+		auto it = typeIds.find(&type);
+		if(it == typeIds.end()) {
+			it = typeIds.emplace(&type, typeIds.size()).first;
+			const auto name = type.name() ? type.name() : "";
+			const auto length = std::strlen(name);
+			out->tag('T');
+			out->number(it->second);
+			out->number(type.size());
+			out->number(length);
+			out->put(name, length);
+		}
+		
+		std::uint64_t numEdges = 0;
+		forEachField(blk, type, [&numEdges](byte *field) {
+			numEdges += field != nullptr;
+		});
+		out->tag('O');
+		out->number(reinterpret_cast<std::uintptr_t>(blk->data()));
+		out->number(it->second);
+		out->number(objectSize(blk, type));
+		if(blk->array()) {
+			flags |= HeapSnapshot::ArrayFlag;
+		}
+		if(blk->pinned()) {
+			flags |= HeapSnapshot::PinnedFlag;
+		}
+		out->number(flags);
+		out->number(blk->array() ? arrayHeader(blk->data()).length : 0);
+		out->number(numEdges);
+		forEachField(blk, type, [&out](byte *field) {
+			if(field) {
+				out->number(reinterpret_cast<std::uintptr_t>(field));
+			}
+		});
+	};
+	
+	// The nursery directly follows the old generation, so this also walks young objects
+	for(auto blk = mHeapStart; blk < mNurseryTop; blk = blk->following()) {
+		if(blk->used()) {
+			writeObject(blk, blk < mHeapEnd ? std::uint64_t{0} : std::uint64_t{HeapSnapshot::YoungFlag});
+		}
+	}
+	for(auto large = mLargeObjects; large; large = large->next) {
+		writeObject(large->block(), HeapSnapshot::LargeFlag);
+	}
+	this->forEachRoot([&out](byte *root) {
+		out->tag('R');
+		out->number(reinterpret_cast<std::uintptr_t>(root));
+	});
+	out->tag('E');
+	out.reset();
+	
+	this->resumeTlabs();
+	return static_cast<bool>(os);
+}
+
+} // namespace ssw
@@ -0,0 +1,73 @@
+/**
+ * @file    Sweeper.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the background sweeping functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "HeapBlock.hpp"
+
+namespace ssw {
+
+void HeapBase::backgroundSweep(bool enable) noexcept {
+	std::unique_lock<std::recursive_mutex> lock{mMutex};
+	if(enable && !mSweeper.joinable()) {
+		mSweeperExit = false;
+		try {
+			mSweeper = std::thread(&HeapBase::sweeperMain, this);
+		} catch(const std::system_error&) {
+			// Sweeping stays on the threads that allocate
+		}
+	} else if(!enable && mSweeper.joinable()) {
+		this->stopSweeper(lock);
+		if(!mLazySweep) {
+			this->rebuildFreeList();
+			this->ensureNursery();
+		}
+	}
+}
+
+void HeapBase::sweeperMain() noexcept {
+	std::unique_lock<std::recursive_mutex> lock{mMutex};
+	while(true) {
+		mSweepWork.wait(lock, [this] { return mSweeperExit || mSweepCursor < mHeapEnd; });
+		if(mSweeperExit) {
+			return;
+		}
+		
+		const auto cursor = reinterpret_cast<byte*>(mSweepCursor);
+		const auto end = reinterpret_cast<byte*>(mHeapEnd);
+		this->sweep(SIZE_MAX, reinterpret_cast<Block*>(
+				static_cast<std::size_t>(end - cursor) > SweepChunkSize ? cursor + SweepChunkSize : end));
+		if(mSweepCursor == mHeapEnd) {
+			this->ensureNursery();
+		}
+		
+		// Let allocating threads take the lock between chunks
+		lock.unlock();
+		std::this_thread::yield();
+		lock.lock();
+	} // while(true)
+}
+
+void HeapBase::stopSweeper(std::unique_lock<std::recursive_mutex> &lock) noexcept {
+	if(!mSweeper.joinable()) {
+		return;
+	}
+	
+	mSweeperExit = true;
+	mSweepWork.notify_one();
+	auto sweeper = std::move(mSweeper);
+	lock.unlock();
+	sweeper.join();
+	lock.lock();
+}
+
+} // namespace ssw
@@ -0,0 +1,306 @@
+/**
+ * @file    Tlab.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the thread-local allocation buffer functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "HeapBlock.hpp"
+
+namespace ssw {
+
+namespace {
+
+/** The type of the blocks that fill the space of allocation buffers which is not used by objects. */
+struct FillerBlock {};
+
+constexpr StaticTypeDescriptor<FillerBlock> fillerBlockType{"FillerBlock"};
+
+/**
+ * Get the type descriptor for filler blocks.
+ */
+const TypeDescriptor& fillerType() {
+	return fillerBlockType;
+}
+
+} // namespace
+
+/**
+ * A thread-local allocation buffer (TLAB): a chunk of the heap owned by a single thread.
+ * 
+ * A buffer starts with a filler block (the guard) that is never changed by the owning thread, so other
+ * threads may update its boundary tag. The unused space at the end of the buffer is kept as a single used
+ * filler block, from which the owning thread splits objects off without locking. Since filler blocks are
+ * used, the unused space is never coalesced with free neighbors of the buffer.
+ */
+struct HeapBase::Tlab
+{
+	/** The heap, or `nullptr` once the heap was destroyed. */
+	std::atomic<HeapBase*> heap;
+	/** The guard block at the start of the buffer, or `nullptr` if the thread has no buffer. */
+	Block *start;
+	/** The filler block holding the unused space of the buffer, or `nullptr` if there is none. */
+	Block *cur;
+	/** The end of the buffer. */
+	Block *end;
+	/** Objects in the buffer that were deallocated, linked through their first word. */
+	Block *deferred;
+	/** Set while the owning thread is bump allocating. */
+	std::atomic<bool> busy;
+	/** The number of objects allocated from the buffer, which are added to the heap statistics on retirement. */
+	std::atomic<std::size_t> numObjects;
+	/** The net size of the objects allocated from the buffer. */
+	std::atomic<std::size_t> objectSize;
+	/** The allocation profile counters of the types the thread allocated, only used by the owning thread. */
+	std::unordered_map<const TypeDescriptor*, TypeCounters*> typeCounters;
+	/** The number of bytes the thread may allocate from buffers until the next sample is taken. */
+	std::size_t sampleCountdown;
+	
+	explicit Tlab(HeapBase &heap) noexcept
+			: heap(&heap), start(nullptr), cur(nullptr), end(nullptr), deferred(nullptr), busy(false),
+			  numObjects(0), objectSize(0), typeCounters(), sampleCountdown(0) {
+	}
+	
+	// Called when the owning thread exits
+	~Tlab() {
+		std::lock_guard<std::mutex> recordLock{threadRecordMutex()};
+		if(const auto owner = heap.load(std::memory_order_relaxed)) {
+			std::lock_guard<std::recursive_mutex> lock{owner->mMutex};
+			owner->retireTlab(*this);
+			owner->mTlabs.erase(std::remove(owner->mTlabs.begin(), owner->mTlabs.end(), this),
+					owner->mTlabs.end());
+		}
+	}
+};
+
+void HeapBase::tlabSize(std::size_t size) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	this->stopTlabs();
+	// A buffer needs space for the guard, the filler, and at least one object
+	mTlabSize.store(size ? align(size < 8 * Align ? 8 * Align : size) : 0, std::memory_order_relaxed);
+	this->resumeTlabs();
+}
+
+HeapBase::Tlab& HeapBase::tlab() noexcept {
+	thread_local std::vector<std::unique_ptr<Tlab>> tlabs;
+	for(auto &tlab : tlabs) {
+		if(tlab->heap.load(std::memory_order_relaxed) == this) {
+			return *tlab;
+		}
+	}
+	
+	// Drop the buffers of destroyed heaps
+	tlabs.erase(std::remove_if(tlabs.begin(), tlabs.end(), [](const auto &tlab) {
+		return !tlab->heap.load(std::memory_order_relaxed);
+	}), tlabs.end());
+	tlabs.emplace_back(new Tlab(*this));
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mTlabs.push_back(tlabs.back().get());
+	return *tlabs.back();
+}
+
+void* HeapBase::allocateFromTlab(const TypeDescriptor &type) noexcept {
+	Tlab &tlab = this->tlab();
+	TypeCounters *counters = nullptr;
+	if(mProfiling.load(std::memory_order_relaxed) && !(counters = this->tlabTypeCounters(tlab, type))) {
+		// The allocation profile is out of memory, the slow path leaves the object out of it
+		return nullptr;
+	}
+	void *result = nullptr;
+	std::uint64_t samples = 0;
+	
+	// Handshake with stopTlabs(): either it sees this thread busy and waits, or this thread sees the stop
+	tlab.busy.store(true);
+	if(!mTlabsStopped.load()) {
+		result = bumpAllocate(tlab, type);
+	}
+	// Objects are counted before a collection can free them or count them as survivors
+	if(result && counters) {
+		samples = this->profileTlabAllocation(tlab, *counters, type);
+	}
+	tlab.busy.store(false, std::memory_order_release);
+	if(samples) {
+		this->recordTlabSamples(type, samples);
+	}
+	return result;
+}
+
+HeapBase::TypeCounters* HeapBase::tlabTypeCounters(Tlab &tlab, const TypeDescriptor &type) noexcept {
+	const auto cached = tlab.typeCounters.find(&type);
+	if(cached != tlab.typeCounters.end()) {
+		return cached->second;
+	}
+	try {
+		std::lock_guard<std::recursive_mutex> lock{mMutex};
+		TypeCounters *counters = &this->typeCounters(type);
+		tlab.typeCounters.emplace(&type, counters);
+		return counters;
+	} catch(const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+std::uint64_t HeapBase::profileTlabAllocation(Tlab &tlab, TypeCounters &counters,
+		const TypeDescriptor &type) noexcept {
+	counters.allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.bytes.fetch_add(type.size(), std::memory_order_relaxed);
+	counters.liveObjects.fetch_add(1, std::memory_order_relaxed);
+	
+	const auto interval = mSampleInterval.load(std::memory_order_relaxed);
+	return interval ? countSamples(tlab.sampleCountdown, interval, type.size()) : 0;
+}
+
+void HeapBase::recordTlabSamples(const TypeDescriptor &type, std::uint64_t samples) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	try {
+		this->recordSamples(type, type.size(), samples);
+	} catch(const std::bad_alloc&) {
+	}
+}
+
+void* HeapBase::bumpAllocate(Tlab &tlab, const TypeDescriptor &type) noexcept {
+	const auto size = align(type.size());
+	Block *blk = tlab.cur;
+	if(!blk || blk->size() < size) {
+		return nullptr;
+	}
+	
+	if(blk->size() >= size + Align + MinBlockSize) {
+		// Split off the object, the rest stays a filler block
+		Block *rest = new(blk->data() + size) Block(blk->size() - size - Align);
+		rest->type(blk->type());
+		tlab.heap.load(std::memory_order_relaxed)->setBlockStart(rest);
+		blk->size(size);
+		tlab.cur = rest;
+	} else {
+		// The object takes up the remaining space
+		tlab.cur = nullptr;
+	}
+	blk->type(type);
+	// Only the owning thread writes the counters, other threads may read them with the heap lock held
+	tlab.numObjects.store(tlab.numObjects.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	tlab.objectSize.store(tlab.objectSize.load(std::memory_order_relaxed) + type.size(), std::memory_order_relaxed);
+	return blk->data();
+}
+
+void* HeapBase::refillTlab(const TypeDescriptor &type) noexcept {
+	const auto tlabSize = mTlabSize.load(std::memory_order_relaxed);
+	if(!tlabSize || mTlabStops || align(type.size()) > tlabSize / 4) {
+		return nullptr;
+	}
+	
+	Tlab &tlab = this->tlab();
+	this->retireTlab(tlab);
+	
+	// Buffers are only taken from swept memory, so lazy sweeping never runs into them
+	const auto size = tlabSize - Align;
+	Block *chunk = nullptr;
+	if(mSweepCursor < mHeapEnd && (chunk = this->sweep(size))) {
+		this->removeFreeBlock(chunk);
+	}
+	if(!chunk && mSweepCursor == mHeapEnd) {
+		chunk = this->findFreeBlock(size);
+	}
+	if(!chunk) {
+		return nullptr;
+	}
+	
+	if(auto rest = chunk->split(size)) {
+		this->setBlockStart(rest);
+		this->addFreeBlock(rest);
+	}
+	this->touchBlock(chunk);
+	Block *space = chunk->split(Align);
+	assert(space);
+	this->setBlockStart(space);
+	chunk->type(fillerType());
+	space->type(fillerType());
+	this->prevFree(space->following(), false);
+	
+	tlab.start = chunk;
+	tlab.cur = space;
+	tlab.end = space->following();
+	return bumpAllocate(tlab, type);
+}
+
+void HeapBase::retireTlab(Tlab &tlab) noexcept {
+	if(!tlab.start) {
+		return;
+	}
+	
+	mStats.numObjects += tlab.numObjects.exchange(0, std::memory_order_relaxed);
+	const auto objectSize = tlab.objectSize.exchange(0, std::memory_order_relaxed);
+	mStats.objectSize += objectSize;
+	mAllocatedSize += objectSize;
+	while(tlab.deferred) {
+		Block *blk = std::exchange(tlab.deferred, *reinterpret_cast<Block**>(tlab.deferred->data()));
+		this->freeBlock(blk);
+	}
+	if(tlab.cur) {
+		this->freeBlock(tlab.cur);
+	}
+	this->freeBlock(tlab.start);
+	tlab.start = tlab.cur = tlab.end = nullptr;
+}
+
+void HeapBase::stopTlabs() noexcept {
+	if(mTlabStops++ == 0) {
+		mTlabsStopped.store(true);
+		for(auto tlab : mTlabs) {
+			while(tlab->busy.load()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+	for(auto tlab : mTlabs) {
+		this->retireTlab(*tlab);
+	}
+}
+
+void HeapBase::resumeTlabs() noexcept {
+	assert(mTlabStops > 0);
+	if(--mTlabStops == 0) {
+		mTlabsStopped.store(false);
+	}
+}
+
+void HeapBase::detachTlabs() noexcept {
+	std::lock_guard<std::mutex> recordLock{threadRecordMutex()};
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	for(auto tlab : mTlabs) {
+		tlab->heap.store(nullptr, std::memory_order_relaxed);
+	}
+	mTlabs.clear();
+}
+
+void HeapBase::countTlabObjects(HeapStats &stats) noexcept {
+	for(auto tlab : mTlabs) {
+		stats.numObjects += tlab->numObjects.load(std::memory_order_relaxed);
+		stats.objectSize += tlab->objectSize.load(std::memory_order_relaxed);
+	}
+}
+
+bool HeapBase::deferFree(Block *blk) noexcept {
+	for(auto tlab : mTlabs) {
+		if(tlab->start < blk && blk < tlab->end) {
+			*reinterpret_cast<Block**>(blk->data()) = std::exchange(tlab->deferred, blk);
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace ssw
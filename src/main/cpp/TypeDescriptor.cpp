@@ -9,37 +9,54 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <mutex>
+#include <new>
 #include <type_traits>
-#include <utility>
 
 namespace ssw {
 
 // XXX Is that really necessary?
 static_assert(std::is_standard_layout<TypeDescriptor>::value, "TypeDescriptor must be standard-layout.");
 
-namespace {
-
-/** The offset of the list of pointer offsets from the beginning of a TypeDescriptor. */
-constexpr std::size_t ListOffset =
-		(sizeof(TypeDescriptor) + alignof(std::ptrdiff_t) - 1) & ~(alignof(std::ptrdiff_t) - 1);
-
-} // namespace
-
-void* TypeDescriptor::operator new(std::size_t size, std::size_t offsets, AllocTag) {
-	assert(size <= ListOffset);
-	return ::operator new(ListOffset + sizeof(std::ptrdiff_t) * (offsets + 1));
+TypeDescriptor* TypeDescriptor::create(const std::string &name, std::size_t size, Destructor destructor,
+		std::initializer_list<std::ptrdiff_t> offsets) {
+	// The name is placed after the end sentinel of the pointer offsets
+	const auto nameOffset = listOffset() + sizeof(std::ptrdiff_t) * (offsets.size() + 1);
+	const auto mem = static_cast<char*>(::operator new(nameOffset + name.size() + 1));
+	std::copy(name.begin(), name.end(), mem + nameOffset);
+	mem[nameOffset + name.size()] = '\0';
+	
+	const auto result = new(mem) TypeDescriptor(mem + nameOffset, size, destructor, offsets.size());
+	std::copy(offsets.begin(), offsets.end(), const_cast<std::ptrdiff_t*>(result->begin()));
+	*const_cast<std::ptrdiff_t*>(result->end()) =
+			reinterpret_cast<const char*>(result) - reinterpret_cast<const char*>(result->end());
+	return result;
 }
 
-TypeDescriptor::TypeDescriptor(std::string name, std::size_t size, Destructor destructor,
-		std::initializer_list<std::ptrdiff_t> offsets)
-		: mName(std::move(name)), mSize(size), mDestructor(destructor), mOffsets(offsets.size()) {
-	std::copy(offsets.begin(), offsets.end(), const_cast<std::ptrdiff_t*>(this->begin()));
-	*const_cast<std::ptrdiff_t*>(this->end()) =
-			reinterpret_cast<const char*>(this) - reinterpret_cast<const char*>(this->end());
+const std::ptrdiff_t* TypeDescriptor::begin() const noexcept {
+	return reinterpret_cast<const std::ptrdiff_t*>(reinterpret_cast<const char*>(this) + listOffset());
 }
 
-const std::ptrdiff_t* TypeDescriptor::begin() const noexcept {
-	return reinterpret_cast<const std::ptrdiff_t*>(reinterpret_cast<const char*>(this) + ListOffset);
+#if SSW_COMPACT_HEADERS
+const TypeDescriptor* TypeDescriptor::sTypes[MaxIndex + 1] = {};
+
+std::uint32_t TypeDescriptor::registerIndex() const noexcept {
+	static std::mutex mutex;
+	static std::uint32_t count = 0;
+	
+	std::lock_guard<std::mutex> lock{mutex};
+	if(const auto index = mIndex.load(std::memory_order_relaxed)) {
+		return index;
+	}
+	// Objects of this type could not be recorded in a block header
+	if(count == MaxIndex || mOffsets > MaxOffsets) {
+		std::abort();
+	}
+	sTypes[++count] = this;
+	mIndex.store(count, std::memory_order_release);
+	return count;
 }
+#endif
 
 } // namespace ssw
@@ -0,0 +1,113 @@
+/**
+ * @file    VirtualMemory.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the {@link VirtualMemory} class.
+ */
+
+#include "VirtualMemory.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cstdio>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ssw {
+
+std::size_t VirtualMemory::pageSize() noexcept {
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+#else
+	return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void* VirtualMemory::map(std::size_t size) noexcept {
+#if defined(_WIN32)
+	return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	void *result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return result == MAP_FAILED ? nullptr : result;
+#endif
+}
+
+void VirtualMemory::unmap(void *ptr, std::size_t size) noexcept {
+#if defined(_WIN32)
+	static_cast<void>(size);
+	VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+	munmap(ptr, size);
+#endif
+}
+
+void* VirtualMemory::reserve(std::size_t size) noexcept {
+#if defined(_WIN32)
+	return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+	void *result = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return result == MAP_FAILED ? nullptr : result;
+#endif
+}
+
+bool VirtualMemory::commit(void *ptr, std::size_t size) noexcept {
+#if defined(_WIN32)
+	return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+	return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void VirtualMemory::decommit(void *ptr, std::size_t size) noexcept {
+#if defined(_WIN32)
+	VirtualFree(ptr, size, MEM_DECOMMIT);
+#else
+	// Replacing the pages with a fresh inaccessible mapping drops their contents
+	mmap(ptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+#endif
+}
+
+void VirtualMemory::discard(void *ptr, std::size_t size) noexcept {
+#if defined(_WIN32)
+	// Resetting only marks the pages as unused, unlocking them also removes them from the working set
+	VirtualAlloc(ptr, size, MEM_RESET, PAGE_READWRITE);
+	VirtualUnlock(ptr, size);
+#else
+	// MADV_FREE would keep the pages resident until there is memory pressure, so they would still count
+	madvise(ptr, size, MADV_DONTNEED);
+#endif
+}
+
+std::size_t VirtualMemory::hugePageSize() noexcept {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	static const std::size_t size = [] {
+		unsigned long long result = 0;
+		if(auto file = std::fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r")) {
+			if(std::fscanf(file, "%llu", &result) != 1) {
+				result = 0;
+			}
+			std::fclose(file);
+		}
+		return static_cast<std::size_t>(result);
+	}();
+	return size;
+#else
+	return 0;
+#endif
+}
+
+void VirtualMemory::hugePages(void *ptr, std::size_t size, bool enable) noexcept {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	madvise(ptr, size, enable ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+#else
+	static_cast<void>(ptr);
+	static_cast<void>(size);
+	static_cast<void>(enable);
+#endif
+}
+
+} // namespace ssw
@@ -0,0 +1,105 @@
+/**
+ * @file    VirtualMemory.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Declares the {@link VirtualMemory} class, which is private to the heap implementation.
+ */
+
+#ifndef VIRTUALMEMORY_HPP_
+#define VIRTUALMEMORY_HPP_
+#pragma once
+
+#include <cstddef>
+
+namespace ssw {
+
+/**
+ * Maps and unmaps memory directly from the operating system, bypassing the C++ free store.
+ */
+class VirtualMemory
+{
+public:
+	
+	VirtualMemory() = delete;
+	
+	/**
+	 * Get the page size of the operating system.
+	 * 
+	 * @return The granularity of mappings in bytes.
+	 */
+	static std::size_t pageSize() noexcept;
+	
+	/**
+	 * Map zero-initialized memory that can be read and written.
+	 * 
+	 * @param size The size of the mapping, must be a multiple of the page size.
+	 * @return Pointer to the page-aligned mapping, or `nullptr` if the memory could not be mapped.
+	 */
+	static void* map(std::size_t size) noexcept;
+	
+	/**
+	 * Unmap memory, returning it to the operating system.
+	 * 
+	 * @param ptr Pointer to the mapping, as returned by {@link map}.
+	 * @param size The size of the mapping, as passed to {@link map}.
+	 */
+	static void unmap(void *ptr, std::size_t size) noexcept;
+	
+	/**
+	 * Reserve address space without committing any memory, which must be committed before it is accessed.
+	 * 
+	 * @param size The size of the reservation, must be a multiple of the page size.
+	 * @return Pointer to the page-aligned reservation, or `nullptr` if the address space could not be
+	 *         reserved. The reservation is released with {@link unmap}.
+	 */
+	static void* reserve(std::size_t size) noexcept;
+	
+	/**
+	 * Commit part of a reservation, making it zero-initialized memory that can be read and written.
+	 * 
+	 * @param ptr Pointer to the memory to commit, must be page-aligned.
+	 * @param size The size of the memory to commit, must be a multiple of the page size.
+	 * @return `true` if the memory was committed, `false` otherwise.
+	 */
+	static bool commit(void *ptr, std::size_t size) noexcept;
+	
+	/**
+	 * Decommit part of a reservation, returning the memory to the operating system but keeping the address
+	 * space reserved.
+	 * 
+	 * @param ptr Pointer to the memory to decommit, must be page-aligned.
+	 * @param size The size of the memory to decommit, must be a multiple of the page size.
+	 */
+	static void decommit(void *ptr, std::size_t size) noexcept;
+	
+	/**
+	 * Return the physical memory of committed pages to the operating system while keeping them committed.
+	 * Their contents are lost, the pages read as zero and are backed by memory again when they are touched.
+	 * 
+	 * @param ptr Pointer to the memory to discard, must be page-aligned.
+	 * @param size The size of the memory to discard, must be a multiple of the page size.
+	 */
+	static void discard(void *ptr, std::size_t size) noexcept;
+	
+	/**
+	 * Get the size of transparent huge pages.
+	 * 
+	 * @return The size of a huge page in bytes, or `0` if the operating system does not support transparent
+	 *         huge pages.
+	 */
+	static std::size_t hugePageSize() noexcept;
+	
+	/**
+	 * Ask the operating system to back memory with transparent huge pages where possible, or not to. Has no
+	 * effect if transparent huge pages are not supported.
+	 * 
+	 * @param ptr Pointer to the memory, must be page-aligned.
+	 * @param size The size of the memory, must be a multiple of the page size.
+	 * @param enable `true` to prefer huge pages, `false` to avoid them.
+	 */
+	static void hugePages(void *ptr, std::size_t size, bool enable) noexcept;
+}; // class VirtualMemory
+
+} // namespace ssw
+
+#endif /* VIRTUALMEMORY_HPP_ */
@@ -0,0 +1,88 @@
+/**
+ * @file    WeakRefs.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the weak reference functions of {@link HeapBase}.
+ */
+
+#include "Heap.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+#include <vector>
+
+#include "HeapBlock.hpp"
+
+namespace ssw {
+
+std::size_t HeapBase::addWeakRef(void *object) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	if(mFreeWeakRefs.empty()) {
+		mWeakRefs.push_back(static_cast<byte*>(object));
+		return mWeakRefs.size() - 1;
+	}
+	
+	const auto handle = mFreeWeakRefs.back();
+	mFreeWeakRefs.pop_back();
+	mWeakRefs[handle] = static_cast<byte*>(object);
+	return handle;
+}
+
+void HeapBase::removeWeakRef(std::size_t handle) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	assert(handle < mWeakRefs.size());
+	mWeakRefs[handle] = nullptr;
+	mFreeWeakRefs.push_back(handle);
+}
+
+void HeapBase::addWeakTable(WeakTable &table) {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mWeakTables.push_back(&table);
+}
+
+void HeapBase::removeWeakTable(WeakTable &table) noexcept {
+	std::lock_guard<std::recursive_mutex> lock{mMutex};
+	mWeakTables.erase(std::remove(mWeakTables.begin(), mWeakTables.end(), &table), mWeakTables.end());
+}
+
+bool HeapBase::clearWeakRefs() noexcept {
+	bool cleared = false;
+	for(auto &ref : mWeakRefs) {
+		if(ref && !this->inNursery(ref) && !this->marked(&block(ref))) {
+			ref = nullptr;
+			cleared = true;
+		}
+	}
+	return cleared;
+}
+
+bool HeapBase::updateYoungWeakRefs() noexcept {
+	bool changed = false;
+	for(auto &ref : mWeakRefs) {
+		if(!ref || !this->inNursery(ref)) {
+			continue;
+		}
+		
+		Block &blk = block(ref);
+		if(blk.free()) {
+			// Promoted, or deallocated if there is no forwardee
+			ref = blk.forwardee() ? blk.forwardee()->data() : nullptr;
+			changed = true;
+		} else if(!blk.mark()) {
+			// Neither promoted nor retained, so unreachable
+			ref = nullptr;
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+void HeapBase::notifyWeakTables() noexcept {
+	// Tables may be removed by the values of entries they drop
+	for(std::size_t i = 0; i < mWeakTables.size(); i++) {
+		mWeakTables[i]->weakRefsUpdated();
+	}
+}
+
+} // namespace ssw
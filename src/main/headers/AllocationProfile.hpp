@@ -0,0 +1,98 @@
+/**
+ * @file    AllocationProfile.hpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the {@link AllocationProfile} returned by {@link HeapBase::allocationProfile}.
+ */
+
+#ifndef ALLOCATIONPROFILE_HPP_
+#define ALLOCATIONPROFILE_HPP_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "TypeDescriptor.hpp"
+
+namespace ssw {
+
+/**
+ * The allocations of a heap per type and per sampled allocation site, collected while allocation profiling
+ * is enabled (see {@link HeapBase::profileAllocations}).
+ */
+struct AllocationProfile
+{
+	/**
+	 * The counters of a single type. Managed arrays are counted as one allocation of their element type.
+	 */
+	struct Type {
+		/** The type descriptor. */
+		const TypeDescriptor *type;
+		/** The number of allocated objects. */
+		std::uint64_t allocations;
+		/** The net size of the allocated objects. */
+		std::uint64_t bytes;
+		/** The number of allocated objects that have not been destroyed or deallocated yet. */
+		std::uint64_t liveObjects;
+		/** The number of objects that survived the last completed collection. */
+		std::uint64_t survivors;
+		/** The sum of the survivors of all completed collections. */
+		std::uint64_t survivals;
+		
+		/**
+		 * Get the average lifetime of the allocated objects, i.e. the average number of collections they
+		 * survived. Objects that are still alive count with the collections they survived so far.
+		 */
+		double averageLifetime() const noexcept {
+			return allocations ? static_cast<double>(survivals) / allocations : 0;
+		}
+	};
+	
+	/**
+	 * The sampled allocations of a type from a single call stack.
+	 */
+	struct Site {
+		/** The type descriptor of the sampled objects. */
+		const TypeDescriptor *type;
+		/** The return addresses of the call stack, innermost first, empty if they cannot be captured. */
+		std::vector<void*> frames;
+		/** The number of samples taken. */
+		std::uint64_t samples;
+		/** The net size of the sampled objects. */
+		std::uint64_t bytes;
+		
+		/**
+		 * Get an estimate of the total size allocated from this site: every sample stands for one sampling
+		 * interval of allocated bytes.
+		 * 
+		 * @param sampleInterval The sampling interval the samples were taken with.
+		 */
+		std::uint64_t estimatedBytes(std::size_t sampleInterval) const noexcept {
+			return samples * sampleInterval;
+		}
+	};
+	
+	/** The number of collections completed while profiling. */
+	std::uint64_t collections;
+	/** The number of allocated bytes between samples, `0` if sampling is disabled. */
+	std::size_t sampleInterval;
+	/** The counters of all types allocated while profiling, by decreasing number of bytes. */
+	std::vector<Type> types;
+	/** The sampled allocation sites, by decreasing number of samples. */
+	std::vector<Site> sites;
+	
+	/**
+	 * Write a human-readable summary of this profile to the specified stream: a table of all types, followed
+	 * by the allocation sites with their return addresses.
+	 * 
+	 * @param os The output stream to write to.
+	 * @param maxSites (optional) The maximum number of allocation sites to write.
+	 */
+	void write(std::ostream &os, std::size_t maxSites = 20) const;
+}; // struct AllocationProfile
+
+} // namespace ssw
+
+#endif /* ALLOCATIONPROFILE_HPP_ */
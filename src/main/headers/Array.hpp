@@ -0,0 +1,114 @@
+/**
+ * @file    Array.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the {@link Array} class.
+ */
+
+#ifndef ARRAY_HPP_
+#define ARRAY_HPP_
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+#include "Heap.hpp"
+
+namespace ssw {
+
+/**
+ * A managed array of a fixed number of elements, allocated as a single object (see
+ * {@link HeapBase::allocateArray}).
+ * 
+ * The elements are traced with the type descriptor of `T`, so pointer fields of the elements keep their
+ * targets alive, and their destructors are called when the array is garbage collected. Arrays are only
+ * referenced by pointer, they cannot be constructed, copied or deleted.
+ * 
+ * @tparam T The type of the elements, must have a member type `HeapType` (see {@link HeapObject}) and a
+ *           static type descriptor `type`.
+ */
+template <typename T>
+class Array
+{
+	static_assert(alignof(T) <= HeapBase::Align, "Array elements must not be over-aligned for the heap.");
+	
+	HeapBase::ArrayHeader mHeader;
+	
+	Array() = delete;
+	Array(const Array&) = delete;
+	~Array() = delete;
+	
+public:
+	
+	/** The heap arrays of this type are allocated from, so arrays can be referenced by members and locals. */
+	using HeapType = typename T::HeapType;
+	
+	/**
+	 * Allocate an array with the specified number of default-constructed elements.
+	 * 
+	 * @param length The number of elements.
+	 * @return A pointer to the new array.
+	 * @throws std::bad_alloc If the array could not be allocated.
+	 */
+	static Array* make(std::size_t length) {
+		void *mem = T::HeapType::instance().allocateArray(T::type, length);
+		if(!mem) {
+			throw std::bad_alloc();
+		}
+		
+		auto result = static_cast<Array*>(mem);
+		for(std::size_t i = 0; i < length; i++) {
+			::new(result->data() + i) T();
+		}
+		return result;
+	}
+	
+	/**
+	 * Get the number of elements.
+	 */
+	std::size_t length() const noexcept {
+		return mHeader.length;
+	}
+	
+	/**
+	 * Get a pointer to the first element.
+	 */
+	T* data() noexcept {
+		return reinterpret_cast<T*>(reinterpret_cast<byte*>(this) + HeapBase::ArrayElementsOffset);
+	}
+	
+	const T* data() const noexcept {
+		return reinterpret_cast<const T*>(reinterpret_cast<const byte*>(this) + HeapBase::ArrayElementsOffset);
+	}
+	
+	T& operator[](std::size_t index) noexcept {
+		assert(index < this->length());
+		return this->data()[index];
+	}
+	
+	const T& operator[](std::size_t index) const noexcept {
+		assert(index < this->length());
+		return this->data()[index];
+	}
+	
+	T* begin() noexcept {
+		return this->data();
+	}
+	
+	const T* begin() const noexcept {
+		return this->data();
+	}
+	
+	T* end() noexcept {
+		return this->data() + this->length();
+	}
+	
+	const T* end() const noexcept {
+		return this->data() + this->length();
+	}
+}; // class Array
+
+} // namespace ssw
+
+#endif /* ARRAY_HPP_ */
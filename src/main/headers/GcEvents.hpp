@@ -0,0 +1,198 @@
+/**
+ * @file    GcEvents.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the types for observing garbage collection events of a {@link HeapBase}.
+ */
+
+#ifndef GCEVENTS_HPP_
+#define GCEVENTS_HPP_
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Whether the heap records garbage collection events. Define as `1` when building the library to get
+ * events, otherwise measuring phases compiles away and listeners and pause histograms stay unused.
+ */
+#ifndef SSW_GC_EVENTS
+#define SSW_GC_EVENTS 0
+#endif
+
+namespace ssw {
+
+/**
+ * The phases of garbage collection that are reported as events. Pauses are the phases that run when a
+ * collection is requested, the others are part of pauses or allocation.
+ */
+enum class GcPhase {
+	/** A full collection (pause), see {@link HeapBase::gc}. */
+	Collection,
+	/** A step of an incremental collection cycle (pause), see {@link HeapBase::gcStep}. */
+	IncrementalStep,
+	/** A minor collection (pause), see {@link HeapBase::minorGc}. */
+	MinorCollection,
+	/** A compacting collection (pause), see {@link HeapBase::compact}. */
+	Compaction,
+	/** Marking all objects reachable from the roots. */
+	Mark,
+	/** Sweeping the heap at the end of a collection. */
+	Sweep,
+	/** Merging adjacent free blocks because an allocation found no block that is large enough. */
+	Merge,
+};
+
+/**
+ * Get the name of the specified phase.
+ */
+const char* gcPhaseName(GcPhase phase) noexcept;
+
+/**
+ * Get whether the specified phase is a pause, i.e. not part of another phase.
+ */
+constexpr bool gcPhaseIsPause(GcPhase phase) noexcept {
+	return phase == GcPhase::Collection || phase == GcPhase::IncrementalStep
+			|| phase == GcPhase::MinorCollection || phase == GcPhase::Compaction;
+}
+
+/**
+ * A completed phase of garbage collection.
+ */
+struct GcEvent {
+	/** The phase that was completed. */
+	GcPhase phase;
+	/** The time the phase started. */
+	std::chrono::steady_clock::time_point start;
+	/** The time the phase took. */
+	std::chrono::steady_clock::duration duration;
+	/** The net size of the objects that were destroyed during the phase. */
+	std::size_t reclaimed;
+};
+
+/**
+ * Receives garbage collection events of a heap (see {@link HeapBase::gcListener}).
+ */
+class GcListener
+{
+public:
+	
+	virtual ~GcListener() = default;
+	
+	/**
+	 * Called when a phase is completed, with the heap lock held by the current thread. Phases that are part
+	 * of a pause are reported before the pause.
+	 * 
+	 * @param event The completed phase.
+	 */
+	virtual void gcEvent(const GcEvent &event) noexcept = 0;
+}; // class GcListener
+
+/**
+ * A histogram of pause times with power-of-two bucket sizes: bucket `0` counts pauses shorter than 2
+ * microseconds, bucket `i > 0` counts pauses of at least `2^i` and less than `2^(i+1)` microseconds, the
+ * last bucket also counts all longer pauses.
+ */
+class PauseHistogram
+{
+public:
+	
+	/** The number of buckets. */
+	static constexpr std::size_t NumBuckets = 32;
+	
+private:
+	
+	std::array<std::uint64_t, NumBuckets> mBuckets;
+	std::uint64_t mCount;
+	std::chrono::nanoseconds mTotal;
+	std::chrono::nanoseconds mMax;
+	
+public:
+	
+	PauseHistogram() noexcept : mBuckets(), mCount(0), mTotal(0), mMax(0) {
+	}
+	
+	/**
+	 * Count a pause.
+	 * 
+	 * @param duration The duration of the pause.
+	 */
+	void record(std::chrono::nanoseconds duration) noexcept;
+	
+	/**
+	 * Get the number of pauses in the specified bucket.
+	 */
+	std::uint64_t bucket(std::size_t index) const noexcept {
+		return mBuckets[index];
+	}
+	
+	/**
+	 * Get the smallest pause time counted by the specified bucket.
+	 */
+	static std::chrono::microseconds bucketStart(std::size_t index) noexcept {
+		return std::chrono::microseconds(index ? std::int64_t{1} << index : 0);
+	}
+	
+	/**
+	 * Get the number of pauses.
+	 */
+	std::uint64_t count() const noexcept {
+		return mCount;
+	}
+	
+	/**
+	 * Get the sum of all pause times.
+	 */
+	std::chrono::nanoseconds total() const noexcept {
+		return mTotal;
+	}
+	
+	/**
+	 * Get the longest pause time.
+	 */
+	std::chrono::nanoseconds max() const noexcept {
+		return mMax;
+	}
+	
+	/**
+	 * Get an upper bound for the specified percentile of pause times, which is the end of the bucket that
+	 * contains the percentile (or the longest pause if that is shorter).
+	 * 
+	 * @param percentile The percentile, between `0` and `100`.
+	 */
+	std::chrono::nanoseconds percentile(double percentile) const noexcept;
+}; // class PauseHistogram
+
+/**
+ * A listener that writes events in the Trace Event Format used by Chrome's `about:tracing` and Perfetto, as
+ * complete events in a JSON array. The array is closed when the writer is destroyed.
+ */
+class ChromeTraceWriter : public GcListener
+{
+	std::ostream &mStream;
+	const std::chrono::steady_clock::time_point mEpoch;
+	bool mFirst;
+	
+public:
+	
+	/**
+	 * Construct a new writer, timestamps are relative to the time of construction.
+	 * 
+	 * @param os The stream to write to, must outlive the writer.
+	 */
+	explicit ChromeTraceWriter(std::ostream &os);
+	
+	ChromeTraceWriter(const ChromeTraceWriter&) = delete;
+	ChromeTraceWriter& operator=(const ChromeTraceWriter&) = delete;
+	
+	~ChromeTraceWriter();
+	
+	void gcEvent(const GcEvent &event) noexcept override;
+}; // class ChromeTraceWriter
+
+} // namespace ssw
+
+#endif /* GCEVENTS_HPP_ */
@@ -10,10 +10,23 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <cstddef>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <ostream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "AllocationProfile.hpp"
+#include "GcEvents.hpp"
 #include "TaggedPointer.hpp"
 #include "TypeDescriptor.hpp"
 
@@ -24,14 +37,97 @@ using byte = unsigned char;
 class HeapBase
 {
 	class Block;
+	struct LargeObject;
 	
-	Block *mFreeList;
-	Block* const mHeapStart;
-	Block* const mHeapEnd;
-	std::vector<byte*> mRoots;
+public:
 	
-protected:
+	/**
+	 * The alignment of memory allocated from this heap, which is only 8 bytes with compact block headers (see
+	 * {@link SSW_COMPACT_HEADERS}).
+	 */
+	static constexpr std::size_t Align = TypeDescriptor::MaxAlign;
+	
+	/**
+	 * A value that is never returned as a root handle (see {@link addRoot}).
+	 */
+	static constexpr std::size_t NoRootHandle = SIZE_MAX;
+	
+	/**
+	 * An entry of a shadow stack, i.e. a root that is only registered with the heap while a scope of the
+	 * owning thread is active (see {@link Local}).
+	 */
+	struct LocalRoot {
+		/** The root object, may be `nullptr`. */
+		byte *object;
+		/** The next outer local root of the thread, or `nullptr`. */
+		LocalRoot *prev;
+	};
+	
+	/**
+	 * The shadow stack of a thread for a heap, which links the local roots of the thread from the innermost
+	 * to the outermost one. Only the owning thread pushes and pops entries, without locking.
+	 */
+	struct ShadowStack {
+		/** The heap, or `nullptr` once the heap was destroyed. */
+		std::atomic<HeapBase*> heap;
+		/** The innermost local root, or `nullptr`. */
+		LocalRoot *top;
+		
+		explicit ShadowStack(HeapBase &heap) noexcept
+				: heap(&heap), top(nullptr) {
+		}
+		
+		// Called when the owning thread exits
+		~ShadowStack();
+	};
+	
+	/**
+	 * A table keyed by weak references (see {@link addWeakRef}), which is notified when garbage collection has
+	 * cleared or moved weakly referenced objects so it can drop or rehash its entries.
+	 * 
+	 * @see WeakMap
+	 */
+	class WeakTable
+	{
+	public:
+		
+		virtual ~WeakTable() = default;
+		
+		/**
+		 * Called with the heap lock held after garbage collection cleared or updated weak references. Must
+		 * not allocate from the heap or run garbage collection.
+		 */
+		virtual void weakRefsUpdated() noexcept = 0;
+		
+	protected:
+		
+		/**
+		 * Get the lock of the specified heap, which tables hold while accessing their entries.
+		 */
+		static std::recursive_mutex& mutex(HeapBase &heap) noexcept {
+			return heap.mMutex;
+		}
+	};
+	
+	/**
+	 * The header of a managed array (see {@link allocateArray}), which is followed by the elements at
+	 * {@link ArrayElementsOffset}.
+	 */
+	struct ArrayHeader {
+		/** The number of elements. */
+		std::size_t length;
+		/** The offset of the element that is being traced, only used while marking. */
+		std::size_t scanOffset;
+	};
 	
+	/**
+	 * The offset of the first element of a managed array from the start of the array.
+	 */
+	static constexpr std::size_t ArrayElementsOffset = (sizeof(ArrayHeader) + Align - 1) & ~(Align - 1);
+	
+	/**
+	 * Statistics about the objects and the free space of a heap.
+	 */
 	struct HeapStats {
 		/** Total size of the heap in bytes. */
 		std::size_t heapSize;
@@ -55,13 +151,328 @@ protected:
 		std::size_t liveObjectSize;
 	};
 	
+	/**
+	 * The settings for running garbage collection automatically during allocation (see {@link gcPolicy}).
+	 * 
+	 * Automatic collections run inside of allocations, so while any of them is enabled, every pointer to a
+	 * managed object that is used across an allocation must be reachable from a heap root (for example with
+	 * {@link Local} or {@link Root}), including pointers to objects that are being constructed.
+	 * 
+	 * Collections do not stop other threads at a safepoint (see {@link tlabSize}), so while allocation
+	 * buffers are enabled and more than one thread has allocated from this heap, allocations never collect
+	 * automatically: they grow the heap or fail instead. Programs that allocate from several threads without
+	 * allocation buffers must make sure themselves that the other threads are stopped.
+	 */
+	struct GcPolicy {
+		/**
+		 * Whether an allocation that finds no free block runs a full collection before growing the heap. An
+		 * incremental cycle in progress is completed first, and another collection runs if that is not enough.
+		 */
+		bool collectOnFailure = false;
+		/** Whether an allocation runs a full collection once the allocation budget is spent. */
+		bool collectOnBudget = false;
+		/** Whether an allocation that finds no free block grows the storage of a growable heap. */
+		bool growOnFailure = true;
+		/** The allocation budget before the first collection, and the smallest budget, in bytes. */
+		std::size_t minBudget = 1024 * 1024;
+		/** The largest allocation budget in bytes. */
+		std::size_t maxBudget = SIZE_MAX;
+		/**
+		 * The survival rate the allocation budget is tuned for, between `0` and `1`. The survival rate of a
+		 * collection is the net size of the objects that survive it divided by the net size of all objects
+		 * when it started. After each collection, the next budget is chosen so that a collection that finds
+		 * the same live objects has this survival rate: a lower target makes collections less frequent and
+		 * the heap larger.
+		 */
+		double targetSurvivalRate = 0.5;
+	};
+	
+private:
+	
+	/** The smallest usable size of a block, free blocks need room for their boundary tags. */
+	static constexpr std::size_t MinBlockSize = (2 * sizeof(std::size_t) + Align - 1) & ~(Align - 1);
+	/** The number of size classes with exact block sizes (multiples of {@link Align}). */
+	static constexpr std::size_t NumExactClasses = 16;
+	/** The largest block size that has an exact size class. */
+	static constexpr std::size_t MaxExactSize = NumExactClasses * Align;
+	/** The total number of size classes (exact classes followed by power-of-two bins). */
+	static constexpr std::size_t NumSizeClasses = 64;
+	
+	/**
+	 * Segregated free lists: index `i < NumExactClasses` holds blocks of exactly `(i + 1) * Align` bytes,
+	 * all other indices hold blocks with sizes in `[2^k, 2^(k+1))` for increasing `k`.
+	 */
+	std::array<Block*, NumSizeClasses> mFreeLists;
+	Block* const mHeapStart;
+	/** The end of the old generation, which is also the start of the nursery. */
+	Block *mHeapEnd;
+	/**
+	 * Whether the last block of the old generation is free, i.e. the boundary tag a block at {@link mHeapEnd}
+	 * would have. Kept up to date by {@link prevFree}.
+	 */
+	bool mLastBlockFree;
+	/** The end of the heap storage, the nursery (if any) takes up the space from {@link mHeapEnd} to here. */
+	Block *mStorageEnd;
+	/** The end of the address space reserved for the storage, equal to {@link mStorageEnd} if it cannot grow. */
+	Block* const mStorageLimit;
+	/** The size the storage never shrinks below. */
+	const std::size_t mMinStorageSize;
+	/** The size of the reservation holding the storage and its side tables, `0` if the heap does not own it. */
+	std::size_t mReservedSize;
+	/** The heap roots, kept dense so marking does not need to skip unused entries. */
+	std::vector<byte*> mRoots;
+	/** The handle of each root in {@link mRoots}, or {@link NoRootHandle} for roots without a handle. */
+	std::vector<std::size_t> mRootHandles;
+	/** The index in {@link mRoots} of the root of each handle in use, and the next free handle otherwise. */
+	std::vector<std::size_t> mRootSlots;
+	/** The first free root handle, or {@link NoRootHandle} if there is none. */
+	std::size_t mFreeRootHandle;
+	/** The shadow stacks of all threads that created local roots for this heap. */
+	std::vector<ShadowStack*> mShadowStacks;
+	/** The object of each weak reference handle, `nullptr` for cleared references and unused handles. */
+	std::vector<byte*> mWeakRefs;
+	/** The unused weak reference handles. */
+	std::vector<std::size_t> mFreeWeakRefs;
+	/** The registered weak tables. */
+	std::vector<WeakTable*> mWeakTables;
+	
+	/** The next block to be swept, or {@link mHeapEnd} if there is nothing left to sweep. */
+	Block *mSweepCursor;
+	/** Whether sweeping is done on demand during allocation instead of at the end of `gc()`. */
+	bool mLazySweep;
+	/** The minimum size of free blocks whose pages are returned to the operating system, `0` to keep them. */
+	std::size_t mReleaseThreshold;
+	/** Whether the storage is backed by transparent huge pages. */
+	bool mHugePages;
+	/** One flag per page of the storage, set while the page is discarded. Empty if no memory is released. */
+	std::vector<bool> mReleasedPages;
+	
+	/** The background sweeper thread, not joinable if background sweeping is disabled. */
+	std::thread mSweeper;
+	/** Wakes up the sweeper thread when there is something to sweep or it should exit. */
+	std::condition_variable_any mSweepWork;
+	/** Set to make the sweeper thread exit. */
+	bool mSweeperExit;
+	/** The number of bytes the sweeper thread sweeps before it lets other threads take the heap lock. */
+	static constexpr std::size_t SweepChunkSize = 16 * 1024;
+	
+	/** Side mark bitmap with one bit per {@link Align} sized granule, or `nullptr` if not available. */
+	std::atomic<std::uintptr_t>* const mMarkBits;
+	/** The number of words in the mark bitmap, enough for the whole reserved storage. */
+	const std::size_t mMarkWords;
+	/** Whether the mark bitmap is used instead of the mark bit in block headers. */
+	bool mUseMarkBits;
+	/** The number of threads to use for marking, values less than 2 mean serial marking. */
+	unsigned mMarkThreads;
+	/** The capacity of the mark stack for serial marking, `0` for Deutsch-Schorr-Waite marking only. */
+	std::size_t mMarkStackSize;
+	/** The mark stack for serial marking, resized to {@link mMarkStackSize} when it is used. */
+	std::vector<byte*> mMarkStack;
+	/** The default value of {@link mMarkStackSize}. */
+	static constexpr std::size_t DefaultMarkStackSize = 4096;
+	
+	struct ParallelMarkState;
+	
+	/** Whether an incremental collection cycle is marking, see {@link gcStep}. */
+	std::atomic<bool> mMarking;
+	/** Marked objects whose fields have not been scanned by incremental marking yet. */
+	std::vector<byte*> mGreyObjects;
+	/** Objects deallocated during incremental marking, which are freed when marking is complete. */
+	std::vector<Block*> mDeferredFrees;
+	/** The number of grey objects each allocation scans during incremental marking. */
+	static constexpr std::size_t AllocationMarkWork = 8;
+	
+	/** Guards all heap data, except for the unused space of thread-local allocation buffers. */
+	std::recursive_mutex mMutex;
+	
+	struct Tlab;
+	
+	/** The thread-local allocation buffers of all threads that allocated from this heap. */
+	std::vector<Tlab*> mTlabs;
+	/** The size of new thread-local allocation buffers in bytes, or `0` if they are disabled. */
+	std::atomic<std::size_t> mTlabSize;
+	/** The nesting depth of {@link stopTlabs} calls. */
+	unsigned mTlabStops;
+	/** Set while allocation buffers are stopped, which makes threads fall back to locked allocation. */
+	std::atomic<bool> mTlabsStopped;
+	
+	/** The next free address in the nursery, equal to {@link mHeapEnd} if the nursery is empty. */
+	Block *mNurseryTop;
+	/** The configured size of the nursery in bytes, or `0` if the nursery is disabled. */
+	std::atomic<std::size_t> mNurserySize;
+	
+	struct PromotionState;
+	struct Relocation;
+	
+	/** Card table with one byte per `2^CardShift` bytes of storage, or `nullptr` if not available. */
+	std::atomic<std::uint8_t>* const mCards;
+	/** The number of cards in the card table, enough for the whole reserved storage. */
+	const std::size_t mNumCards;
+	/** Bitmap with one bit per {@link Align} sized granule, set for each block of the old generation. */
+	std::atomic<std::uintptr_t>* const mBlockStarts;
+	/** Whether minor collections only scan dirty cards for pointers into the nursery. */
+	bool mUseCards;
+	
+	/** The list of all objects in the large object space. */
+	LargeObject *mLargeObjects;
+	/** Objects larger than this many bytes are allocated in the large object space, `0` disables it. */
+	std::atomic<std::size_t> mLargeObjectThreshold;
+	/** The total size of the mappings of all large objects. */
+	std::size_t mLargeObjectsSize;
+	
+	/**
+	 * Running statistics returned by {@link stats}: the free list and object counts are updated whenever
+	 * they change, the live object counts when a collection is complete. The sizes of the heap and its used
+	 * and free space are not kept here.
+	 */
+	HeapStats mStats;
+	
+	class PhaseTimer;
+	class CollectingScope;
+	
+	/** The listener for garbage collection events, or `nullptr`. */
+	GcListener *mGcListener;
+	/** The durations of all pauses. */
+	PauseHistogram mPauseHistogram;
+	
+	/** The settings of automatic garbage collection. */
+	GcPolicy mGcPolicy;
+	/** The net size of objects to allocate until the next automatic collection. */
+	std::size_t mAllocationBudget;
+	/**
+	 * The net size of the objects allocated since the last collection started, not counting objects in
+	 * allocation buffers that have not been retired.
+	 */
+	std::size_t mAllocatedSize;
+	/** The net size of all objects when the last collection started. */
+	std::size_t mObjectSizeBeforeGc;
+	/** The survival rate of the last completed collection. */
+	double mSurvivalRate;
+	/** Set while allocated objects are not constructed yet, so they must not be collected automatically. */
+	bool mNoAutoGc;
+	/**
+	 * Set while collection code runs, so allocations from destructors or listeners do not start another
+	 * collection. Not set between the steps of an incremental cycle, see {@link CollectingScope}.
+	 */
+	bool mCollecting;
+	
+	/**
+	 * The allocation profile counters of a type. The allocation counters are also updated without the heap
+	 * lock by threads allocating from their allocation buffers, all other counters only with the heap lock.
+	 */
+	struct TypeCounters {
+		std::atomic<std::uint64_t> allocations{0};
+		std::atomic<std::uint64_t> bytes{0};
+		/** May become negative when objects allocated before profiling was enabled are destroyed. */
+		std::atomic<std::int64_t> liveObjects{0};
+		std::uint64_t survivors = 0;
+		std::uint64_t survivals = 0;
+	};
+	
+	/** The samples taken at an allocation site. */
+	struct SiteCounters {
+		std::uint64_t samples = 0;
+		std::uint64_t bytes = 0;
+	};
+	
+	/** Whether allocations are counted per type, see {@link profileAllocations}. */
+	std::atomic<bool> mProfiling;
+	/**
+	 * The counters of each type allocated while profiling. Entries are never removed, so allocation buffers
+	 * may keep pointers to them.
+	 */
+	std::unordered_map<const TypeDescriptor*, TypeCounters> mTypeCounters;
+	/** The number of collections completed while profiling. */
+	std::uint64_t mProfiledCollections;
+	/** The number of allocated bytes between samples of allocation sites, `0` if sampling is disabled. */
+	std::atomic<std::size_t> mSampleInterval;
+	/** The number of bytes left to allocate with the heap lock held until the next sample is taken. */
+	std::size_t mSampleCountdown;
+	/** The samples of each allocation site, keyed by the type and the return addresses of the call stack. */
+	std::map<std::pair<const TypeDescriptor*, std::vector<void*>>, SiteCounters> mSites;
+	
+protected:
+	
+	/** The number of mark bits in one word of a mark bitmap. */
+	static constexpr std::size_t MarkBitsPerWord = sizeof(std::uintptr_t) * CHAR_BIT;
+	/** The binary logarithm of the number of bytes covered by one card of the card table. */
+	static constexpr std::size_t CardShift = 9;
+	
+	/**
+	 * Get the number of words needed for the mark bitmap of a heap.
+	 * 
+	 * @param size Raw size of the heap storage.
+	 * @return The number of words needed for the mark bitmap.
+	 */
+	static constexpr std::size_t markBitmapWords(std::size_t size) noexcept {
+		return (size / Align + MarkBitsPerWord - 1) / MarkBitsPerWord;
+	}
+	
+	/**
+	 * Get the number of cards needed for the card table of a heap.
+	 * 
+	 * @param size Raw size of the heap storage.
+	 * @return The number of cards needed for the card table.
+	 */
+	static constexpr std::size_t cardTableSize(std::size_t size) noexcept {
+		return (size + (std::size_t{1} << CardShift) - 1) >> CardShift;
+	}
+	
 	/**
 	 * Initialize this heap with the specified storage.
 	 * 
 	 * @param storage Pointer to the storage to use for objects.
 	 * @param size Raw size of the storage.
+	 * @param markBits (optional) Storage for the side mark bitmap, which must hold at least
+	 *                 `markBitmapWords(size)` words. If `nullptr`, only marks in block headers can be used.
+	 * @param cards (optional) Storage for the card table, which must hold at least `cardTableSize(size)`
+	 *              cards. If `nullptr`, the card table cannot be enabled.
+	 * @param blockStarts (optional) Storage for the block start bitmap, which must hold at least
+	 *                    `markBitmapWords(size)` words. Required if `cards` is given.
+	 * @param maxSize (optional) If not `0`, the storage is reserved address space of this size (see
+	 *                {@link reserveStorage}) of which the first `size` bytes are committed, and the side tables
+	 *                must be large enough for `maxSize` bytes. The heap grows into the reservation as needed.
+	 *                The reservation is not released by the heap.
+	 */
+	HeapBase(byte *storage, std::size_t size, std::atomic<std::uintptr_t> *markBits = nullptr,
+			std::atomic<std::uint8_t> *cards = nullptr,
+			std::atomic<std::uintptr_t> *blockStarts = nullptr, std::size_t maxSize = 0) noexcept;
+			
+	/**
+	 * Initialize this heap with storage and side tables in a reservation of address space, which grows and
+	 * shrinks between the specified sizes. Both sizes must be multiples of the page size.
+	 * 
+	 * @param size The initial (and minimum) size of the storage.
+	 * @param maxSize The maximum size of the storage.
+	 * @throws std::bad_alloc If the address space cannot be reserved (see {@link reserveStorage}).
+	 */
+	HeapBase(std::size_t size, std::size_t maxSize);
+	
+	/**
+	 * Detach the shadow stacks and allocation buffers of all threads, stop the background sweeper thread, if
+	 * any, and unmap all large objects without destroying them.
+	 */
+	~HeapBase();
+	
+	/**
+	 * Reserve address space for heap storage and its side tables, and commit the side tables and the initial
+	 * storage. The storage is at the start of the reservation, followed by the mark bitmap, the block start
+	 * bitmap and the card table.
+	 * 
+	 * @param size The initial size of the storage, must be a multiple of the page size.
+	 * @param maxSize The maximum size of the storage, must be a multiple of the page size.
+	 * @return Pointer to the reservation, which is {@link reservationSize} bytes large.
+	 * @throws std::bad_alloc If the address space cannot be reserved, or the initial storage and the side
+	 *                        tables cannot be committed.
+	 */
+	static byte* reserveStorage(std::size_t size, std::size_t maxSize);
+	
+	/**
+	 * Get the size of the reservation for heap storage of the specified size and its side tables.
 	 */
-	HeapBase(byte *storage, std::size_t size) noexcept;
+	static constexpr std::size_t reservationSize(std::size_t maxSize) noexcept {
+		return maxSize + 2 * markBitmapWords(maxSize) * sizeof(std::uintptr_t) + cardTableSize(maxSize);
+	}
 	
 	/**
 	 * Collect statistics for this heap.
@@ -73,15 +484,25 @@ protected:
 	HeapStats collectHeapStats(bool countLiveObjects = false) noexcept;
 	
 public:
-
+	
 	/**
-	 * The alignment of memory allocated from this heap.
+	 * Get statistics for this heap that are maintained during allocation and garbage collection, which
+	 * takes constant time instead of walking the heap like {@link collectHeapStats}. The figures differ from
+	 * those of a heap walk where the heap walk has to do work first:
+	 * 
+	 * - Garbage objects count as objects (and used space) until they are swept.
+	 * - The unused space of thread-local allocation buffers counts as used.
+	 * - The live objects are those that survived the last completed collection (including objects that were
+	 *   allocated while it was marking or sweeping), they are `0` until the first collection.
 	 */
-	static constexpr std::size_t Align = alignof(std::max_align_t);
+	HeapStats stats() noexcept;
 	
 	/**
 	 * Allocate a block of memory for the specified type.
 	 * 
+	 * Depending on the policy for automatic garbage collection (see {@link gcPolicy}), this runs a collection
+	 * first once the allocation budget is spent, or when there is no free block for the object.
+	 * 
 	 * @param type Type descriptor for the memory to allocate.
 	 * @param isRoot (optional) Whether to register the allocated object as a heap root.
 	 * @return A pointer to the allocated memory block, or `nullptr` if the allocation failed.
@@ -104,6 +525,56 @@ public:
 		return reinterpret_cast<T*>(this->allocate(T::type, isRoot));
 	}
 	
+	/**
+	 * Allocate blocks of memory for a number of objects of the specified type at once. This takes the heap
+	 * lock once and carves consecutive blocks out of as few free blocks as possible, so objects allocated
+	 * together are next to each other in memory (unless they are large objects or young objects, which are
+	 * allocated one by one, but also contiguously while the nursery has space).
+	 * 
+	 * The objects are not registered as heap roots and are not allocated from the allocation buffer of the
+	 * calling thread.
+	 * 
+	 * @param type Type descriptor for the memory to allocate.
+	 * @param count The number of objects to allocate.
+	 * @param objects The array to store the pointers to the allocated memory blocks in, must have space for
+	 *                `count` pointers. Entries for objects that could not be allocated are set to `nullptr`.
+	 * @return The number of allocated objects, which are the first entries of `objects`.
+	 */
+	std::size_t allocateBatch(const TypeDescriptor &type, std::size_t count, void **objects) noexcept;
+	
+	/**
+	 * Allocate blocks of memory for a number of objects of the specified type at once.
+	 * 
+	 * @param count The number of objects to allocate.
+	 * @param objects The array to store the pointers to the newly allocated and uninitialized objects in.
+	 * @return The number of allocated objects.
+	 * @see allocateBatch(const TypeDescriptor&, std::size_t, void**)
+	 * 
+	 * @tparam The type to allocate memory for, must have a static member variable `type` that holds the
+	 *         type descriptor to use.
+	 */
+	template <typename T>
+	std::size_t allocateBatch(std::size_t count, T **objects) noexcept {
+		assert(T::type.size() >= sizeof(T));
+		return this->allocateBatch(T::type, count, reinterpret_cast<void**>(objects));
+	}
+	
+	/**
+	 * Allocate a managed array, i.e. a single object holding a fixed number of elements of the specified
+	 * type. The array starts with an {@link ArrayHeader}, the elements follow at {@link ArrayElementsOffset}
+	 * with a stride of `elementType.size()`. The pointer offsets of the element type apply to every element,
+	 * and the destructor is called for every element when the array is garbage collected.
+	 * 
+	 * Arrays are always allocated in the old generation (or the large object space). The elements are
+	 * zero-initialized, so they may be constructed after allocation.
+	 * 
+	 * @param elementType Type descriptor for the elements.
+	 * @param length The number of elements.
+	 * @return A pointer to the array, or `nullptr` if the allocation failed.
+	 * @see Array
+	 */
+	void* allocateArray(const TypeDescriptor &elementType, std::size_t length) noexcept;
+	
 	/**
 	 * Deallocate the specified object by putting it back into the free list. No destructors are called.
 	 * 
@@ -115,125 +586,1683 @@ public:
 	void deallocate(byte *obj) noexcept;
 	
 	/**
-	 * Register the specified object as a heap root for garbage collection.
+	 * Register the specified object as a heap root for garbage collection. The object may be young, but a
+	 * minor collection then moves it, and it can only be unregistered by its new address. Use root handles
+	 * (see {@link addRoot}) to root young objects.
 	 * 
 	 * @param object Pointer to the object to register.
 	 */
 	void registerRoot(void *object) {
-		mRoots.push_back(reinterpret_cast<byte*>(object));
+		std::lock_guard<std::recursive_mutex> lock{mMutex};
+		this->insertRoot(object, NoRootHandle);
 	}
 	
 	/**
-	 * Remove the specified object as a heap root, if it is registered.
+	 * Remove the specified object as a heap root, if it is registered. This takes time linear in the number
+	 * of roots, use root handles (see {@link addRoot}) for roots that come and go frequently.
+	 * 
+	 * Roots registered with a handle are not removed.
 	 * 
 	 * @param object Pointer to the object to unregister.
 	 */
 	void removeRoot(void *object) {
-		mRoots.erase(std::remove(mRoots.begin(), mRoots.end(), object), mRoots.end());
+		std::lock_guard<std::recursive_mutex> lock{mMutex};
+		for(auto i = mRoots.size(); i-- > 0;) {
+			if(mRoots[i] == object && mRootHandles[i] == NoRootHandle) {
+				this->eraseRoot(i);
+			}
+		}
 	}
 	
 	/**
-	 * Run garbage collection on this heap.
+	 * Register the specified object as a heap root and get a handle for it, which can be used to access
+	 * and remove the root in constant time. If the object is moved by compaction or promoted by a minor
+	 * collection, the root is updated.
 	 * 
-	 * The implemented algorithm is the Deutsch-Schorr-Waite mark and sweep collector, i.e. a non-moving
-	 * collector, which uses the registered heap roots to find living objects.
+	 * @param object Pointer to the object to register, must not be `nullptr`.
+	 * @return The handle of the root, which stays valid until {@link removeRoot(std::size_t)} is called.
+	 * @see Root
 	 */
-	void gc() noexcept;
-
+	std::size_t addRoot(void *object) noexcept;
+	
 	/**
-	 * Dump the contents of this heap to the specified stream.
+	 * Remove the root with the specified handle. The handle may be reused by roots registered later.
 	 * 
-	 * The dump contains a list of live objects, a list of free blocks, and overall statistics.
+	 * @param handle The handle of the root as returned by {@link addRoot}.
+	 */
+	void removeRoot(std::size_t handle) noexcept;
+	
+	/**
+	 * Get the object registered as the root with the specified handle.
 	 * 
-	 * @param os The output stream to write to.
+	 * @param handle The handle of the root as returned by {@link addRoot}.
+	 * @return Pointer to the object, which is updated when the object is moved.
 	 */
-	void dump(std::ostream &os);
+	void* root(std::size_t handle) noexcept {
+		std::lock_guard<std::recursive_mutex> lock{mMutex};
+		return mRoots[mRootSlots[handle]];
+	}
 	
-private:
+	/**
+	 * Replace the object registered as the root with the specified handle.
+	 * 
+	 * @param handle The handle of the root as returned by {@link addRoot}.
+	 * @param object Pointer to the object to register instead, must not be `nullptr`.
+	 */
+	void root(std::size_t handle, void *object) noexcept {
+		std::lock_guard<std::recursive_mutex> lock{mMutex};
+		assert(object);
+		mRoots[mRootSlots[handle]] = static_cast<byte*>(object);
+		if(mMarking.load(std::memory_order_relaxed)) {
+			this->shade(object);
+		}
+	}
 	
 	/**
-	 * Get a reference to the block for an object address.
+	 * Create a weak reference to the specified object and get a handle for it. A weak reference does not keep
+	 * its object alive: garbage collection clears it once the object is unreachable, before the object is
+	 * destroyed, and updates it when the object is moved. Objects must not be deallocated explicitly while
+	 * they are weakly referenced.
 	 * 
-	 * @param ptr The object address (pointer to a managed object; pointer to the block's data portion).
-	 * @return A reference to the block object.
+	 * @param object Pointer to the object to reference, may be `nullptr`.
+	 * @return The handle of the weak reference, which stays valid until {@link removeWeakRef} is called.
+	 * @see WeakRef
 	 */
-	static Block& block(byte *ptr) noexcept {
-		return *reinterpret_cast<Block*>(ptr - Align);
+	std::size_t addWeakRef(void *object) noexcept;
+	
+	/**
+	 * Remove the weak reference with the specified handle. The handle may be reused later.
+	 * 
+	 * @param handle The handle of the weak reference as returned by {@link addWeakRef}.
+	 */
+	void removeWeakRef(std::size_t handle) noexcept;
+	
+	/**
+	 * Get the object of the weak reference with the specified handle.
+	 * 
+	 * The object may be unreachable while an incremental collection cycle is marking. Storing it into a
+	 * managed object or a root makes it reachable again, like any other store.
+	 * 
+	 * @param handle The handle of the weak reference as returned by {@link addWeakRef}.
+	 * @return Pointer to the object, or `nullptr` if the reference was cleared.
+	 */
+	void* weakRef(std::size_t handle) noexcept {
+		std::lock_guard<std::recursive_mutex> lock{mMutex};
+		return mWeakRefs[handle];
 	}
 	
 	/**
-	 * Align the specified object size to the heap alignment.
+	 * Replace the object of the weak reference with the specified handle.
 	 * 
-	 * @param offset The object size to align.
-	 * @return The offset aligned to the next larger multiple of this heap's alignment.
+	 * @param handle The handle of the weak reference as returned by {@link addWeakRef}.
+	 * @param object Pointer to the object to reference instead, may be `nullptr`.
 	 */
-	static std::size_t align(std::size_t size) noexcept {
-		return (size + Align - 1) & ~(Align - 1);
+	void weakRef(std::size_t handle, void *object) noexcept {
+		std::lock_guard<std::recursive_mutex> lock{mMutex};
+		mWeakRefs[handle] = static_cast<byte*>(object);
 	}
 	
 	/**
-	 * Try to allocate a block of memory for the specified type.
+	 * Register a weak table, which is notified whenever garbage collection has cleared or moved weakly
+	 * referenced objects.
 	 * 
-	 * @param type Type descriptor for the memory to allocate.
-	 * @return A pointer to the allocated memory block, or `nullptr` if the allocation failed.
+	 * @param table The table to register, must be removed before it is destroyed.
 	 */
-	void* tryAllocate(const TypeDescriptor &type) noexcept;
+	void addWeakTable(WeakTable &table);
 	
 	/**
-	 * Merge free blocks and build a new free list.
+	 * Remove a registered weak table.
+	 * 
+	 * @param table The table to remove.
 	 */
-	void mergeBlocks() noexcept;
+	void removeWeakTable(WeakTable &table) noexcept;
 	
 	/**
-	 * Perform marking for the garbage collector on the specified heap root.
+	 * Run garbage collection on this heap.
 	 * 
-	 * @param root Pointer to an object whose object graph should be marked.
+	 * The implemented algorithm is the Deutsch-Schorr-Waite mark and sweep collector, i.e. a non-moving
+	 * collector, which uses the registered heap roots to find living objects.
+	 * 
+	 * With lazy sweeping enabled, only the mark phase is performed here and garbage objects are destroyed
+	 * during subsequent allocations (or the next call to `gc()`). With background sweeping enabled, they are
+	 * destroyed by the sweeper thread.
+	 * 
+	 * Other threads that allocate meanwhile wait until the collection is complete, but they must not modify
+	 * managed objects while it runs. Other threads are not brought to a safepoint: an object that another
+	 * thread allocated and has not made reachable from a root yet is garbage to the collection (see
+	 * {@link tlabSize}).
+	 * 
+	 * If an incremental collection cycle is in progress (see {@link gcStep}), it is completed instead of
+	 * starting a new one.
+	 * 
+	 * Heaps with growable storage (see {@link GrowableHeap}) are resized after sweeping: the storage grows
+	 * by half if less than a quarter of it is free, and free space at its end is decommitted if more than
+	 * three quarters are free. With lazy or background sweeping, the storage only grows when an allocation
+	 * fails.
 	 */
-	void mark(byte *root) noexcept;
+	void gc() noexcept;
+	
+	/**
+	 * Perform a bounded amount of incremental garbage collection work.
+	 * 
+	 * The first step of a cycle runs a minor collection and greys all heap roots. Each step then scans at
+	 * most `budget` grey objects from the grey worklist, marking their unmarked children grey. Once no grey
+	 * objects are left, the step completes the cycle like `gc()`, so with lazy sweeping enabled the last
+	 * step is as short as the others.
+	 * 
+	 * Between steps, the tri-color invariant is kept by the write barrier of {@link Member}, which greys
+	 * every object stored into a field while marking (Dijkstra's barrier), so every pointer field of every
+	 * managed type must be a `Member`. Objects allocated during the cycle are allocated in the old
+	 * generation and marked (black), and each allocation scans a few grey objects itself, so marking keeps
+	 * up with allocation. Objects deallocated during the cycle are freed once marking is complete.
+	 * Thread-local allocation buffers are stopped for the whole cycle.
+	 * 
+	 * Steps must not run while other threads modify managed objects, the same as `gc()`.
+	 * 
+	 * @param budget The maximum number of objects to scan in this step.
+	 * @return `true` if this step completed the cycle, `false` if there is work left.
+	 */
+	bool gcStep(std::size_t budget) noexcept;
 	
 	/**
-	 * Rebuild the free list with marked objects and destroy unmarked objects.
+	 * Get whether an incremental collection cycle is in progress.
+	 * 
+	 * @return `true` if {@link gcStep} started a cycle that is not complete yet, `false` otherwise.
 	 */
-	void rebuildFreeList() noexcept;
+	bool collecting() const noexcept {
+		return mMarking.load(std::memory_order_relaxed);
+	}
 	
 	/**
-	 * Write a list of live objects to the specified stream.
+	 * Get the shadow stack of the calling thread for this heap, creating it if necessary. The local roots on
+	 * the shadow stacks of all threads are heap roots, which may point to young objects like all roots.
 	 * 
-	 * @param os The output stream to write to.
+	 * Garbage collection reads the shadow stacks of all threads, so other threads must not push or pop
+	 * local roots while it runs.
+	 * 
+	 * @see Local
 	 */
-	void dumpLiveObjects(std::ostream &os);
-}; // class HeapBase
-
-template <std::size_t HeapSize>
-class Heap : public HeapBase
-{
-	static constexpr std::size_t Align = alignof(std::max_align_t);
+	ShadowStack& shadowStack() noexcept;
 	
-	// Make storage slightly bigger to allow for type descriptor pointer
-	alignas(Align)
-	byte mStorage[HeapSize + Align];
+	/**
+	 * Run garbage collection on this heap and compact the old generation.
+	 * 
+	 * After marking, all garbage objects are destroyed and live objects are slid towards the start of the
+	 * heap in address order (Lisp-2 compaction), so the free space ends up in a single block at the end of
+	 * the old generation, from which subsequent allocations are split off. Pinned objects stay where they
+	 * are, the free space before each of them remains a separate free block.
+	 * 
+	 * Like with the nursery, only pointers in managed objects and heap roots are updated, any other pointers
+	 * to moved objects are invalid afterwards and managed types must be movable with `std::memcpy`. Objects
+	 * whose address is kept elsewhere must be pinned. The same restrictions for other threads apply as for
+	 * `gc()`, and an incremental collection cycle in progress is completed first.
+	 */
+	void compact() noexcept;
 	
-	Heap() noexcept : HeapBase(mStorage, std::extent<decltype(mStorage)>::value) {
-	}
+	/**
+	 * Pin the specified object, so that compaction does not move it. Pinning does not keep the object
+	 * alive, and young objects cannot be pinned because minor collections always move them.
+	 * 
+	 * @param object Pointer to the object to pin.
+	 */
+	void pin(void *object) noexcept;
 	
-public:
+	/**
+	 * Unpin the specified object, so that compaction may move it again.
+	 * 
+	 * @param object Pointer to the object to unpin.
+	 */
+	void unpin(void *object) noexcept;
 	
-	/** The size of this heap. */
-	static constexpr auto size = HeapSize;
+	/**
+	 * Enable or disable lazy sweeping.
+	 * 
+	 * When lazy sweeping is enabled, `gc()` does not sweep the heap, instead allocations sweep just enough
+	 * blocks to satisfy the request. This makes the garbage collection pause proportional to the amount of
+	 * live objects instead of the heap size. Destructors of garbage objects run when they are swept.
+	 * 
+	 * Disabling lazy sweeping finishes any pending sweep immediately.
+	 * 
+	 * @param enable `true` to enable lazy sweeping, `false` to disable it.
+	 */
+	void lazySweep(bool enable) noexcept;
 	
-	static Heap& instance() noexcept {
-		static Heap instance{};
-		return instance;
+	/**
+	 * Get whether lazy sweeping is enabled.
+	 * 
+	 * @return `true` if lazy sweeping is enabled, `false` otherwise.
+	 */
+	bool lazySweep() const noexcept {
+		return mLazySweep;
 	}
 	
-	static void* allocate(const TypeDescriptor &type, bool isRoot = false) noexcept {
-		return instance().HeapBase::allocate(type, isRoot);
+	/**
+	 * Enable or disable background sweeping.
+	 * 
+	 * When background sweeping is enabled, `gc()` only marks and a sweeper thread sweeps the heap
+	 * concurrently with other threads, one chunk at a time. Free blocks become available for allocation as
+	 * soon as their chunk is swept. A thread that finds no free block sweeps on its own like with lazy
+	 * sweeping, so it only waits for the sweeper if both need the heap lock at the same time. Destructors of
+	 * garbage objects run on the sweeper thread.
+	 * 
+	 * Disabling background sweeping stops the sweeper thread, and finishes any pending sweep unless lazy
+	 * sweeping is enabled. If the sweeper thread cannot be started, background sweeping stays disabled.
+	 * 
+	 * @param enable `true` to enable background sweeping, `false` to disable it.
+	 */
+	void backgroundSweep(bool enable) noexcept;
+	
+	/**
+	 * Get whether background sweeping is enabled.
+	 * 
+	 * @return `true` if a sweeper thread is running, `false` otherwise.
+	 */
+	bool backgroundSweep() const noexcept {
+		return mSweeper.joinable();
 	}
 	
-	static void deallocate(void *obj) noexcept {
-		instance().HeapBase::deallocate(obj);
+	/**
+	 * Set the minimum size of free blocks whose memory is returned to the operating system.
+	 * 
+	 * When sweeping is complete and after compaction, the whole pages inside each free block of at least this
+	 * size are discarded, so the resident memory of the heap goes down after a burst of garbage even if the
+	 * storage cannot shrink. The pages stay committed and are backed by memory again when they are reused.
+	 * Discarded pages are tracked until then, so pages that stay free are only discarded once.
+	 * 
+	 * Reusing discarded pages costs a page fault each, so the size should be large enough that such blocks
+	 * are not filled again by every collection cycle.
+	 * 
+	 * @param size The minimum size of free blocks in bytes, or `0` to keep all memory (the default).
+	 */
+	void releaseThreshold(std::size_t size) noexcept;
+	
+	/**
+	 * Get the minimum size of free blocks whose memory is returned to the operating system.
+	 * 
+	 * @return The minimum size of free blocks in bytes, `0` if no memory is returned.
+	 */
+	std::size_t releaseThreshold() const noexcept {
+		return mReleaseThreshold;
 	}
-}; // class Heap
+	
+	/**
+	 * Enable or disable transparent huge pages for the heap storage.
+	 * 
+	 * Huge pages reduce TLB misses when marking and accessing the densely packed live objects, especially
+	 * after compaction. With huge pages, free memory is only returned to the operating system in whole huge
+	 * pages (see {@link releaseThreshold}), so the huge pages holding live objects are not split up. Has no
+	 * effect if the operating system does not support transparent huge pages.
+	 * 
+	 * Only the committed storage is advised, not the address space reserved for growing, so huge pages are
+	 * not set up for memory the heap may never use. Storage committed by growing later is advised as well.
+	 * 
+	 * @param enable `true` to ask for huge pages, `false` to avoid them.
+	 */
+	void hugePages(bool enable) noexcept;
+	
+	/**
+	 * Get whether transparent huge pages are enabled for the heap storage.
+	 * 
+	 * @return `true` if huge pages are enabled and supported, `false` otherwise.
+	 */
+	bool hugePages() const noexcept {
+		return mHugePages;
+	}
+	
+	/**
+	 * Enable or disable the side mark bitmap.
+	 * 
+	 * When the mark bitmap is enabled, the GC mark of each object is kept in a bitmap beside the heap
+	 * storage instead of in the block header. Sweeping then does not need to write to live objects, and
+	 * finds the end of garbage runs by scanning whole words of the bitmap.
+	 * 
+	 * Any pending sweep is finished before switching. Enabling has no effect if the heap has no bitmap.
+	 * 
+	 * @param enable `true` to use the mark bitmap, `false` to use mark bits in block headers.
+	 */
+	void markBitmap(bool enable) noexcept;
+	
+	/**
+	 * Get whether the side mark bitmap is used.
+	 * 
+	 * @return `true` if marks are kept in the mark bitmap, `false` if they are kept in block headers.
+	 */
+	bool markBitmap() const noexcept {
+		return mUseMarkBits;
+	}
+	
+	/**
+	 * Set the number of threads used for marking.
+	 * 
+	 * With more than one thread, the heap roots are partitioned across worker threads, which trace the
+	 * object graph using work-stealing mark stacks and set marks in the mark bitmap with atomic operations.
+	 * If a mark stack overflows, marking is completed serially after the parallel phase. Parallel marking
+	 * requires the mark bitmap, without it marking is always serial. Marking is serial as well if the mark
+	 * stacks of the threads cannot be allocated.
+	 * 
+	 * @param threads The number of marker threads (including the thread calling `gc()`), `0` or `1` for
+	 *                serial marking (see {@link markStackSize}).
+	 */
+	void markThreads(unsigned threads) noexcept {
+		mMarkThreads = threads;
+	}
+	
+	/**
+	 * Get the number of threads used for marking.
+	 * 
+	 * @return The number of marker threads, `0` or `1` for serial marking.
+	 */
+	unsigned markThreads() const noexcept {
+		return mMarkThreads;
+	}
+	
+	/**
+	 * Set the capacity of the mark stack used for serial marking.
+	 * 
+	 * Serial marking traces the object graph depth-first with an explicit mark stack, and prefetches the
+	 * header of each discovered object a few objects before it is visited. If the stack is full, the object
+	 * graph of the next object is marked with the Deutsch-Schorr-Waite algorithm instead, which needs no
+	 * memory besides the objects themselves, so the memory used for marking stays bounded. The stack is
+	 * allocated when marking starts, with one pointer per entry. Defaults to 4096 entries.
+	 * 
+	 * @param size The maximum number of objects on the mark stack, `0` to always use Deutsch-Schorr-Waite
+	 *             marking.
+	 */
+	void markStackSize(std::size_t size) noexcept {
+		mMarkStackSize = size;
+	}
+	
+	/**
+	 * Get the capacity of the mark stack used for serial marking.
+	 * 
+	 * @return The maximum number of objects on the mark stack, `0` if only Deutsch-Schorr-Waite marking is
+	 *         used.
+	 */
+	std::size_t markStackSize() const noexcept {
+		return mMarkStackSize;
+	}
+	
+	/**
+	 * Set the size of the nursery (young generation).
+	 * 
+	 * The nursery is taken from the end of the heap storage, and objects that are not heap roots are
+	 * allocated from it by bumping a pointer. A minor collection copies the young objects reachable from the
+	 * old generation into the old generation (promotion), destroys all other young objects, and then empties
+	 * the nursery at once. Objects larger than a quarter of the nursery, and everything allocated while the
+	 * nursery is full, go to the old generation directly.
+	 * 
+	 * Since young objects are moved, only pointers in managed objects and heap roots are updated by a minor
+	 * collection, any other pointers to young objects are invalid afterwards. Managed types must be movable
+	 * with `std::memcpy`. Objects allocated as heap roots go to the old generation directly, but any root may
+	 * point to a young object: minor collections scan all registered roots and local roots.
+	 * 
+	 * If the old generation runs out of space during promotion, the remaining young objects stay in place and
+	 * the whole nursery becomes part of the old generation. A later `gc()` takes a new nursery from the end
+	 * of the old generation once that space is free again.
+	 * 
+	 * Changing the size runs a minor collection first.
+	 * 
+	 * @param size The size of the nursery in bytes, or `0` to disable the nursery.
+	 */
+	void nurserySize(std::size_t size) noexcept;
+	
+	/**
+	 * Get the configured size of the nursery.
+	 * 
+	 * @return The size of the nursery in bytes, or `0` if the nursery is disabled.
+	 */
+	std::size_t nurserySize() const noexcept {
+		return mNurserySize.load(std::memory_order_relaxed);
+	}
+	
+	/**
+	 * Run a minor collection, which promotes the young objects reachable from the old generation and empties
+	 * the nursery. Live objects of the old generation are scanned for pointers into the nursery.
+	 * 
+	 * `gc()` runs a minor collection before marking, so it never marks young objects. The same restrictions
+	 * for other threads apply as for `gc()`.
+	 */
+	void minorGc() noexcept;
+	
+	/**
+	 * Record a pointer store into the specified field for the card table and incremental marking. This is
+	 * the write barrier used by {@link Member}, stores into fields outside of this heap are not recorded in
+	 * the card table.
+	 * 
+	 * @param field Address of the field that was stored to.
+	 * @param value The pointer that was stored, must not be `nullptr`.
+	 */
+	void writeBarrier(const void *field, void *value) noexcept {
+		const auto card = (reinterpret_cast<std::uintptr_t>(field) - reinterpret_cast<std::uintptr_t>(mHeapStart))
+				>> CardShift;
+		if(card < mNumCards) {
+			mCards[card].store(1, std::memory_order_relaxed);
+		}
+		if(mMarking.load(std::memory_order_relaxed)) {
+			this->shade(value);
+		}
+	}
+	
+	/**
+	 * Enable or disable the card table for minor collections.
+	 * 
+	 * With the card table enabled, minor collections only scan objects of the old generation that are on
+	 * cards dirtied by the write barrier, instead of all of them. This is only correct if every pointer
+	 * field of every managed type is a {@link Member}, raw pointer fields must not point into the nursery.
+	 * 
+	 * Enabling has no effect if the heap has no card table.
+	 * 
+	 * @param enable `true` to use the card table, `false` to scan the whole old generation.
+	 */
+	void cardTable(bool enable) noexcept;
+	
+	/**
+	 * Get whether the card table is used for minor collections.
+	 * 
+	 * @return `true` if only dirty cards are scanned, `false` otherwise.
+	 */
+	bool cardTable() const noexcept {
+		return mUseCards;
+	}
+	
+	/**
+	 * Set the size of thread-local allocation buffers (TLABs).
+	 * 
+	 * With TLABs enabled, each thread takes a chunk of the specified size from the free lists under the
+	 * heap lock, and then allocates small objects from it by bumping a pointer without any locking. Objects
+	 * larger than a quarter of the buffer, and heap roots, are still allocated under the lock. Garbage
+	 * collection stops all threads from bump allocating and returns the unused space of all buffers to the
+	 * free lists. Objects deallocated while their buffer is in use are only freed when it is retired.
+	 * 
+	 * **Garbage collection does not stop other threads at a safepoint.** The handshake between collection and
+	 * bump allocation only keeps the buffers consistent, it does not wait for threads to finish what they
+	 * are doing with the objects they allocated. An object that a thread has just allocated and only holds in
+	 * a plain C++ pointer is garbage to a collection that another thread runs meanwhile, and is destroyed by
+	 * it. Programs that allocate from several threads must run collections only while no other thread
+	 * allocates or modifies managed objects, e.g. when all other threads wait at a barrier of the program,
+	 * and every object the other threads still use must be reachable from a {@link Local} or {@link Root} by
+	 * then. The same holds without allocation buffers. For the same reason, allocations do not collect
+	 * automatically (see {@link GcPolicy}) while buffers are enabled and more than one thread allocated from
+	 * buffers of this heap.
+	 * 
+	 * Changing the size retires all buffers.
+	 * 
+	 * @param size The size of new buffers in bytes, or `0` to disable TLABs.
+	 */
+	void tlabSize(std::size_t size) noexcept;
+	
+	/**
+	 * Get the size of thread-local allocation buffers.
+	 * 
+	 * @return The size of new buffers in bytes, or `0` if TLABs are disabled.
+	 */
+	std::size_t tlabSize() const noexcept {
+		return mTlabSize.load(std::memory_order_relaxed);
+	}
+	
+	/**
+	 * Set the size above which objects are allocated in the large object space.
+	 * 
+	 * Each large object gets its own page-aligned mapping from the operating system, so large objects never
+	 * take space from the free lists of the heap, are never split, moved or compacted. Only the mapping is
+	 * page-aligned: it starts with a header for the list of large objects, so the object itself is only
+	 * aligned to {@link Align}. They are swept by
+	 * walking the list of large objects at the end of each collection, and the mappings of dead large objects
+	 * are returned to the operating system immediately. Since the card table does not cover the large object
+	 * space, minor collections scan all large objects for pointers into the nursery.
+	 * 
+	 * Changing the threshold does not affect objects that were allocated already.
+	 * 
+	 * @param size The object size in bytes above which objects are large, or `0` to disable the large object
+	 *             space.
+	 */
+	void largeObjectThreshold(std::size_t size) noexcept {
+		mLargeObjectThreshold.store(size, std::memory_order_relaxed);
+	}
+	
+	/**
+	 * Get the size above which objects are allocated in the large object space.
+	 * 
+	 * @return The object size in bytes above which objects are large, or `0` if the large object space is
+	 *         disabled.
+	 */
+	std::size_t largeObjectThreshold() const noexcept {
+		return mLargeObjectThreshold.load(std::memory_order_relaxed);
+	}
+	
+	/**
+	 * Set the listener that receives an event for each completed phase of garbage collection. Events are
+	 * only recorded if the library is built with {@link SSW_GC_EVENTS} set.
+	 * 
+	 * @param listener The listener, which must stay valid until it is replaced, or `nullptr` for none.
+	 */
+	void gcListener(GcListener *listener) noexcept;
+	
+	/**
+	 * Get the listener for garbage collection events.
+	 * 
+	 * @return The listener, or `nullptr` if there is none.
+	 */
+	GcListener* gcListener() const noexcept {
+		return mGcListener;
+	}
+	
+	/**
+	 * Get the histogram of the pause times of this heap, which counts all calls of `gc()`, `gcStep()`,
+	 * `minorGc()` and `compact()`. Pauses are only recorded if the library is built with
+	 * {@link SSW_GC_EVENTS} set.
+	 * 
+	 * @return A copy of the histogram.
+	 */
+	PauseHistogram pauseHistogram() noexcept;
+	
+	/**
+	 * Enable or disable allocation profiling.
+	 * 
+	 * While profiling is enabled, every allocation is counted for its type, and the objects of each type
+	 * that survive a collection are counted when the collection is complete (after sweeping), which gives the
+	 * average number of collections the objects of a type survive. With a sampling interval set (see
+	 * {@link allocationSampleInterval}), the call stacks of sampled allocations are recorded as well.
+	 * 
+	 * Profiling costs a hash table lookup per allocation and per destroyed object. Disabling it keeps the
+	 * counters collected so far.
+	 * 
+	 * @param enable `true` to enable profiling, `false` to disable it.
+	 */
+	void profileAllocations(bool enable) noexcept;
+	
+	/**
+	 * Get whether allocation profiling is enabled.
+	 * 
+	 * @return `true` if allocations are counted per type, `false` otherwise.
+	 */
+	bool profileAllocations() const noexcept {
+		return mProfiling.load(std::memory_order_relaxed);
+	}
+	
+	/**
+	 * Set the sampling interval for allocation sites. While profiling is enabled, the call stack of the
+	 * allocation that crosses every `bytes`-th allocated byte is captured, so the number of samples of each
+	 * site is proportional to the amount of memory it allocates, and the overhead of capturing stacks can be
+	 * kept low with a large interval. Each thread allocating from an allocation buffer counts its bytes on
+	 * its own.
+	 * 
+	 * Call stacks are only captured on platforms that support it (glibc, macOS and Windows), elsewhere the
+	 * samples of each type are recorded with an empty call stack.
+	 * 
+	 * @param bytes The number of allocated bytes between samples, or `0` to disable sampling.
+	 */
+	void allocationSampleInterval(std::size_t bytes) noexcept;
+	
+	/**
+	 * Get the sampling interval for allocation sites.
+	 * 
+	 * @return The number of allocated bytes between samples, or `0` if sampling is disabled.
+	 */
+	std::size_t allocationSampleInterval() const noexcept {
+		return mSampleInterval.load(std::memory_order_relaxed);
+	}
+	
+	/**
+	 * Get the allocation profile collected since profiling was first enabled or last reset.
+	 * 
+	 * @return A copy of the counters of all types and sampled allocation sites.
+	 */
+	AllocationProfile allocationProfile();
+	
+	/**
+	 * Reset all counters of the allocation profile and discard the sampled allocation sites.
+	 */
+	void resetAllocationProfile() noexcept;
+	
+	/**
+	 * Set the policy for running garbage collection automatically during allocation. Resets the allocation
+	 * budget to the minimum budget of the policy.
+	 * 
+	 * @param policy The new policy.
+	 */
+	void gcPolicy(const GcPolicy &policy) noexcept;
+	
+	/**
+	 * Get the policy for running garbage collection automatically during allocation.
+	 * 
+	 * @return A copy of the policy.
+	 */
+	GcPolicy gcPolicy() noexcept;
+	
+	/**
+	 * Get the allocation budget, which is tuned after each collection (see
+	 * {@link GcPolicy::targetSurvivalRate}). With lazy or background sweeping, this happens once sweeping is
+	 * complete.
+	 * 
+	 * @return The net size of the objects that may be allocated between two automatic collections.
+	 */
+	std::size_t allocationBudget() noexcept;
+	
+	/**
+	 * Get the survival rate of the last completed collection (see {@link GcPolicy::targetSurvivalRate}).
+	 * 
+	 * @return The survival rate, `0` if there was no collection yet.
+	 */
+	double survivalRate() noexcept;
+	
+	/**
+	 * Dump the contents of this heap to the specified stream.
+	 * 
+	 * The dump contains a list of live objects, a list of free blocks, and overall statistics.
+	 * 
+	 * @param os The output stream to write to.
+	 */
+	void dump(std::ostream &os);
+	
+	/**
+	 * Write a binary snapshot of all objects in this heap, with their types, sizes and references, and the
+	 * heap roots to the specified stream. The format is described with {@link HeapSnapshot}, which reads
+	 * snapshots for offline analysis.
+	 * 
+	 * Unlike {@link dump}, this neither marks nor formats the objects, it takes a single pass over the heap
+	 * and writes through an internal buffer. Objects that have not been swept yet are included even if they
+	 * are garbage.
+	 * 
+	 * @param os The output stream to write to, should be opened in binary mode.
+	 * @return `true` if the snapshot was written, `false` if writing to the stream failed.
+	 */
+	bool writeSnapshot(std::ostream &os);
+	
+private:
+	
+	/**
+	 * Get a reference to the block for an object address.
+	 * 
+	 * @param ptr The object address (pointer to a managed object; pointer to the block's data portion).
+	 * @return A reference to the block object.
+	 */
+	static Block& block(byte *ptr) noexcept {
+		return *reinterpret_cast<Block*>(ptr - Align);
+	}
+	
+	/**
+	 * Align the specified object size to the heap alignment.
+	 * 
+	 * @param offset The object size to align.
+	 * @return The offset aligned to the next larger multiple of this heap's alignment, at least
+	 *         {@link MinBlockSize}.
+	 */
+	static std::size_t align(std::size_t size) noexcept {
+		return size < MinBlockSize ? MinBlockSize : (size + Align - 1) & ~(Align - 1);
+	}
+	
+	/**
+	 * Get the size class for a block of the specified size.
+	 * 
+	 * @param size The usable block size, must be aligned.
+	 * @return Index into the free lists of the class the block belongs to.
+	 */
+	static std::size_t sizeClass(std::size_t size) noexcept;
+	
+	/**
+	 * Put the specified free block into the free list for its size class.
+	 * 
+	 * @param blk The block to add, must be free.
+	 */
+	void addFreeBlock(Block *blk) noexcept;
+	
+	/**
+	 * Remove the specified free block from the free list it is in.
+	 * 
+	 * @param blk The block to remove, must be free and in a free list.
+	 */
+	void removeFreeBlock(Block *blk) noexcept;
+	
+	/**
+	 * Update the boundary tag of the specified block to reflect the state of its predecessor.
+	 * 
+	 * @param blk The block to update, may point to the end of the old generation in which case
+	 *            {@link mLastBlockFree} is updated instead, or into the nursery in which case nothing is done.
+	 * @param prevFree Whether the physically preceding block is free.
+	 */
+	void prevFree(Block *blk, bool prevFree) noexcept;
+	
+	/**
+	 * Remove all blocks from the free lists.
+	 */
+	void clearFreeLists() noexcept {
+		mFreeLists.fill(nullptr);
+		mStats.numFreeBlocks = 0;
+		mStats.freeBlockSize = 0;
+	}
+	
+	/**
+	 * Find a free block of at least the specified size and remove it from the free lists.
+	 * 
+	 * @param size The minimum usable size of the block, must be aligned.
+	 * @return Pointer to the free block, or `nullptr` if there is no such block.
+	 */
+	Block* findFreeBlock(std::size_t size) noexcept;
+	
+	/**
+	 * Try to allocate a block of memory for the specified type.
+	 * 
+	 * @param type Type descriptor for the memory to allocate.
+	 * @param size The size of the block, must be aligned.
+	 * @return A pointer to the allocated memory block, or `nullptr` if the allocation failed.
+	 */
+	void* tryAllocate(const TypeDescriptor &type, std::size_t size) noexcept;
+	
+	/**
+	 * Allocate a block of memory for the specified type in the old generation, merging free blocks and
+	 * growing the storage if necessary.
+	 * 
+	 * @param type Type descriptor for the memory to allocate.
+	 * @param size The size of the block, must be aligned.
+	 * @return A pointer to the allocated memory block, or `nullptr` if the allocation failed.
+	 */
+	void* allocateOld(const TypeDescriptor &type, std::size_t size) noexcept;
+	
+	/**
+	 * Split consecutive blocks for objects of the specified type off the specified block, until the block is
+	 * used up or the specified number of objects is allocated. The remaining space is put back into the free
+	 * lists.
+	 * 
+	 * @param blk A free block that is not in any free list.
+	 * @param type Type descriptor for the objects.
+	 * @param count The maximum number of objects to allocate.
+	 * @param objects The array to store the pointers to the allocated memory blocks in.
+	 * @return The number of allocated objects, at least one if the block is large enough for the type.
+	 */
+	std::size_t carveBatch(Block *blk, const TypeDescriptor &type, std::size_t count, void **objects) noexcept;
+	
+	/**
+	 * Get the header of the specified managed array.
+	 */
+	static ArrayHeader& arrayHeader(byte *array) noexcept {
+		return *reinterpret_cast<ArrayHeader*>(array);
+	}
+	
+	/**
+	 * Get the net size of the object in the specified block, which is the size of its type unless it is an
+	 * array.
+	 * 
+	 * @param blk The block holding the object.
+	 * @param type The type of the object (or its elements), which cannot be read from the block while it
+	 *             is being marked.
+	 */
+	static std::size_t objectSize(const Block *blk, const TypeDescriptor &type) noexcept;
+	
+	/**
+	 * Get the offset of the fields that are traced by the Deutsch-Schorr-Waite algorithm from the start of the
+	 * object in the specified block, which is the offset of the current element for arrays and zero otherwise.
+	 */
+	static std::size_t fieldBase(Block &blk) noexcept;
+	
+	/**
+	 * Get whether the object in the specified block has no pointer fields. Leaf objects are marked without
+	 * tracing them.
+	 * 
+	 * @param blk The block holding the object.
+	 * @param type The type of the object (or its elements).
+	 */
+	static bool leaf(const Block *blk, const TypeDescriptor &type) noexcept;
+	
+	/**
+	 * Call the specified function for each pointer field of the object in the specified block, which
+	 * includes the fields of all elements of arrays.
+	 * 
+	 * @param blk The block holding the object.
+	 * @param type The type of the object (or its elements).
+	 * @param f The function to call with a reference to each field.
+	 */
+	template <typename F>
+	static void forEachField(Block *blk, const TypeDescriptor &type, F f) noexcept;
+	
+	/**
+	 * Destroy the object in the specified block, or all elements if it is an array, and stop counting it as
+	 * an object.
+	 */
+	void destroy(Block *blk) noexcept;
+	
+	/**
+	 * Add the objects allocated from thread-local allocation buffers that have not been retired yet to the
+	 * object counts of the specified statistics.
+	 */
+	void countTlabObjects(HeapStats &stats) noexcept;
+	
+	/**
+	 * Record the objects that are left after a collection as the live objects in the running statistics.
+	 */
+	void recordLiveObjects() noexcept;
+	
+	/**
+	 * Get the net size of all objects, including those in allocation buffers that have not been retired.
+	 */
+	std::size_t currentObjectSize() noexcept;
+	
+	/**
+	 * Record the specified completed phase and report it to the listener.
+	 */
+	void gcEvent(const GcEvent &event) noexcept;
+	
+	/**
+	 * Run a full collection for an allocation if automatic collections are allowed: they are enabled, no
+	 * collection is running, no allocated objects wait to be constructed, and no other thread uses an
+	 * allocation buffer. Must be called with the heap lock held.
+	 * 
+	 * @param failed `true` if the allocation found no free block, `false` to check the allocation budget.
+	 * @return `true` if a collection ran, `false` otherwise.
+	 */
+	bool collectForAllocation(bool failed) noexcept;
+	
+	/**
+	 * Run full collections for an allocation that found no free block if automatic collections are allowed,
+	 * retrying the allocation after each. While an incremental cycle is marking, the first collection only
+	 * completes that cycle, which keeps the objects allocated during it, so a second one runs if needed. Must
+	 * be called with the heap lock held.
+	 * 
+	 * @param allocate The allocation to retry, returns `nullptr` if it failed.
+	 * @return The result of the last retry, or `nullptr` if no collection ran.
+	 */
+	template <typename F>
+	void* allocateAfterCollection(F allocate) noexcept {
+		const bool marking = mMarking.load(std::memory_order_relaxed);
+		void *result = nullptr;
+		if(this->collectForAllocation(true)) {
+			result = allocate();
+			if(!result && marking && this->collectForAllocation(true)) {
+				result = allocate();
+			}
+		}
+		return result;
+	}
+	
+	/**
+	 * Choose the next allocation budget from the live objects after a collection.
+	 */
+	void tuneAllocationBudget() noexcept;
+	
+	/**
+	 * Get the allocation profile counters for the specified type, creating them if necessary. Must be called
+	 * with the heap lock held.
+	 * 
+	 * @throws std::bad_alloc If the counters cannot be created.
+	 */
+	TypeCounters& typeCounters(const TypeDescriptor &type);
+	
+	/**
+	 * Count allocated objects in the allocation profile and take samples as needed. Must be called with the
+	 * heap lock held. If the profile cannot record the objects for lack of memory, they are left out.
+	 * 
+	 * @param type The type of the objects, or the element type of an array.
+	 * @param size The net size of each object.
+	 * @param count (optional) The number of objects.
+	 */
+	void profileAllocation(const TypeDescriptor &type, std::size_t size, std::size_t count = 1) noexcept;
+	
+	/**
+	 * Get the allocation profile counters for the specified type through the cache of the allocation buffer
+	 * of the calling thread, taking the heap lock only if the type is not cached yet. The heap lock must not
+	 * be taken while bump allocating, since collections wait for that to finish with the heap lock held.
+	 * 
+	 * @return The counters, or `nullptr` if they cannot be created for lack of memory.
+	 */
+	TypeCounters* tlabTypeCounters(Tlab &tlab, const TypeDescriptor &type) noexcept;
+	
+	/**
+	 * Count an object allocated from the allocation buffer of the calling thread in the allocation profile,
+	 * without taking the heap lock. Called while bump allocating, so a collection cannot see the object
+	 * before it is counted.
+	 * 
+	 * @return The number of samples the allocation accounts for, which must be recorded with
+	 *         {@link recordTlabSamples} once bump allocation is done.
+	 */
+	std::uint64_t profileTlabAllocation(Tlab &tlab, TypeCounters &counters, const TypeDescriptor &type) noexcept;
+	
+	/**
+	 * Record samples taken by {@link profileTlabAllocation}, leaving them out if the profile cannot record
+	 * them for lack of memory. Takes the heap lock.
+	 */
+	void recordTlabSamples(const TypeDescriptor &type, std::uint64_t samples) noexcept;
+	
+	/**
+	 * Count allocated bytes against a sampling countdown.
+	 * 
+	 * @param countdown The number of bytes left until the next sample, `0` if the countdown was not started.
+	 *                  Updated for the allocated bytes.
+	 * @param interval The sampling interval, must not be `0`.
+	 * @param bytes The number of allocated bytes.
+	 * @return The number of samples the allocation accounts for, usually `0` or `1`.
+	 */
+	static std::uint64_t countSamples(std::size_t &countdown, std::size_t interval, std::size_t bytes) noexcept;
+	
+	/**
+	 * Record samples of the call stack of the calling thread for the allocation of an object. Must be called
+	 * with the heap lock held.
+	 * 
+	 * @param type The type of the object.
+	 * @param size The net size of the object.
+	 * @param samples The number of samples the allocation accounts for.
+	 * @throws std::bad_alloc If the samples cannot be recorded.
+	 */
+	void recordSamples(const TypeDescriptor &type, std::size_t size, std::uint64_t samples);
+	
+	/**
+	 * Count an object that is destroyed or deallocated in the allocation profile. Objects of types that were
+	 * never counted are not counted here either. Must be called with the heap lock held.
+	 */
+	void profileFree(const TypeDescriptor &type) noexcept {
+		const auto entry = mTypeCounters.find(&type);
+		if(entry != mTypeCounters.end()) {
+			entry->second.liveObjects.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+	
+	/**
+	 * Record the objects of each type that are left after a collection as survivors in the allocation
+	 * profile.
+	 */
+	void recordSurvivors() noexcept;
+	
+	/**
+	 * Get whether the specified object is in the nursery.
+	 * 
+	 * @param ptr Pointer to the object.
+	 * @return `true` if the object is in the nursery, `false` if it is in the old generation.
+	 */
+	bool inNursery(const byte *ptr) const noexcept {
+		return ptr >= reinterpret_cast<const byte*>(mHeapEnd)
+				&& ptr < reinterpret_cast<const byte*>(mNurseryTop);
+	}
+	
+	/**
+	 * Allocate a block of memory for the specified type in the nursery.
+	 * 
+	 * @param type Type descriptor for the memory to allocate.
+	 * @return A pointer to the allocated memory block, or `nullptr` if the object does not fit.
+	 */
+	void* allocateYoung(const TypeDescriptor &type) noexcept;
+	
+	/**
+	 * Promote all reachable young objects and empty the nursery, or turn it into part of the old generation
+	 * if promotion fails. Must be called with allocation buffers stopped.
+	 */
+	void collectNursery() noexcept;
+	
+	/**
+	 * Update the weak references to young objects after promotion: references to promoted objects follow
+	 * them, and references to objects that were neither promoted nor retained are cleared.
+	 * 
+	 * @return `true` if any weak reference was changed.
+	 */
+	bool updateYoungWeakRefs() noexcept;
+	
+	/**
+	 * Get whether the specified block holds an object that may be live, i.e. it is used and either has been
+	 * swept or is marked. Unmarked objects that have not been swept yet are garbage.
+	 */
+	bool maybeLive(const Block *blk) const noexcept;
+	
+	/**
+	 * Promote the young objects the fields of the specified object point to.
+	 * 
+	 * @param state The state of the minor collection.
+	 * @param obj Pointer to the object to scan.
+	 */
+	void promoteChildren(PromotionState &state, byte *obj) noexcept;
+	
+	/**
+	 * Promote the young objects referenced by objects on dirty cards.
+	 * 
+	 * @param state The state of the minor collection.
+	 */
+	void scanCards(PromotionState &state) noexcept;
+	
+	/**
+	 * Clear all cards of the card table.
+	 */
+	void clearCards() noexcept;
+	
+	/**
+	 * Record the start of a block of the old generation in the block start bitmap, if the card table is used.
+	 */
+	void setBlockStart(const Block *blk) noexcept;
+	
+	/**
+	 * Remove a block that is merged into a preceding block from the block start bitmap, if the card table
+	 * is used.
+	 */
+	void clearBlockStart(const Block *blk) noexcept;
+	
+	/**
+	 * Use the block start bitmap to find the block containing the specified address.
+	 * 
+	 * @param ptr An address in the old generation.
+	 * @return Pointer to the last block starting at or before `ptr`.
+	 */
+	Block* blockStart(const byte *ptr) const noexcept;
+	
+	/**
+	 * Rebuild the block start bitmap from the blocks in the old generation.
+	 */
+	void rebuildBlockStarts() noexcept;
+	
+	/**
+	 * Promote the young object the specified field points to, and update the field to point to the copy.
+	 * 
+	 * @param state The state of the minor collection.
+	 * @param field Reference to a pointer to a managed object, which is not changed if it does not point into
+	 *              the nursery.
+	 */
+	void promote(PromotionState &state, byte *&field) noexcept;
+	
+	/**
+	 * Make the nursery part of the old generation, keeping the young objects marked as retained and turning
+	 * all other space into free blocks.
+	 */
+	void absorbNursery() noexcept;
+	
+	/**
+	 * Take a new nursery from the end of the old generation if the nursery is enabled but missing, and the
+	 * last block of the old generation is free and large enough. Sweeping must be complete. Takes constant
+	 * time, the last block is found through its boundary tag.
+	 */
+	void ensureNursery() noexcept;
+	
+	/**
+	 * Plan compaction of the marked heap: destroy unmarked objects, and compute the new location of every
+	 * marked object.
+	 * 
+	 * @param relocations Receives the old and new location of every marked object, in address order.
+	 */
+	void planCompaction(std::vector<Relocation> &relocations) noexcept;
+	
+	/**
+	 * Update the heap roots, weak references and the fields of all live objects to point to the new
+	 * locations.
+	 * 
+	 * @param relocations The planned relocations.
+	 */
+	void updatePointers(const std::vector<Relocation> &relocations) noexcept;
+	
+	/**
+	 * Move all objects to their new locations and rebuild the free lists from the space in between.
+	 * 
+	 * @param relocations The planned relocations.
+	 */
+	void moveObjects(const std::vector<Relocation> &relocations) noexcept;
+	
+	/**
+	 * Call the specified function for each heap root that is not `nullptr`: the registered roots and the
+	 * local roots of all threads.
+	 * 
+	 * @param f The function to call with a reference to each root, through which the root may be changed.
+	 */
+	template <typename F>
+	void forEachRoot(F f) noexcept {
+		for(auto &root : mRoots) {
+			f(root);
+		}
+		for(auto stack : mShadowStacks) {
+			for(auto local = stack->top; local; local = local->prev) {
+				if(local->object) {
+					f(local->object);
+				}
+			}
+		}
+	}
+	
+	/**
+	 * Append a root to the dense root array and shade it if an incremental collection cycle is marking.
+	 * 
+	 * @param object Pointer to the root object.
+	 * @param handle The handle of the root, or {@link NoRootHandle}.
+	 */
+	void insertRoot(void *object, std::size_t handle) noexcept;
+	
+	/**
+	 * Remove a root from the dense root array by moving the last root into its place.
+	 * 
+	 * @param index The index of the root in {@link mRoots}.
+	 */
+	void eraseRoot(std::size_t index) noexcept;
+	
+	/**
+	 * Initialize this heap with storage and side tables in the specified reservation.
+	 */
+	HeapBase(byte *reservation, std::size_t size, std::size_t maxSize) noexcept;
+	
+	/**
+	 * Get the mutex that guards the heap of the shadow stacks and allocation buffers of all threads and heaps.
+	 * It is taken before the heap lock when a thread record or a heap is destroyed, so a record never refers to
+	 * a destroyed heap.
+	 */
+	static std::mutex& threadRecordMutex() noexcept;
+	
+	/**
+	 * Detach the shadow stacks of all threads from this heap, so they are not unregistered from the heap when
+	 * their threads exit. Called when the heap is destroyed.
+	 */
+	void detachShadowStacks() noexcept;
+	
+	/**
+	 * Get the current size of the heap storage in bytes.
+	 */
+	std::size_t storageSize() const noexcept {
+		return reinterpret_cast<const byte*>(mStorageEnd) - reinterpret_cast<const byte*>(mHeapStart);
+	}
+	
+	/**
+	 * Commit more storage at the end of the heap and add it to the old generation as a free block. The
+	 * storage grows by half of its size, or more if necessary. The nursery becomes part of the old generation,
+	 * objects in it are tenured without moving them. Must be called with allocation buffers stopped.
+	 * 
+	 * @param minSize The minimum size of the new free block.
+	 * @return `true` if the storage was grown, `false` if it is not growable or has reached its maximum size.
+	 */
+	bool grow(std::size_t minSize) noexcept;
+	
+	/**
+	 * Grow or shrink the storage depending on the amount of free space. Sweeping must be complete.
+	 */
+	void resizeStorage() noexcept;
+	
+	/**
+	 * Clear the mark bitmap, the card table and the block start bitmap for a range of the storage.
+	 * 
+	 * @param start The start of the range, which must be page-aligned.
+	 * @param end The end of the range, which must be page-aligned.
+	 */
+	void clearSideTables(const Block *start, const Block *end) noexcept;
+	
+	/**
+	 * Discard the whole pages inside free blocks of at least {@link mReleaseThreshold} bytes that are not
+	 * discarded already. The block headers, free list links and boundary tags stay resident. Sweeping must be
+	 * complete.
+	 */
+	void releaseFreeMemory() noexcept;
+	
+	/**
+	 * Record that the specified range of the storage may be written to again, so its pages are no longer
+	 * discarded. Must be called before memory taken from free blocks is used, except for their headers.
+	 */
+	void touchPages(const void *start, const void *end) noexcept {
+		if(!mReleasedPages.empty()) {
+			this->clearReleasedPages(start, end);
+		}
+	}
+	
+	/**
+	 * Record that the specified block, which was split off a free block, and the header of the free block
+	 * after it may be written to again (see {@link touchPages}).
+	 */
+	void touchBlock(const Block *blk) noexcept;
+	
+	/**
+	 * Clear the discarded flags of the pages overlapping the specified range of the storage.
+	 */
+	void clearReleasedPages(const void *start, const void *end) noexcept;
+	
+	/**
+	 * Get whether the specified block is in the large object space, i.e. outside the heap storage.
+	 */
+	bool isLarge(const Block *blk) const noexcept {
+		return blk < mHeapStart || blk >= mStorageLimit;
+	}
+	
+	/**
+	 * Allocate a block of memory for the specified type in the large object space.
+	 * 
+	 * @param type Type descriptor for the memory to allocate.
+	 * @param size The size of the object.
+	 * @return A pointer to the allocated memory block, or `nullptr` if the memory could not be mapped.
+	 */
+	void* allocateLarge(const TypeDescriptor &type, std::size_t size) noexcept;
+	
+	/**
+	 * Unmap the specified large object. No destructors are called.
+	 * 
+	 * @param blk The block of the large object.
+	 */
+	void freeLarge(Block *blk) noexcept;
+	
+	/**
+	 * Destroy and unmap all unmarked large objects, and clear the marks of all others.
+	 */
+	void sweepLargeObjects() noexcept;
+	
+	/**
+	 * Free the specified used block and coalesce it with its free neighbors.
+	 * 
+	 * @param blk The block to free.
+	 */
+	void freeBlock(Block *blk) noexcept;
+	
+	/**
+	 * Get the allocation buffer of the calling thread for this heap, creating it if necessary.
+	 */
+	Tlab& tlab() noexcept;
+	
+	/**
+	 * Allocate a block of memory from the allocation buffer of the calling thread without locking.
+	 * 
+	 * @param type Type descriptor for the memory to allocate.
+	 * @return A pointer to the allocated memory block, or `nullptr` if the buffer has no space left or is
+	 *         stopped.
+	 */
+	void* allocateFromTlab(const TypeDescriptor &type) noexcept;
+	
+	/**
+	 * Bump allocate a block of the specified size from an allocation buffer.
+	 * 
+	 * @param tlab The allocation buffer, must not be in use by another thread.
+	 * @param type Type descriptor for the memory to allocate.
+	 * @return A pointer to the allocated memory block, or `nullptr` if the buffer has no space left.
+	 */
+	static void* bumpAllocate(Tlab &tlab, const TypeDescriptor &type) noexcept;
+	
+	/**
+	 * Replace the allocation buffer of the calling thread and allocate from the new buffer. Must be called
+	 * with the heap lock held.
+	 * 
+	 * @param type Type descriptor for the memory to allocate.
+	 * @return A pointer to the allocated memory block, or `nullptr` if the object is too large for the
+	 *         buffer, or there is no free block for a new buffer.
+	 */
+	void* refillTlab(const TypeDescriptor &type) noexcept;
+	
+	/**
+	 * Return the unused space of an allocation buffer to the free lists and free objects deferred by
+	 * {@link deferFree}. Must be called with the heap lock held, while the owning thread is not allocating.
+	 * 
+	 * @param tlab The allocation buffer to retire.
+	 */
+	void retireTlab(Tlab &tlab) noexcept;
+	
+	/**
+	 * Wait until no thread is bump allocating and retire all allocation buffers. Until the matching call to
+	 * {@link resumeTlabs}, all allocations take the lock. Must be called with the heap lock held.
+	 */
+	void stopTlabs() noexcept;
+	
+	/**
+	 * Detach the allocation buffers of all threads from this heap without retiring them. Called when the heap
+	 * is destroyed.
+	 */
+	void detachTlabs() noexcept;
+	
+	/**
+	 * Allow allocation buffers again after a call to {@link stopTlabs}.
+	 */
+	void resumeTlabs() noexcept;
+	
+	/**
+	 * Defer freeing the specified block if it is in an allocation buffer, whose owner might be writing the
+	 * headers around it.
+	 * 
+	 * @param blk The block to free, its object must have been destroyed already.
+	 * @return `true` if freeing was deferred until the buffer is retired, `false` otherwise.
+	 */
+	bool deferFree(Block *blk) noexcept;
+	
+	/**
+	 * Merge adjacent free blocks and build new free lists.
+	 */
+	void mergeBlocks() noexcept;
+	
+	/**
+	 * Get the index of the bit in the mark bitmap for the specified block.
+	 */
+	std::size_t markBit(const Block *blk) const noexcept {
+		return (reinterpret_cast<const byte*>(blk) - reinterpret_cast<const byte*>(mHeapStart)) / Align;
+	}
+	
+	/**
+	 * Get whether the specified block is marked.
+	 */
+	bool marked(const Block *blk) const noexcept;
+	
+	/**
+	 * Set the mark for the specified block.
+	 */
+	void setMark(Block *blk) noexcept;
+	
+	/**
+	 * Atomically set the mark for the specified block in the mark bitmap.
+	 * 
+	 * @return `true` if the block was not marked before, `false` otherwise.
+	 */
+	bool tryMark(Block *blk) noexcept;
+	
+	/**
+	 * Clear the mark for the specified block.
+	 */
+	void clearMark(Block *blk) noexcept;
+	
+	/**
+	 * Clear the whole mark bitmap.
+	 */
+	void clearMarkBitmap() noexcept;
+	
+	/**
+	 * Use the mark bitmap to find the first marked block at or after the specified block.
+	 * 
+	 * @param blk The block to start searching at.
+	 * @return Pointer to the first marked block, or {@link mHeapEnd} if there is none.
+	 */
+	Block* nextMarked(const Block *blk) const noexcept;
+	
+	/**
+	 * Mark the object graphs of all registered heap roots.
+	 */
+	void markRoots() noexcept;
+	
+	/**
+	 * Prepare the heap for marking: stop allocation buffers, finish any pending sweep and run a minor
+	 * collection. Must be followed by {@link finishCollection}.
+	 */
+	void beginCollection() noexcept;
+	
+	/**
+	 * Complete the collection cycle: finish marking, free objects deallocated during incremental marking,
+	 * sweep (unless sweeping is lazy), and resume allocation buffers.
+	 */
+	void finishCollection() noexcept;
+	
+	/**
+	 * Clear the weak references to old and large objects that are not marked. Must be called after marking
+	 * is complete and before unmarked objects are swept or destroyed. Weak references to young objects are
+	 * left alone, the nursery is empty when marking starts.
+	 * 
+	 * @return `true` if any weak reference was cleared.
+	 */
+	bool clearWeakRefs() noexcept;
+	
+	/**
+	 * Notify all registered weak tables that weak references were cleared or moved.
+	 */
+	void notifyWeakTables() noexcept;
+	
+	/**
+	 * Grey the specified object for incremental marking, i.e. mark it and put it onto the grey worklist, if
+	 * it is an unmarked object of the old generation.
+	 * 
+	 * @param obj Pointer to the object.
+	 */
+	void shade(void *obj) noexcept;
+	
+	/**
+	 * Scan objects from the grey worklist, greying their unmarked children.
+	 * 
+	 * @param budget The maximum number of objects to scan.
+	 * @return `true` if the grey worklist is empty, `false` otherwise.
+	 */
+	bool markIncrementally(std::size_t budget) noexcept;
+	
+	/**
+	 * Mark the object graphs of all registered heap roots using multiple threads.
+	 * 
+	 * @return `true` if the roots were marked, `false` if the mark stacks could not be allocated, in which
+	 *         case nothing was marked.
+	 */
+	bool markParallel() noexcept;
+	
+	/**
+	 * Mark objects from the work-stealing mark stacks until all marker threads run out of work.
+	 * 
+	 * @param state The shared state of the parallel marking.
+	 * @param index The index of the mark stack owned by the calling thread.
+	 */
+	void markWorker(ParallelMarkState &state, std::size_t index) noexcept;
+	
+	/**
+	 * Mark unmarked children of all marked objects with serial marking. This completes marking for objects
+	 * that could not be pushed onto a mark stack.
+	 */
+	void markOverflowed() noexcept;
+	
+	/**
+	 * Perform marking for the garbage collector on the specified heap root with the Deutsch-Schorr-Waite
+	 * algorithm.
+	 * 
+	 * @param root Pointer to an object whose object graph should be marked.
+	 */
+	void mark(byte *root) noexcept;
+	
+	/**
+	 * Perform marking for the garbage collector on the specified heap root with the mark stack, falling
+	 * back to {@link mark} for objects that do not fit onto it (see {@link markStackSize}).
+	 * 
+	 * @param root Pointer to an unmarked object whose object graph should be marked.
+	 */
+	void markWithStack(byte *root) noexcept;
+	
+	/**
+	 * Sweep blocks starting at the sweep cursor, adding free blocks to the free lists and destroying
+	 * unmarked objects, until a free block of at least the specified size was created.
+	 * 
+	 * @param size The size of the free block needed.
+	 * @param stop (optional) Stop sweeping once the sweep cursor reaches this block, or `nullptr` to sweep
+	 *             up to the end of the heap if necessary.
+	 * @return Pointer to the sufficiently large block (which is in the free lists), or `nullptr` if there is
+	 *         nothing left to sweep or the sweep cursor reached `stop`.
+	 */
+	Block* sweep(std::size_t size, const Block *stop = nullptr) noexcept;
+	
+	/**
+	 * The main function of the background sweeper thread, which sweeps chunks whenever a sweep is pending.
+	 */
+	void sweeperMain() noexcept;
+	
+	/**
+	 * Stop the background sweeper thread and wait until it exits. Must be called with the heap lock held
+	 * exactly once by the calling thread.
+	 * 
+	 * @param lock The heap lock, which is released while waiting.
+	 */
+	void stopSweeper(std::unique_lock<std::recursive_mutex> &lock) noexcept;
+	
+	/**
+	 * Rebuild the free lists with marked objects and destroy unmarked objects, i.e. sweep all blocks that
+	 * have not been swept yet.
+	 */
+	void rebuildFreeList() noexcept {
+		this->sweep(SIZE_MAX);
+	}
+	
+	/**
+	 * Write a list of live objects to the specified stream.
+	 * 
+	 * @param os The output stream to write to.
+	 */
+	void dumpLiveObjects(std::ostream &os);
+}; // class HeapBase
+
+template <std::size_t HeapSize>
+class Heap : public HeapBase
+{
+	// Make storage slightly bigger to allow for type descriptor pointer
+	alignas(Align)
+	byte mStorage[HeapSize + Align];
+	
+	// Side mark bitmap for the storage
+	std::atomic<std::uintptr_t> mMarkBits[markBitmapWords(HeapSize + Align)];
+	
+	// Card table and block start bitmap for the storage
+	std::atomic<std::uint8_t> mCards[cardTableSize(HeapSize + Align)];
+	std::atomic<std::uintptr_t> mBlockStarts[markBitmapWords(HeapSize + Align)];
+	
+	Heap() noexcept
+			: HeapBase(mStorage, std::extent<decltype(mStorage)>::value, mMarkBits, mCards, mBlockStarts) {
+	}
+	
+public:
+	
+	/** The size of this heap. */
+	static constexpr auto size = HeapSize;
+	
+	static Heap& instance() noexcept {
+		static Heap instance{};
+		return instance;
+	}
+	
+	static void* allocate(const TypeDescriptor &type, bool isRoot = false) noexcept {
+		return instance().HeapBase::allocate(type, isRoot);
+	}
+	
+	static std::size_t allocateBatch(const TypeDescriptor &type, std::size_t count, void **objects) noexcept {
+		return instance().HeapBase::allocateBatch(type, count, objects);
+	}
+	
+	static void deallocate(void *obj) noexcept {
+		instance().HeapBase::deallocate(static_cast<byte*>(obj));
+	}
+}; // class Heap
+
+/**
+ * A heap whose storage is reserved address space instead of a static array, so the size of the heap can be
+ * chosen at a large maximum without taking up memory. Only the initial size is committed at first, the
+ * storage grows when garbage collection frees too little or an allocation fails, and free space at its end
+ * is returned to the operating system when garbage collection frees a lot.
+ * 
+ * The nursery is at the end of the storage, so growing it tenures all young objects in place. The nursery
+ * is set up again by the next garbage collection.
+ * 
+ * @tparam MaxSize The maximum size of the heap, must be a multiple of 64 KiB.
+ * @tparam InitialSize (optional) The initial and minimum size of the heap, must be a multiple of 64 KiB.
+ */
+template <std::size_t MaxSize, std::size_t InitialSize = MaxSize / 16>
+class GrowableHeap : public HeapBase
+{
+	static_assert(MaxSize % (64 * 1024) == 0 && InitialSize % (64 * 1024) == 0 && InitialSize > 0,
+			"Heap sizes must be positive multiples of 64 KiB.");
+	static_assert(InitialSize <= MaxSize, "The initial heap size must not be larger than the maximum size.");
+	
+	GrowableHeap()
+			: HeapBase(InitialSize, MaxSize) {
+	}
+	
+public:
+	
+	/** The maximum size of this heap. */
+	static constexpr auto size = MaxSize;
+	
+	static GrowableHeap& instance() noexcept {
+		static GrowableHeap instance{};
+		return instance;
+	}
+	
+	static void* allocate(const TypeDescriptor &type, bool isRoot = false) noexcept {
+		return instance().HeapBase::allocate(type, isRoot);
+	}
+	
+	static std::size_t allocateBatch(const TypeDescriptor &type, std::size_t count, void **objects) noexcept {
+		return instance().HeapBase::allocateBatch(type, count, objects);
+	}
+	
+	static void deallocate(void *obj) noexcept {
+		instance().HeapBase::deallocate(static_cast<byte*>(obj));
+	}
+}; // class GrowableHeap
+
+/**
+ * A growable heap (see {@link GrowableHeap}) whose sizes are chosen at runtime, so any number of independent
+ * heaps can be created and destroyed, e.g. one per thread or per shard of a server. Each heap has its own
+ * lock, roots, allocation buffers and collector, so threads working on different heaps never contend.
+ * 
+ * Objects of one heap must not reference objects of another heap. Destroying a heap releases its storage
+ * without running destructors of the objects in it, roots and locals of it must be gone by then.
+ * 
+ * Managed types usually allocate from a dynamic heap through {@link ThreadHeap}.
+ */
+class DynamicHeap : public HeapBase
+{
+	static constexpr std::size_t Granularity = 64 * 1024;
+	
+	static constexpr std::size_t roundSize(std::size_t size) noexcept {
+		return size ? (size + Granularity - 1) & ~(Granularity - 1) : Granularity;
+	}
+	
+public:
+	
+	/**
+	 * Initialize this heap.
+	 * 
+	 * @param maxSize The maximum size of the heap, rounded up to a multiple of 64 KiB.
+	 * @param initialSize (optional) The initial and minimum size of the heap, rounded up to a multiple of
+	 *                    64 KiB. Defaults to one 16th of the maximum size.
+	 * @throws std::bad_alloc If the address space cannot be reserved.
+	 */
+	explicit DynamicHeap(std::size_t maxSize, std::size_t initialSize = 0)
+			: HeapBase(std::min(roundSize(initialSize ? initialSize : maxSize / 16), roundSize(maxSize)),
+					roundSize(maxSize)) {
+	}
+	
+	DynamicHeap(const DynamicHeap&) = delete;
+	DynamicHeap& operator=(const DynamicHeap&) = delete;
+}; // class DynamicHeap
+
+/**
+ * A heap policy for {@link HeapObject} that allocates from the current heap of the calling thread, which is
+ * selected with a {@link ThreadHeap::Scope}. This way the same managed types can live in several heaps,
+ * e.g. each worker thread or each shard has its own {@link DynamicHeap}.
+ * 
+ * The current heap of a thread must be the one that owns every managed object the thread allocates,
+ * deletes or stores into a {@link Member}, {@link Root} or {@link Local} of such types. Scopes must be
+ * nested with locals, i.e. a local must be destroyed under the scope it was created in.
+ */
+class ThreadHeap
+{
+	/**
+	 * Get the current heap of the calling thread, or `nullptr` outside of a scope.
+	 */
+	static HeapBase*& current() noexcept {
+		thread_local HeapBase *heap = nullptr;
+		return heap;
+	}
+	
+public:
+	
+	/**
+	 * Makes a heap the current heap of the calling thread while it exists, and restores the previous one
+	 * when it is destroyed.
+	 */
+	class Scope
+	{
+		HeapBase *mPrevious;
+		
+	public:
+		
+		explicit Scope(HeapBase &heap) noexcept : mPrevious(std::exchange(current(), &heap)) {
+		}
+		
+		~Scope() {
+			current() = mPrevious;
+		}
+		
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+	
+	static constexpr std::size_t NoRootHandle = HeapBase::NoRootHandle;
+	
+	/**
+	 * Get the current heap of the calling thread, which must be in a {@link Scope}.
+	 */
+	static HeapBase& instance() noexcept {
+		assert(current() /* Managed objects of ThreadHeap types need a ThreadHeap::Scope */);
+		return *current();
+	}
+	
+	static void* allocate(const TypeDescriptor &type, bool isRoot = false) noexcept {
+		return instance().allocate(type, isRoot);
+	}
+	
+	static std::size_t allocateBatch(const TypeDescriptor &type, std::size_t count, void **objects) noexcept {
+		return instance().allocateBatch(type, count, objects);
+	}
+	
+	static void deallocate(void *obj) noexcept {
+		instance().deallocate(static_cast<byte*>(obj));
+	}
+}; // class ThreadHeap
 
 } // namespace ssw
 
@@ -17,6 +17,20 @@ namespace ssw {
 template <typename T, typename Heap>
 struct HeapObject
 {
+	/** The heap objects of this type are allocated from. */
+	using HeapType = Heap;
+	
+	/**
+	 * Allocate memory for a `T` object from the heap.
+	 * 
+	 * Garbage collection does not stop other threads at a safepoint, so no other thread may run a collection
+	 * until the new object is reachable from a root (e.g. a {@link Local}), or it may be destroyed under the
+	 * allocating thread (see {@link HeapBase::tlabSize}).
+	 * 
+	 * @param size The size of the object.
+	 * @param isRoot (optional) Whether to register the object as a heap root.
+	 * @throws std::bad_alloc If the heap has no space for the object.
+	 */
 	static void* operator new(size_t size, bool isRoot = false) {
 		// `new` might allocate more bytes for alignment, it should never allocate less than the type
 		// descriptor says (which would mean the type descriptor is wrong)
@@ -0,0 +1,154 @@
+/**
+ * @file    HeapSnapshot.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the {@link HeapSnapshot} class for reading binary heap snapshots.
+ */
+
+#ifndef HEAPSNAPSHOT_HPP_
+#define HEAPSNAPSHOT_HPP_
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace ssw {
+
+/**
+ * A binary heap snapshot written by {@link HeapBase::writeSnapshot}, read into memory for offline analysis.
+ * 
+ * A snapshot starts with the 8 bytes `SSWSNAP1`, followed by a sequence of records. Each record starts with
+ * a tag byte, all numbers are unsigned 64 bit integers in little-endian byte order:
+ * 
+ * - `T` (type): id, net size, name length, name bytes. Each type is written before the first object of
+ *   that type, ids are assigned in order starting at `0`.
+ * - `O` (object): address, type id, net size, flags (see {@link Object::flags}), number of array elements,
+ *   number of pointers, and that many addresses of referenced objects.
+ * - `R` (root): address of a root object.
+ * - `E` (end): no data, the last record.
+ * 
+ * Objects are written in address order for each space, without regard to whether they are reachable, so the
+ * snapshot can be written without marking. Reachability is computed when the snapshot is analyzed.
+ */
+class HeapSnapshot
+{
+public:
+	
+	/** The index of an object, or of the virtual root that references all roots. */
+	using Index = std::uint32_t;
+	
+	/** The index that marks objects not reachable from the roots. */
+	static constexpr Index Unreachable = UINT32_MAX;
+	
+	/** The bits of {@link Object::flags}. */
+	enum ObjectFlags : std::uint64_t {
+		/** The object is a managed array. */
+		ArrayFlag = 1,
+		/** The object is in the large object space. */
+		LargeFlag = 2,
+		/** The object is in the nursery. */
+		YoungFlag = 4,
+		/** The object is pinned. */
+		PinnedFlag = 8,
+	};
+	
+	struct Type {
+		/** The name of the type, empty for unnamed types. */
+		std::string name;
+		/** The net size of the type. */
+		std::uint64_t size;
+	};
+	
+	struct Object {
+		/** The address of the object in the heap. */
+		std::uint64_t address;
+		/** The index of the type of the object (or its elements) in {@link types}. */
+		std::uint64_t type;
+		/** The net size of the object. */
+		std::uint64_t size;
+		/** A combination of {@link ObjectFlags}. */
+		std::uint64_t flags;
+		/** The number of array elements, or `0` if the object is not an array. */
+		std::uint64_t length;
+		/** The index of the first reference of the object in {@link edges}. */
+		std::size_t firstEdge;
+		/** The number of references of the object, not counting pointers to unknown addresses. */
+		std::size_t numEdges;
+		/** The immediate dominator (see {@link computeDominators}). */
+		Index dominator;
+		/** The total net size of the objects dominated by this object, including itself. */
+		std::uint64_t retainedSize;
+	};
+	
+private:
+	
+	std::vector<Type> mTypes;
+	std::vector<Object> mObjects;
+	std::vector<Index> mEdges;
+	std::vector<Index> mRoots;
+	std::uint64_t mReachableSize = 0;
+	
+public:
+	
+	/**
+	 * Read a snapshot from the specified stream, replacing the contents of this object.
+	 * 
+	 * @param is The stream to read from, should be opened in binary mode.
+	 * @return `true` if a complete snapshot was read, `false` if the input is malformed.
+	 */
+	bool read(std::istream &is);
+	
+	/**
+	 * Compute the immediate dominator and the retained size of each object. An object `a` dominates an
+	 * object `b` if every path from the roots to `b` goes through `a`. The retained size of an object is
+	 * the size that would become garbage if the object was garbage.
+	 * 
+	 * Roots and objects that are reachable from several roots through different paths are dominated by the
+	 * virtual root, whose index is the number of objects. Unreachable objects have {@link Unreachable} as
+	 * their dominator and a retained size of `0`.
+	 */
+	void computeDominators();
+	
+	/**
+	 * Get the types of the objects in this snapshot, indexed by type id.
+	 */
+	const std::vector<Type>& types() const noexcept {
+		return mTypes;
+	}
+	
+	/**
+	 * Get the objects in this snapshot.
+	 */
+	const std::vector<Object>& objects() const noexcept {
+		return mObjects;
+	}
+	
+	/**
+	 * Get the references of all objects, as indices of the referenced objects.
+	 */
+	const std::vector<Index>& edges() const noexcept {
+		return mEdges;
+	}
+	
+	/**
+	 * Get the indices of the root objects.
+	 */
+	const std::vector<Index>& roots() const noexcept {
+		return mRoots;
+	}
+	
+	/**
+	 * Get the total size of the reachable objects, which is the retained size of the virtual root. Only
+	 * available after {@link computeDominators}.
+	 */
+	std::uint64_t reachableSize() const noexcept {
+		return mReachableSize;
+	}
+}; // class HeapSnapshot
+
+} // namespace ssw
+
+#endif /* HEAPSNAPSHOT_HPP_ */
@@ -0,0 +1,110 @@
+/**
+ * @file    Local.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the {@link Local} class.
+ */
+
+#ifndef LOCAL_HPP_
+#define LOCAL_HPP_
+#pragma once
+
+#include <cassert>
+
+#include "Heap.hpp"
+
+namespace ssw {
+
+/**
+ * A local variable that keeps a managed object alive as a heap root while it is in scope.
+ * 
+ * A `Local<T>` behaves like a `T*` that is pushed onto the shadow stack of the calling thread for the heap
+ * that `T` objects are allocated from (see {@link HeapBase::shadowStack}) when it is constructed, and popped
+ * when it is destroyed. Pushing and popping only link the local into a thread-local list, they neither lock
+ * nor allocate. Like other roots, locals may point to young objects, and they are updated when the object
+ * is moved by a minor collection or compaction.
+ * 
+ * Locals must be destroyed in the reverse order of their construction by the thread that created them, so
+ * they may only be used as local variables (or temporaries), not in containers or other objects.
+ * 
+ * @tparam T The type of the referenced objects, must have a member type `HeapType` (see {@link HeapObject}).
+ */
+template <typename T>
+class Local
+{
+	HeapBase::LocalRoot mRoot;
+	
+	/**
+	 * Get the shadow stack of the calling thread.
+	 */
+	static HeapBase::ShadowStack& stack() noexcept {
+		// The heap of T may differ between calls (see ThreadHeap), and heaps may be destroyed
+		thread_local HeapBase::ShadowStack *stack = nullptr;
+		HeapBase &heap = T::HeapType::instance();
+		if(!stack || stack->heap.load(std::memory_order_relaxed) != &heap) {
+			stack = &heap.shadowStack();
+		}
+		return *stack;
+	}
+	
+	/**
+	 * Record a store into this local, which must be greyed while an incremental collection cycle is marking.
+	 */
+	void barrier() noexcept {
+		if(mRoot.object) {
+			T::HeapType::instance().writeBarrier(&mRoot.object, mRoot.object);
+		}
+	}
+	
+public:
+	
+	Local(T *ptr = nullptr) noexcept {
+		auto &stack = Local::stack();
+		mRoot.object = reinterpret_cast<byte*>(ptr);
+		mRoot.prev = stack.top;
+		stack.top = &mRoot;
+		this->barrier();
+	}
+	
+	Local(const Local &other) noexcept : Local(other.get()) {
+	}
+	
+	~Local() {
+		auto &stack = Local::stack();
+		assert(stack.top == &mRoot /* Locals must be destroyed in reverse order of construction */);
+		stack.top = mRoot.prev;
+	}
+	
+	Local& operator=(T *ptr) noexcept {
+		mRoot.object = reinterpret_cast<byte*>(ptr);
+		this->barrier();
+		return *this;
+	}
+	
+	Local& operator=(const Local &other) noexcept {
+		return *this = other.get();
+	}
+	
+	/**
+	 * Get the referenced object.
+	 */
+	T* get() const noexcept {
+		return reinterpret_cast<T*>(mRoot.object);
+	}
+	
+	operator T*() const noexcept {
+		return this->get();
+	}
+	
+	T* operator->() const noexcept {
+		return this->get();
+	}
+	
+	T& operator*() const noexcept {
+		return *this->get();
+	}
+}; // class Local
+
+} // namespace ssw
+
+#endif /* LOCAL_HPP_ */
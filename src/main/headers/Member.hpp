@@ -0,0 +1,89 @@
+/**
+ * @file    Member.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the {@link Member} class.
+ */
+
+#ifndef MEMBER_HPP_
+#define MEMBER_HPP_
+#pragma once
+
+namespace ssw {
+
+/**
+ * A pointer field of a managed object that records stores with a write barrier.
+ * 
+ * A `Member<T>` behaves like a `T*`, but every store of a non-null pointer marks the card of the field in
+ * the card table of the heap that `T` objects are allocated from, and greys the stored object while an
+ * incremental collection cycle is marking. With the card table enabled, minor collections only scan objects
+ * on dirty cards for pointers into the nursery, and incremental marking relies on the barrier to find
+ * objects stored into fields that were already scanned, so all pointer fields of managed types must be
+ * members then.
+ * 
+ * Members have the same layout as raw pointers, they can be registered with {@link TypeDescriptor::make}
+ * like raw pointer fields.
+ * 
+ * @tparam T The type of the referenced objects, must have a member type `HeapType` (see {@link HeapObject})
+ *           and point to objects in the same heap as the object containing the field.
+ */
+template <typename T>
+class Member
+{
+	T *mPtr;
+	
+	/**
+	 * Record a store into this field.
+	 */
+	void barrier() noexcept {
+		if(mPtr) {
+			T::HeapType::instance().writeBarrier(this, mPtr);
+		}
+	}
+	
+public:
+	
+	Member() noexcept : mPtr(nullptr) {
+	}
+	
+	Member(T *ptr) noexcept : mPtr(ptr) {
+		this->barrier();
+	}
+	
+	Member(const Member &other) noexcept : mPtr(other.mPtr) {
+		this->barrier();
+	}
+	
+	Member& operator=(T *ptr) noexcept {
+		mPtr = ptr;
+		this->barrier();
+		return *this;
+	}
+	
+	Member& operator=(const Member &other) noexcept {
+		return *this = other.mPtr;
+	}
+	
+	/**
+	 * Get the stored pointer.
+	 */
+	T* get() const noexcept {
+		return mPtr;
+	}
+	
+	operator T*() const noexcept {
+		return mPtr;
+	}
+	
+	T* operator->() const noexcept {
+		return mPtr;
+	}
+	
+	T& operator*() const noexcept {
+		return *mPtr;
+	}
+}; // class Member
+
+} // namespace ssw
+
+#endif /* MEMBER_HPP_ */
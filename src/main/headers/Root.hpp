@@ -0,0 +1,105 @@
+/**
+ * @file    Root.hpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Defines the {@link Root} class.
+ */
+
+#ifndef ROOT_HPP_
+#define ROOT_HPP_
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace ssw {
+
+/**
+ * A handle that keeps a managed object alive as a heap root while it exists.
+ * 
+ * A `Root<T>` behaves like a `T*` that is registered as a root of the heap that `T` objects are allocated
+ * from, and is removed as a root when the handle is destroyed or set to another object. Registering and
+ * removing take constant time (see {@link HeapBase::addRoot}), so handles are suitable for roots that come
+ * and go frequently. The pointer is stored in the heap, so it stays valid when the object is moved by
+ * compaction. A root may point to a young object, e.g. `Root<T>(new T)` with the nursery enabled: minor
+ * collections promote the object and update the root, so only the raw pointer passed in becomes invalid.
+ * 
+ * @tparam T The type of the referenced objects, must have a member type `HeapType` (see {@link HeapObject}).
+ */
+template <typename T>
+class Root
+{
+	std::size_t mHandle;
+	
+	/**
+	 * Get the heap this root is registered with.
+	 */
+	static auto& heap() noexcept {
+		return T::HeapType::instance();
+	}
+	
+public:
+	
+	Root() noexcept : mHandle(T::HeapType::NoRootHandle) {
+	}
+	
+	Root(T *ptr) noexcept : mHandle(ptr ? heap().addRoot(ptr) : T::HeapType::NoRootHandle) {
+	}
+	
+	Root(const Root &other) noexcept : Root(other.get()) {
+	}
+	
+	Root(Root &&other) noexcept : mHandle(std::exchange(other.mHandle, T::HeapType::NoRootHandle)) {
+	}
+	
+	~Root() {
+		if(mHandle != T::HeapType::NoRootHandle) {
+			heap().removeRoot(mHandle);
+		}
+	}
+	
+	Root& operator=(T *ptr) noexcept {
+		if(mHandle == T::HeapType::NoRootHandle) {
+			if(ptr) {
+				mHandle = heap().addRoot(ptr);
+			}
+		} else if(ptr) {
+			heap().root(mHandle, ptr);
+		} else {
+			heap().removeRoot(std::exchange(mHandle, T::HeapType::NoRootHandle));
+		}
+		return *this;
+	}
+	
+	Root& operator=(const Root &other) noexcept {
+		return *this = other.get();
+	}
+	
+	Root& operator=(Root &&other) noexcept {
+		std::swap(mHandle, other.mHandle);
+		return *this;
+	}
+	
+	/**
+	 * Get the referenced object.
+	 */
+	T* get() const noexcept {
+		return mHandle == T::HeapType::NoRootHandle ? nullptr : static_cast<T*>(heap().root(mHandle));
+	}
+	
+	operator T*() const noexcept {
+		return this->get();
+	}
+	
+	T* operator->() const noexcept {
+		return this->get();
+	}
+	
+	T& operator*() const noexcept {
+		return *this->get();
+	}
+}; // class Root
+
+} // namespace ssw
+
+#endif /* ROOT_HPP_ */
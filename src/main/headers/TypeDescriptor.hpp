@@ -2,22 +2,41 @@
  * @file    TypeDescriptor.hpp
  * @author  niob
  * @date    Oct 21, 2016
- * @brief   Declares the {@link TypeDescriptor} class.
+ * @brief   Declares the {@link TypeDescriptor} and {@link StaticTypeDescriptor} classes.
  */
 
 #ifndef TYPEDESCRIPTOR_HPP_
 #define TYPEDESCRIPTOR_HPP_
 #pragma once
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 #include <memory>
 #include <string>
+#include <type_traits>
 
 #include <boost/type_index.hpp>
 
+/**
+ * Whether heap blocks have a compact header of one word instead of two. Define as `1` when building the
+ * library and everything using it to save a word per object: the header packs the block size and flags
+ * with the index of the type descriptor (see {@link ssw::TypeDescriptor::index}), and objects are only
+ * aligned to 8 bytes. Requires a 64-bit platform.
+ */
+#ifndef SSW_COMPACT_HEADERS
+#define SSW_COMPACT_HEADERS 0
+#endif
+
 namespace ssw {
 
+template <typename T>
+class Member;
+
+template <typename T, std::ptrdiff_t... Offsets>
+class StaticTypeDescriptor;
+
 /**
  * Represents a type descriptor for a managed object.
  * 
@@ -26,57 +45,145 @@ namespace ssw {
  * standard {@link begin} and {@link end} iterators.
  * 
  * Since the size of a type descriptor depends on the number of pointers in the described type, but it must
- * be a standard-layout type (for the Deutsch-Schorr-Waite garbage collector), it can only be allocated on
- * the heap and uses some low-level pointer magic for iteration. 
+ * be a standard-layout type (for the Deutsch-Schorr-Waite garbage collector), the pointer offsets follow
+ * the descriptor in memory and are accessed with some low-level pointer magic. Type descriptors are either
+ * allocated on the heap by {@link make}, or generated at compile time by {@link StaticTypeDescriptor}.
  */
 class TypeDescriptor
 {
+	template <typename T, std::ptrdiff_t... Offsets>
+	friend class StaticTypeDescriptor;
+	
 	using Destructor = void(*)(const void*);
 	
-	class AllocTag {};
+	/** Whether fields of type `F` may point to other managed objects. */
+	template <typename F>
+	struct IsPointerField : std::is_pointer<F> {};
 	
-	const std::string mName;
+	template <typename T>
+	struct IsPointerField<Member<T>> : std::true_type {};
+	
+	const char* const mName;
 	const std::size_t mSize;
 	const Destructor mDestructor;
 	const std::size_t mOffsets;
+#if SSW_COMPACT_HEADERS
+	mutable std::atomic<std::uint32_t> mIndex{0};
+	
+	/** The type descriptors by index, entries are only written once before their index is published. */
+	static const TypeDescriptor* sTypes[];
+	
+	/**
+	 * Assign the next free index to this type descriptor, unless another thread was first.
+	 */
+	std::uint32_t registerIndex() const noexcept;
+#endif
 	
-	TypeDescriptor(std::string name, std::size_t size, Destructor destructor,
+	constexpr TypeDescriptor(const char *name, std::size_t size, Destructor destructor,
+			std::size_t offsets) noexcept
+			: mName(name), mSize(size), mDestructor(destructor), mOffsets(offsets) {
+	}
+	
+	/**
+	 * Get the distance from the beginning of a type descriptor to its list of pointer offsets.
+	 */
+	static constexpr std::size_t listOffset() noexcept {
+		return (sizeof(TypeDescriptor) + alignof(std::ptrdiff_t) - 1) & ~(alignof(std::ptrdiff_t) - 1);
+	}
+	
+	/**
+	 * Allocate and initialize a type descriptor, with the name and the pointer offsets in the same
+	 * allocation.
+	 */
+	static TypeDescriptor* create(const std::string &name, std::size_t size, Destructor destructor,
 			std::initializer_list<std::ptrdiff_t> offsets);
 	
+	/**
+	 * Destroy a `T` object, the destructor of type descriptors for `T`.
+	 */
+	template <typename T>
+	static void destroyObject(const void *object) noexcept {
+		static_cast<const T*>(object)->~T();
+	}
+	
+	/**
+	 * Get the destructor for type descriptors for `T`, which is `nullptr` if `T` is trivially destructible.
+	 */
+	template <typename T>
+	static constexpr Destructor destructorOf() noexcept {
+		return std::is_trivially_destructible<T>::value ? nullptr : &destroyObject<T>;
+	}
+	
+	/**
+	 * Get the offset of the specified field within `T` objects.
+	 */
+	template <typename T, typename F>
+	static std::ptrdiff_t offsetOf(F T::*field) noexcept {
+		static_assert(IsPointerField<F>::value, "Fields must be pointers or Member objects.");
+		alignas(T) const unsigned char storage[sizeof(T)] = {};
+		const T *object = reinterpret_cast<const T*>(storage);
+		return reinterpret_cast<const unsigned char*>(&(object->*field)) - storage;
+	}
+	
 public:
 	
+	/**
+	 * The largest alignment of described types, which is the alignment of memory allocated from heaps (see
+	 * {@link HeapBase::Align}).
+	 */
+	static constexpr std::size_t MaxAlign = SSW_COMPACT_HEADERS ? 8 : alignof(std::max_align_t);
+	
+#if SSW_COMPACT_HEADERS
+	/** The largest index of a type descriptor, see {@link index}. */
+	static constexpr std::uint32_t MaxIndex = 0xFFFF;
+	
+	/** The largest number of pointer offsets of a type descriptor that can be used for allocation. */
+	static constexpr std::size_t MaxOffsets = 0x7FF;
+	
+#endif
 	TypeDescriptor(const TypeDescriptor&) = delete;
 	TypeDescriptor(TypeDescriptor&&) = delete;
 	TypeDescriptor& operator=(const TypeDescriptor&) = delete;
 	TypeDescriptor& operator=(TypeDescriptor&&) = delete;
 	
-	/**
-	 * Allocate memory for a type descriptor and the specified number of pointer offsets.
-	 * 
-	 * @param size The size of the TypeDescriptor object.
-	 * @param offsets The number of pointer offsets to be placed after the object.
-	 */
-	void* operator new(std::size_t size, std::size_t offsets, AllocTag);
-	
 	/**
 	 * Create a TypeDescriptor for the specified type with the specified pointer offsets.
-	 *
+	 * 
+	 * The descriptor is allocated on the heap at runtime, use {@link StaticTypeDescriptor} to generate it at
+	 * compile time instead.
+	 * 
 	 * @param offsets (optional) The offsets, within `T` objects, of pointers to other managed objects.
 	 * @return A pointer to the created TypeDescriptor.
-	 *
+	 * 
 	 * @tparam T The type to create the descriptor for.
 	 */
 	template <typename T>
 	static TypeDescriptor* make(std::initializer_list<std::ptrdiff_t> offsets = {}) {
-		return new(offsets.size(), AllocTag{}) TypeDescriptor(
-				boost::typeindex::type_id<T>().pretty_name(),
-				sizeof(T), [](const void *x) { static_cast<const T*>(x)->~T(); }, offsets);
+		static_assert(alignof(T) <= MaxAlign, "Managed types must not be over-aligned for the heap.");
+		return create(boost::typeindex::type_id<T>().pretty_name(), sizeof(T), destructorOf<T>(), offsets);
+	}
+	
+	/**
+	 * Create a TypeDescriptor for the specified type with the specified pointer fields.
+	 * 
+	 * @param field Pointer to a member of `T` that points to other managed objects, which may be a raw
+	 *              pointer or a {@link Member}.
+	 * @param fields Pointers to further members of `T` that point to other managed objects.
+	 * @return A pointer to the created TypeDescriptor.
+	 * 
+	 * @tparam T The type to create the descriptor for.
+	 */
+	template <typename T, typename F, typename... Fields>
+	static TypeDescriptor* make(F T::*field, Fields T::*... fields) {
+		return make<T>({offsetOf(field), offsetOf(fields)...});
 	}
 	
 	/**
 	 * Get the name of the described type.
+	 * 
+	 * @return The name, or `nullptr` if the descriptor was generated without a name.
 	 */
-	const std::string& name() const noexcept {
+	const char* name() const noexcept {
 		return mName;
 	}
 	
@@ -101,6 +208,22 @@ public:
 		return mOffsets;
 	}
 	
+	/**
+	 * Determine whether the described objects are leaves of the object graph, i.e. have no pointers to other
+	 * managed objects. Marking does not trace leaf objects.
+	 */
+	bool leaf() const noexcept {
+		return !mOffsets;
+	}
+	
+	/**
+	 * Determine whether the described objects are trivially destructible, in which case {@link destroy} does
+	 * nothing and garbage collection does not need to call it.
+	 */
+	bool triviallyDestructible() const noexcept {
+		return !mDestructor;
+	}
+	
 	/**
 	 * Get an iterator to the beginning of the pointer offsets.
 	 * 
@@ -125,10 +248,92 @@ public:
 	 * @param object The object to be destroyed.
 	 */
 	void destroy(void *object) const noexcept {
-		mDestructor(object);
+		if(mDestructor) {
+			mDestructor(object);
+		}
+	}
+#if SSW_COMPACT_HEADERS
+	
+	/**
+	 * Get the index of this type descriptor in the global type table, which is assigned when it is first
+	 * used. Compact block headers store the index instead of a pointer to the descriptor.
+	 * 
+	 * The program is aborted if more than {@link MaxIndex} type descriptors are used, or if this descriptor
+	 * has more than {@link MaxOffsets} pointer offsets.
+	 * 
+	 * @return The index, between `1` and {@link MaxIndex}.
+	 */
+	std::uint32_t index() const noexcept {
+		const auto index = mIndex.load(std::memory_order_acquire);
+		return index ? index : this->registerIndex();
+	}
+	
+	/**
+	 * Get the type descriptor with the specified index.
+	 * 
+	 * @param index An index returned by {@link index}.
+	 */
+	static const TypeDescriptor& byIndex(std::uint32_t index) noexcept {
+		return *sTypes[index];
 	}
+#endif
 }; // class TypeDescriptor
 
+/**
+ * A type descriptor generated at compile time, for types whose pointer offsets are known as constant
+ * expressions (usually with `offsetof`). Unlike descriptors created by {@link TypeDescriptor::make}, it
+ * needs no dynamic initialization or heap allocation: a `constexpr` object holds the descriptor directly
+ * followed by the pointer offsets and the end sentinel, in the same layout as a dynamically allocated one.
+ * 
+ * The object converts to the {@link TypeDescriptor} it contains, so it can be used in place of one:
+ * 
+ *     constexpr ssw::StaticTypeDescriptor<Node, offsetof(Node, next)> nodeType{"Node"};
+ *     const ssw::TypeDescriptor &Node::type = nodeType;
+ * 
+ * @tparam T The type to describe, which must be complete where the descriptor is defined.
+ * @tparam Offsets The offsets, within `T` objects, of pointers to other managed objects.
+ */
+template <typename T, std::ptrdiff_t... Offsets>
+class StaticTypeDescriptor
+{
+	static constexpr std::size_t NumOffsets = sizeof...(Offsets);
+	
+	TypeDescriptor mDescriptor;
+	std::ptrdiff_t mOffsets[NumOffsets + 1];
+	
+public:
+	
+	/**
+	 * Initialize the descriptor.
+	 * 
+	 * @param name (optional) The name of the described type, which must outlive the descriptor.
+	 */
+	constexpr explicit StaticTypeDescriptor(const char *name = nullptr) noexcept
+			: mDescriptor(name, sizeof(T), TypeDescriptor::destructorOf<T>(), NumOffsets),
+			  mOffsets{Offsets..., -static_cast<std::ptrdiff_t>(
+					  TypeDescriptor::listOffset() + NumOffsets * sizeof(std::ptrdiff_t))} {
+		static_assert(std::is_standard_layout<StaticTypeDescriptor>::value,
+				"StaticTypeDescriptor must be standard-layout.");
+		static_assert(sizeof(TypeDescriptor) == TypeDescriptor::listOffset(),
+				"The pointer offsets must directly follow the descriptor.");
+		static_assert(alignof(T) <= TypeDescriptor::MaxAlign, "Managed types must not be over-aligned for the heap.");
+	}
+	
+	StaticTypeDescriptor(const StaticTypeDescriptor&) = delete;
+	StaticTypeDescriptor& operator=(const StaticTypeDescriptor&) = delete;
+	
+	/**
+	 * Get the type descriptor.
+	 */
+	constexpr const TypeDescriptor& descriptor() const noexcept {
+		return mDescriptor;
+	}
+	
+	constexpr operator const TypeDescriptor&() const noexcept {
+		return mDescriptor;
+	}
+}; // class StaticTypeDescriptor
+
 } // namespace ssw
 
 #endif /* TYPEDESCRIPTOR_HPP_ */
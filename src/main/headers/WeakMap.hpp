@@ -0,0 +1,171 @@
+/**
+ * @file    WeakMap.hpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the {@link WeakMap} class.
+ */
+
+#ifndef WEAKMAP_HPP_
+#define WEAKMAP_HPP_
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Heap.hpp"
+
+namespace ssw {
+
+/**
+ * A hash map keyed by managed objects that does not keep its keys alive, e.g. for lookup caches.
+ * 
+ * Keys are held by weak references (see {@link HeapBase::addWeakRef}) and compared by identity. When garbage
+ * collection finds a key unreachable, its entry is dropped as part of the collection and its value is
+ * destroyed; when a key is moved, its entry follows it. Values are held strongly, so a value must not keep
+ * its own key alive, or the entry is never dropped.
+ * 
+ * All operations take the heap lock, since garbage collection may update the map from any thread. Values are
+ * destroyed with the heap lock held by the collecting thread, so their destructors must not allocate from the
+ * heap (removing roots is fine).
+ * 
+ * @tparam K The type of the keys, must have a member type `HeapType` (see {@link HeapObject}).
+ * @tparam V The type of the values.
+ */
+template <typename K, typename V>
+class WeakMap : HeapBase::WeakTable
+{
+	struct Entry {
+		/** The handle of the weak reference to the key. */
+		std::size_t handle;
+		V value;
+	};
+	
+	/** The heap of the keys. */
+	HeapBase &mHeap;
+	/** The entries by the address of their key as of the last update. */
+	std::unordered_map<const K*, Entry> mEntries;
+	
+	void weakRefsUpdated() noexcept override {
+		// Moved entries are inserted again after all stale addresses have been removed
+		std::vector<std::pair<const K*, Entry>> moved;
+		for(auto it = mEntries.begin(); it != mEntries.end();) {
+			const auto key = static_cast<const K*>(mHeap.weakRef(it->second.handle));
+			if(key == it->first) {
+				++it;
+				continue;
+			}
+			
+			if(key) {
+				moved.emplace_back(key, std::move(it->second));
+			} else {
+				mHeap.removeWeakRef(it->second.handle);
+			}
+			it = mEntries.erase(it);
+		}
+		for(auto &entry : moved) {
+			mEntries.emplace(entry.first, std::move(entry.second));
+		}
+	}
+	
+public:
+	
+	/**
+	 * Create an empty map for keys in the heap of `K`.
+	 */
+	WeakMap() : mHeap(K::HeapType::instance()) {
+		mHeap.addWeakTable(*this);
+	}
+	
+	WeakMap(const WeakMap&) = delete;
+	WeakMap& operator=(const WeakMap&) = delete;
+	
+	~WeakMap() {
+		this->clear();
+		mHeap.removeWeakTable(*this);
+	}
+	
+	/**
+	 * Insert an entry, or replace the value if there already is an entry for the key.
+	 * 
+	 * @param key The key, must not be `nullptr`.
+	 * @param value The value.
+	 */
+	void insert(const K *key, V value) {
+		assert(key);
+		std::lock_guard<std::recursive_mutex> lock{mutex(mHeap)};
+		auto it = mEntries.find(key);
+		if(it != mEntries.end()) {
+			it->second.value = std::move(value);
+		} else {
+			mEntries.emplace(key, Entry{mHeap.addWeakRef(const_cast<K*>(key)), std::move(value)});
+		}
+	}
+	
+	/**
+	 * Get a copy of the value of the entry for the specified key.
+	 * 
+	 * @param key The key.
+	 * @param value Set to the value if there is an entry for the key.
+	 * @return `true` if there is an entry for the key, `false` otherwise.
+	 */
+	bool find(const K *key, V &value) const {
+		std::lock_guard<std::recursive_mutex> lock{mutex(mHeap)};
+		auto it = mEntries.find(key);
+		if(it == mEntries.end()) {
+			return false;
+		}
+		value = it->second.value;
+		return true;
+	}
+	
+	/**
+	 * Check whether there is an entry for the specified key.
+	 */
+	bool contains(const K *key) const {
+		std::lock_guard<std::recursive_mutex> lock{mutex(mHeap)};
+		return mEntries.count(key) != 0;
+	}
+	
+	/**
+	 * Remove the entry for the specified key, if any.
+	 * 
+	 * @return `true` if an entry was removed, `false` otherwise.
+	 */
+	bool erase(const K *key) {
+		std::lock_guard<std::recursive_mutex> lock{mutex(mHeap)};
+		auto it = mEntries.find(key);
+		if(it == mEntries.end()) {
+			return false;
+		}
+		mHeap.removeWeakRef(it->second.handle);
+		mEntries.erase(it);
+		return true;
+	}
+	
+	/**
+	 * Remove all entries.
+	 */
+	void clear() {
+		std::lock_guard<std::recursive_mutex> lock{mutex(mHeap)};
+		for(auto &entry : mEntries) {
+			mHeap.removeWeakRef(entry.second.handle);
+		}
+		mEntries.clear();
+	}
+	
+	/**
+	 * Get the number of entries, including those whose keys became unreachable since the last collection.
+	 */
+	std::size_t size() const {
+		std::lock_guard<std::recursive_mutex> lock{mutex(mHeap)};
+		return mEntries.size();
+	}
+}; // class WeakMap
+
+} // namespace ssw
+
+#endif /* WEAKMAP_HPP_ */
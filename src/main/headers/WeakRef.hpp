@@ -0,0 +1,95 @@
+/**
+ * @file    WeakRef.hpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the {@link WeakRef} class.
+ */
+
+#ifndef WEAKREF_HPP_
+#define WEAKREF_HPP_
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace ssw {
+
+/**
+ * A weak reference to a managed object, which does not keep the object alive.
+ * 
+ * A `WeakRef<T>` behaves like a `T*` that garbage collection sets to `nullptr` once the object is no longer
+ * reachable from the roots, and updates when the object is moved (see {@link HeapBase::addWeakRef}). The
+ * object is not destroyed before the reference is cleared, so a non-null result of {@link get} is valid
+ * until the next garbage collection, like any other raw pointer. Keep it in a {@link Local} or a
+ * {@link Member} to keep the object alive beyond that.
+ * 
+ * @tparam T The type of the referenced objects, must have a member type `HeapType` (see {@link HeapObject}).
+ */
+template <typename T>
+class WeakRef
+{
+	std::size_t mHandle;
+	
+	/**
+	 * Get the heap this reference is registered with.
+	 */
+	static auto& heap() noexcept {
+		return T::HeapType::instance();
+	}
+	
+public:
+	
+	WeakRef() noexcept : mHandle(T::HeapType::NoRootHandle) {
+	}
+	
+	WeakRef(T *ptr) noexcept : mHandle(ptr ? heap().addWeakRef(ptr) : T::HeapType::NoRootHandle) {
+	}
+	
+	WeakRef(const WeakRef &other) noexcept : WeakRef(other.get()) {
+	}
+	
+	WeakRef(WeakRef &&other) noexcept : mHandle(std::exchange(other.mHandle, T::HeapType::NoRootHandle)) {
+	}
+	
+	~WeakRef() {
+		if(mHandle != T::HeapType::NoRootHandle) {
+			heap().removeWeakRef(mHandle);
+		}
+	}
+	
+	WeakRef& operator=(T *ptr) noexcept {
+		if(mHandle != T::HeapType::NoRootHandle) {
+			heap().weakRef(mHandle, ptr);
+		} else if(ptr) {
+			mHandle = heap().addWeakRef(ptr);
+		}
+		return *this;
+	}
+	
+	WeakRef& operator=(const WeakRef &other) noexcept {
+		return *this = other.get();
+	}
+	
+	WeakRef& operator=(WeakRef &&other) noexcept {
+		std::swap(mHandle, other.mHandle);
+		return *this;
+	}
+	
+	/**
+	 * Get the referenced object, or `nullptr` if the reference is empty or was cleared.
+	 */
+	T* get() const noexcept {
+		return mHandle == T::HeapType::NoRootHandle ? nullptr : static_cast<T*>(heap().weakRef(mHandle));
+	}
+	
+	/**
+	 * Check whether the reference was cleared by garbage collection (or is empty).
+	 */
+	bool expired() const noexcept {
+		return !this->get();
+	}
+}; // class WeakRef
+
+} // namespace ssw
+
+#endif /* WEAKREF_HPP_ */
@@ -0,0 +1,96 @@
+/**
+ * @file    main.cpp
+ * @author  niob
+ * @date    Oct 14, 2026
+ * @brief   Implements a tool that reports the largest retained sizes in a binary heap snapshot.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "HeapSnapshot.hpp"
+
+namespace {
+
+const char* typeName(const ssw::HeapSnapshot &snapshot, const ssw::HeapSnapshot::Object &obj) {
+	const auto &name = snapshot.types()[obj.type].name;
+	return name.empty() ? "<unnamed>" : name.c_str();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	if(argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <snapshot> [count]\n";
+		return 2;
+	}
+	const std::size_t count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+	
+	std::ifstream is{argv[1], std::ios::binary};
+	ssw::HeapSnapshot snapshot;
+	if(!snapshot.read(is)) {
+		std::cerr << "Cannot read heap snapshot " << argv[1] << '\n';
+		return 1;
+	}
+	snapshot.computeDominators();
+	const auto &objects = snapshot.objects();
+	
+	std::size_t numReachable = 0;
+	std::uint64_t totalSize = 0;
+	struct TypeSummary {
+		std::size_t count;
+		std::uint64_t size;
+	};
+	std::vector<TypeSummary> types(snapshot.types().size(), TypeSummary{0, 0});
+	std::vector<std::size_t> byRetained;
+	for(std::size_t i = 0; i < objects.size(); i++) {
+		totalSize += objects[i].size;
+		if(objects[i].dominator != ssw::HeapSnapshot::Unreachable) {
+			numReachable++;
+			types[objects[i].type].count++;
+			types[objects[i].type].size += objects[i].size;
+			byRetained.push_back(i);
+		}
+	}
+	
+	std::cout << objects.size() << " objects (" << totalSize << " bytes), " << numReachable << " reachable ("
+			<< snapshot.reachableSize() << " bytes) from " << snapshot.roots().size() << " roots\n\n";
+	
+	const auto top = std::min(count, byRetained.size());
+	std::partial_sort(byRetained.begin(), byRetained.begin() + top, byRetained.end(),
+			[&objects](std::size_t a, std::size_t b) {
+		return objects[a].retainedSize > objects[b].retainedSize;
+	});
+	std::cout << "= Largest Retained Sizes =\nRetained    Shallow     Address             Type\n";
+	for(std::size_t i = 0; i < top; i++) {
+		const auto &obj = objects[byRetained[i]];
+		std::cout << std::left << std::setw(12) << obj.retainedSize << std::setw(12) << obj.size
+				<< "0x" << std::setw(18) << std::hex << obj.address << std::dec << typeName(snapshot, obj);
+		if(obj.flags & ssw::HeapSnapshot::ArrayFlag) {
+			std::cout << '[' << obj.length << ']';
+		}
+		std::cout << '\n';
+	}
+	
+	std::vector<std::size_t> typeOrder;
+	for(std::size_t i = 0; i < types.size(); i++) {
+		if(types[i].count) {
+			typeOrder.push_back(i);
+		}
+	}
+	std::sort(typeOrder.begin(), typeOrder.end(), [&types](std::size_t a, std::size_t b) {
+		return types[a].size > types[b].size;
+	});
+	std::cout << "\n= Reachable Objects by Type =\nCount       Size        Type\n";
+	for(std::size_t i = 0; i < std::min(count, typeOrder.size()); i++) {
+		const auto &type = snapshot.types()[typeOrder[i]];
+		std::cout << std::setw(12) << types[typeOrder[i]].count << std::setw(12) << types[typeOrder[i]].size
+				<< (type.name.empty() ? "<unnamed>" : type.name.c_str()) << '\n';
+	}
+	return 0;
+}
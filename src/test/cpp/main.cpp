@@ -11,6 +11,7 @@
 
 #include "Heap.hpp"
 #include "HeapObject.hpp"
+#include "Member.hpp"
 
 // The heap type needs to be specified whenever creating another HeapObject class
 using H = ssw::Heap<50 * 1024>;
@@ -24,8 +25,9 @@ struct StudentNode : public ssw::HeapObject<StudentNode, H>
 	// Managed objects must specify a static member variable `type` so inherited operator `new` can be used
 	static const ssw::TypeDescriptor &type;
 	
-	StudentNode *next;
-	Student *student;
+	// Pointer fields are wrapped in Member, so stores are recorded by the write barrier
+	ssw::Member<StudentNode> next;
+	ssw::Member<Student> student;
 	
 	StudentNode(Student *student, StudentNode *next = nullptr)
 			: next(next), student(student) {
@@ -33,34 +35,34 @@ struct StudentNode : public ssw::HeapObject<StudentNode, H>
 };
 
 // Use TypeDescriptor::make for creating the type descriptor object, which needs to be allocated dynamically
-const ssw::TypeDescriptor &StudentNode::type = *ssw::TypeDescriptor::make<StudentNode>({
-	// This only works with standard-layout types unfortunately
-	offsetof(StudentNode, next),
-	offsetof(StudentNode, student)
-});
+const ssw::TypeDescriptor &StudentNode::type = *ssw::TypeDescriptor::make<StudentNode>(
+	// Pointer fields are given as pointers to members, which may be raw pointers or Member fields
+	&StudentNode::next,
+	&StudentNode::student
+);
 
 struct LectureNode : public ssw::HeapObject<LectureNode, H>
 {
 	static const ssw::TypeDescriptor &type;
 	
-	LectureNode *next;
-	Lecture *lecture;
+	ssw::Member<LectureNode> next;
+	ssw::Member<Lecture> lecture;
 	
 	LectureNode(Lecture *lecture, LectureNode *next = nullptr)
 			: next(next), lecture(lecture) {
 	}
 };
 
-const ssw::TypeDescriptor &LectureNode::type = *ssw::TypeDescriptor::make<LectureNode>({
-	offsetof(LectureNode, next),
-	offsetof(LectureNode, lecture)
-});
+const ssw::TypeDescriptor &LectureNode::type = *ssw::TypeDescriptor::make<LectureNode>(
+	&LectureNode::next,
+	&LectureNode::lecture
+);
 
 struct StudentList : public ssw::HeapObject<StudentList, H>
 {
 	static const ssw::TypeDescriptor &type;
 	
-	StudentNode *first = nullptr;
+	ssw::Member<StudentNode> first;
 	
 	void add(Student *student) {
 		first = new StudentNode(student, first);
@@ -80,9 +82,7 @@ struct StudentList : public ssw::HeapObject<StudentList, H>
 	}
 };
 
-const ssw::TypeDescriptor &StudentList::type = *ssw::TypeDescriptor::make<StudentList>({
-	offsetof(StudentList, first)
-});
+const ssw::TypeDescriptor &StudentList::type = *ssw::TypeDescriptor::make<StudentList>(&StudentList::first);
 
 struct Student : public ssw::HeapObject<Student, H>
 {
@@ -90,7 +90,7 @@ struct Student : public ssw::HeapObject<Student, H>
 	
 	int id;
 	const char *name;
-	LectureNode *lectures;
+	ssw::Member<LectureNode> lectures;
 	
 	Student(int id, const char *name)
 			: id(id), name(name), lectures(nullptr) {
@@ -114,9 +114,7 @@ struct Student : public ssw::HeapObject<Student, H>
 	}
 };
 
-const ssw::TypeDescriptor &Student::type = *ssw::TypeDescriptor::make<Student>({
-	offsetof(Student, lectures)
-});
+const ssw::TypeDescriptor &Student::type = *ssw::TypeDescriptor::make<Student>(&Student::lectures);
 
 struct Lecture : public ssw::HeapObject<Lecture, H>
 {
@@ -131,7 +129,9 @@ struct Lecture : public ssw::HeapObject<Lecture, H>
 	}
 };
 
-const ssw::TypeDescriptor &Lecture::type = *ssw::TypeDescriptor::make<Lecture>();
+// Type descriptors can also be generated at compile time, with pointer offsets as template arguments
+constexpr ssw::StaticTypeDescriptor<Lecture> lectureType{"Lecture"};
+const ssw::TypeDescriptor &Lecture::type = lectureType;
 
 int main(int, char**) {
 	std::cout << "Heap after creation without anything allocated yet:\n";
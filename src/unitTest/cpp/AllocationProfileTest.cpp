@@ -0,0 +1,85 @@
+/**
+ * @file    AllocationProfileTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests the allocation profile.
+ */
+
+#include <cstddef>
+
+#include "AllocationProfile.hpp"
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/**
+ * Get the counters of the node type from the specified profile, or `nullptr` if there are none.
+ */
+const AllocationProfile::Type* nodeCounters(const AllocationProfile &profile) {
+	for(const auto &type : profile.types) {
+		if(type.type == &Node::type) {
+			return &type;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Allocate nodes with profiling and sampling enabled, keeping every other one alive, and check the profile
+ * before and after a collection.
+ */
+void checkProfile(std::size_t tlabSize) {
+	DynamicHeap heap{4 * 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.tlabSize(tlabSize);
+	heap.profileAllocations(true);
+	heap.allocationSampleInterval(1024);
+	
+	const std::size_t count = 10000;
+	Local<Node> list{nullptr};
+	for(std::size_t i = 0; i < count; i++) {
+		Node *node = new Node(i);
+		if(i % 2) {
+			node->left = list;
+			list = node;
+		}
+	}
+	
+	auto profile = heap.allocationProfile();
+	auto counters = nodeCounters(profile);
+	SSW_CHECK(counters && counters->allocations == count && counters->bytes == count * sizeof(Node));
+	SSW_CHECK(counters && counters->liveObjects == count);
+	SSW_CHECK(!profile.sites.empty());
+	std::size_t samples = 0;
+	for(const auto &site : profile.sites) {
+		SSW_CHECK(site.type == &Node::type);
+		samples += site.samples;
+	}
+	// Objects from allocation buffers count against a countdown of their own, the others against that of the heap
+	const auto expected = count * sizeof(Node) / 1024;
+	SSW_CHECK(samples + 2 >= expected && samples <= expected);
+	
+	heap.gc();
+	profile = heap.allocationProfile();
+	counters = nodeCounters(profile);
+	SSW_CHECK(counters && counters->liveObjects == count / 2 && counters->survivors == count / 2);
+	SSW_CHECK(profile.collections == 1);
+}
+
+} // namespace
+
+SSW_TEST(allocationProfileCountsObjects) {
+	checkProfile(0);
+}
+
+SSW_TEST(allocationProfileCountsObjectsInAllocationBuffers) {
+	checkProfile(16 * 1024);
+}
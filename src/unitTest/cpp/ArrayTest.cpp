@@ -0,0 +1,191 @@
+/**
+ * @file    ArrayTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests managed arrays.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "Array.hpp"
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::Slot;
+
+namespace {
+
+/**
+ * An element with a destructor, which counts how many elements are alive.
+ */
+struct Counted
+{
+	using HeapType = ThreadHeap;
+	static const TypeDescriptor &type;
+	static std::size_t live;
+	
+	Member<Node> node;
+	
+	Counted()
+			: node(nullptr) {
+		live++;
+	}
+	
+	~Counted() {
+		live--;
+	}
+};
+
+const TypeDescriptor &Counted::type = *TypeDescriptor::make<Counted>(&Counted::node);
+std::size_t Counted::live = 0;
+
+/**
+ * An element that references another array.
+ */
+struct Row
+{
+	using HeapType = ThreadHeap;
+	static const TypeDescriptor &type;
+	
+	Member<Array<Slot>> slots;
+};
+
+const TypeDescriptor &Row::type = *TypeDescriptor::make<Row>(&Row::slots);
+
+/**
+ * Allocate an array of the specified length whose elements are the only references to new nodes with the
+ * indexes as ids, then check that garbage collection keeps exactly these nodes and destroys every element
+ * once the array is garbage.
+ */
+void checkArrayOfLength(std::size_t length) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	Counted::live = 0;
+	
+	Local<Array<Counted>> array{Array<Counted>::make(length)};
+	SSW_CHECK(array->length() == length && array->end() - array->begin() == std::ptrdiff_t(length));
+	SSW_CHECK(Counted::live == length);
+	for(std::size_t i = 0; i < length; i++) {
+		SSW_CHECK(!(*array)[i].node);
+		(*array)[i].node = new Node(i);
+	}
+	new Node(SIZE_MAX);
+	
+	heap.gc();
+	SSW_CHECK(Node::live == length && Counted::live == length);
+	for(std::size_t i = 0; i < length; i++) {
+		SSW_CHECK((*array)[i].node->intact(i));
+	}
+	
+	array = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0 && Counted::live == 0);
+}
+
+} // namespace
+
+SSW_TEST(arraysOfAnyLengthKeepTheirElementsAlive) {
+	checkArrayOfLength(0);
+	checkArrayOfLength(1);
+	checkArrayOfLength(1000);
+}
+
+SSW_TEST(nestedArraysAreTraced) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	constexpr std::size_t Rows = 10;
+	constexpr std::size_t Columns = 20;
+	
+	Local<Array<Row>> rows{Array<Row>::make(Rows)};
+	for(std::size_t i = 0; i < Rows; i++) {
+		(*rows)[i].slots = Array<Slot>::make(Columns);
+		for(std::size_t j = 0; j < Columns; j++) {
+			(*(*rows)[i].slots)[j].node = new Node(i * Columns + j);
+		}
+		Array<Slot>::make(Columns);
+	}
+	
+	heap.gc();
+	SSW_CHECK(Node::live == Rows * Columns);
+	for(std::size_t i = 0; i < Rows; i++) {
+		for(std::size_t j = 0; j < Columns; j++) {
+			SSW_CHECK((*(*rows)[i].slots)[j].node->intact(i * Columns + j));
+		}
+	}
+	
+	// Dropping an inner array only frees its row
+	(*rows)[0].slots = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == (Rows - 1) * Columns);
+	
+	rows = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(arrayIsTheOnlyPathToItsElementsInEveryCollection) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(64 * 1024);
+	Node::live = 0;
+	constexpr std::size_t Length = 100;
+	
+	// Leaves a gap in the old generation for compaction
+	Array<Slot>::make(Length);
+	// Arrays are old, so their young elements are only found through the remembered set
+	Local<Array<Slot>> array{Array<Slot>::make(Length)};
+	const Array<Slot> *address = array;
+	for(std::size_t i = 0; i < Length; i++) {
+		(*array)[i].node = new Node(i);
+		new Node(SIZE_MAX);
+	}
+	const Node *young = (*array)[0].node;
+	heap.minorGc();
+	SSW_CHECK(Node::live == Length);
+	SSW_CHECK((*array)[0].node != young);
+	for(std::size_t i = 0; i < Length; i++) {
+		SSW_CHECK((*array)[i].node->intact(i));
+	}
+	
+	// Compaction moves the array and the elements, the local and the elements are updated
+	for(std::size_t i = 0; i < 1000; i++) {
+		new Node(SIZE_MAX);
+	}
+	heap.compact();
+	SSW_CHECK(Node::live == Length);
+	SSW_CHECK(array != address && array->length() == Length);
+	for(std::size_t i = 0; i < Length; i++) {
+		SSW_CHECK((*array)[i].node->intact(i));
+	}
+	
+	array = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(arrayLengthOverflowIsRejected) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	const auto before = heap.stats();
+	
+	SSW_CHECK(!heap.allocateArray(Slot::type, SIZE_MAX));
+	SSW_CHECK(!heap.allocateArray(Slot::type, SIZE_MAX / sizeof(Slot)));
+	bool thrown = false;
+	try {
+		Array<Slot>::make(SIZE_MAX / sizeof(Slot) + 1);
+	} catch(const std::bad_alloc&) {
+		thrown = true;
+	}
+	SSW_CHECK(thrown);
+	SSW_CHECK(heap.stats().numObjects == before.numObjects && heap.stats().usedSize == before.usedSize);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file    BatchAllocationTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests allocating several objects of a type at once.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestHeap.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::TestHeap;
+
+namespace {
+
+/** The distance between consecutive blocks holding nodes. */
+constexpr std::size_t NodeBlockSize = HeapBase::Align + (sizeof(Node) + HeapBase::Align - 1) / HeapBase::Align
+		* HeapBase::Align;
+
+/**
+ * Construct nodes in the specified batch with consecutive ids starting at `firstId`, and link those for which
+ * `keep` returns `true` into a list after the specified head.
+ */
+template <typename F>
+void construct(const std::vector<void*> &objects, std::size_t count, std::size_t firstId, Local<Node> &head,
+		F keep) {
+	for(std::size_t i = 0; i < count; i++) {
+		Node *node = ::new(objects[i]) Node(firstId + i);
+		if(keep(i)) {
+			node->left = head;
+			head = node;
+		}
+	}
+}
+
+/**
+ * Check that the first `count` objects of the specified batch do not overlap, and that the rest is `nullptr`.
+ */
+bool disjoint(const std::vector<void*> &objects, std::size_t count) {
+	std::vector<const char*> sorted;
+	for(std::size_t i = 0; i < count; i++) {
+		sorted.push_back(static_cast<const char*>(objects[i]));
+	}
+	std::sort(sorted.begin(), sorted.end());
+	for(std::size_t i = 1; i < sorted.size(); i++) {
+		if(!sorted[i - 1] || sorted[i] - sorted[i - 1] < std::ptrdiff_t(NodeBlockSize)) {
+			return false;
+		}
+	}
+	return std::all_of(objects.begin() + count, objects.end(), [](void *obj) { return !obj; });
+}
+
+/**
+ * Count the nodes in the list starting at the specified one, checking that none of them was overwritten.
+ */
+std::size_t countIntact(const Node *node) {
+	std::size_t count = 0;
+	for(; node; node = node->left, count++) {
+		SSW_CHECK(node->check == ~node->id);
+	}
+	return count;
+}
+
+} // namespace
+
+SSW_TEST(batchAllocatesDistinctObjectsNextToEachOther) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	constexpr std::size_t Count = 1000;
+	const auto before = heap.stats();
+	
+	std::vector<void*> objects(Count);
+	SSW_CHECK(heap.allocateBatch(Node::type, Count, objects.data()) == Count);
+	// Carved from a single free block in allocation order
+	for(std::size_t i = 1; i < Count; i++) {
+		const auto distance = static_cast<char*>(objects[i]) - static_cast<char*>(objects[i - 1]);
+		SSW_CHECK(distance == std::ptrdiff_t(NodeBlockSize));
+	}
+	const auto after = heap.stats();
+	SSW_CHECK(after.numObjects - before.numObjects == Count);
+	SSW_CHECK(after.objectSize - before.objectSize == Count * sizeof(Node));
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	Local<Node> list;
+	construct(objects, Count, 0, list, [](std::size_t i) { return i % 2 == 0; });
+	heap.gc();
+	SSW_CHECK(Node::live == Count / 2 && countIntact(list) == Count / 2);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+}
+
+SSW_TEST(batchSpansSeveralFreeBlocks) {
+	constexpr std::size_t Size = 256 * 1024;
+	TestHeap heap{Size, Size};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	constexpr std::size_t Gap = 10;
+	
+	// Fill the heap, the entries for objects that do not fit are cleared
+	std::vector<void*> objects(Size / sizeof(Node), &heap);
+	const auto filled = heap.allocateBatch(Node::type, objects.size(), objects.data());
+	SSW_CHECK(filled > 0 && filled < objects.size() && disjoint(objects, filled));
+	SSW_CHECK(heap.stats().freeSize < (Gap + 1) * NodeBlockSize);
+	
+	// Leave gaps of a few nodes between kept ones
+	Local<Node> kept;
+	construct(objects, filled, 0, kept, [](std::size_t i) { return i % (Gap + 1) == 0; });
+	heap.gc();
+	const auto numKept = (filled + Gap) / (Gap + 1);
+	SSW_CHECK(Node::live == numKept);
+	
+	// The batch is carved from one gap after the other
+	constexpr std::size_t Count = 50 * Gap + 5;
+	objects.assign(Count, &heap);
+	SSW_CHECK(heap.allocateBatch(Node::type, Count, objects.data()) == Count);
+	SSW_CHECK(disjoint(objects, Count));
+	Local<Node> batch;
+	construct(objects, Count, filled, batch, [](std::size_t) { return true; });
+	SSW_CHECK(countIntact(kept) == numKept && countIntact(batch) == Count);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	heap.gc();
+	SSW_CHECK(Node::live == numKept + Count);
+	SSW_CHECK(countIntact(kept) == numKept && countIntact(batch) == Count);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+}
@@ -0,0 +1,158 @@
+/**
+ * @file    CompactHeaderTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests compact block headers, which are only used if the library is built with
+ *          `SSW_COMPACT_HEADERS=1`.
+ */
+
+#include "TypeDescriptor.hpp"
+
+#if SSW_COMPACT_HEADERS
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/**
+ * An object with the largest number of pointer fields that fits the field cursor of compact headers.
+ */
+struct Wide : public HeapObject<Wide, ThreadHeap>
+{
+	static const TypeDescriptor &type;
+	
+	Member<Node> fields[TypeDescriptor::MaxOffsets];
+};
+
+template <typename Indexes>
+struct WideDescriptor;
+
+template <std::size_t... Indexes>
+struct WideDescriptor<std::index_sequence<Indexes...>>
+{
+	using Type = StaticTypeDescriptor<Wide, std::ptrdiff_t(Indexes * sizeof(Member<Node>))...>;
+};
+
+const WideDescriptor<std::make_index_sequence<TypeDescriptor::MaxOffsets>>::Type wideType{"Wide"};
+const TypeDescriptor &Wide::type = wideType;
+
+/**
+ * Objects of one to three words, to compare their block sizes.
+ */
+template <std::size_t Words>
+struct Small : public HeapObject<Small<Words>, ThreadHeap>
+{
+	static const TypeDescriptor &type;
+	
+	std::size_t data[Words];
+};
+
+template <std::size_t Words>
+const TypeDescriptor &Small<Words>::type = *TypeDescriptor::make<Small<Words>>();
+
+/**
+ * Get the number of bytes that allocating a `T` adds to the used size of the heap of the running thread.
+ */
+template <typename T, typename... Args>
+std::size_t usedSizeOf(Args... args) {
+	auto &heap = ThreadHeap::instance();
+	const auto before = heap.stats();
+	new T(args...);
+	const auto after = heap.stats();
+	SSW_CHECK(after.objectSize - before.objectSize == sizeof(T));
+	return after.usedSize - before.usedSize;
+}
+
+} // namespace
+
+SSW_TEST(typeIndexesAreAssignedOnFirstUse) {
+	const TypeDescriptor &first = *TypeDescriptor::make<Small<1>>();
+	const TypeDescriptor &second = *TypeDescriptor::make<Small<1>>();
+	
+	// Indexes are assigned in the order of first use, not of creation
+	const auto index = second.index();
+	SSW_CHECK(index > 0 && index <= TypeDescriptor::MaxIndex);
+	SSW_CHECK(first.index() == index + 1 && second.index() == index);
+	SSW_CHECK(&TypeDescriptor::byIndex(index) == &second && &TypeDescriptor::byIndex(index + 1) == &first);
+	
+	// Threads racing for the first use of the same descriptors agree on their indexes
+	constexpr std::size_t Threads = 4;
+	constexpr std::size_t Types = 100;
+	std::vector<const TypeDescriptor*> types;
+	for(std::size_t i = 0; i < Types; i++) {
+		types.push_back(TypeDescriptor::make<Small<2>>());
+	}
+	std::vector<std::vector<std::uint32_t>> indexes(Threads);
+	std::vector<std::thread> threads;
+	for(std::size_t t = 0; t < Threads; t++) {
+		threads.emplace_back([&types, &result = indexes[t]] {
+			for(auto type : types) {
+				result.push_back(type->index());
+			}
+		});
+	}
+	for(auto &thread : threads) {
+		thread.join();
+	}
+	std::unordered_set<std::uint32_t> distinct;
+	for(std::size_t i = 0; i < Types; i++) {
+		for(std::size_t t = 1; t < Threads; t++) {
+			SSW_CHECK(indexes[t][i] == indexes[0][i]);
+		}
+		SSW_CHECK(&TypeDescriptor::byIndex(indexes[0][i]) == types[i]);
+		distinct.insert(indexes[0][i]);
+	}
+	SSW_CHECK(distinct.size() == Types);
+}
+
+SSW_TEST(typesWithTheMostPointerFieldsAreTraced) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(64 * 1024);
+	Node::live = 0;
+	
+	Local<Wide> wide{new Wide()};
+	for(std::size_t i = 0; i < TypeDescriptor::MaxOffsets; i++) {
+		wide->fields[i] = new Node(i);
+	}
+	heap.minorGc();
+	heap.gc();
+	// The mark stack is not used by Deutsch-Schorr-Waite marking, which records the field in the header
+	heap.markStackSize(0);
+	heap.gc();
+	SSW_CHECK(Node::live == TypeDescriptor::MaxOffsets);
+	for(std::size_t i = 0; i < TypeDescriptor::MaxOffsets; i++) {
+		SSW_CHECK(wide->fields[i]->intact(i));
+	}
+	
+	wide = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(blocksHaveEightByteHeaders) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	
+	// Blocks are at least two words long, to hold the boundary tags once they are free
+	SSW_CHECK(HeapBase::Align == 8);
+	SSW_CHECK(usedSizeOf<Small<1>>() == 24);
+	SSW_CHECK(usedSizeOf<Small<2>>() == 24);
+	SSW_CHECK(usedSizeOf<Small<3>>() == 32);
+	SSW_CHECK(usedSizeOf<Node>(0) == sizeof(Node) + 8);
+}
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file    CompactTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests compaction of the old generation.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Root.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+#include "WeakRef.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/**
+ * Allocate the specified number of nodes that are garbage right away, which leaves gaps to compact.
+ */
+void allocateGarbage(std::size_t count) {
+	for(std::size_t i = 0; i < count; i++) {
+		new Node(SIZE_MAX);
+	}
+}
+
+} // namespace
+
+SSW_TEST(compactUpdatesAllKindsOfReferences) {
+	// The storage cannot shrink, so the statistics can be compared
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	allocateGarbage(100);
+	Root<Node> root{new Node(1)};
+	allocateGarbage(100);
+	Local<Node> local{new Node(2)};
+	allocateGarbage(100);
+	// Only reachable through members
+	root->left = new Node(3);
+	allocateGarbage(100);
+	root->left->left = new Node(4);
+	root->left->left->right = root;
+	allocateGarbage(100);
+	WeakRef<Node> weak{root->left->left};
+	WeakRef<Node> cleared{new Node(5)};
+	
+	heap.gc();
+	SSW_CHECK(Node::live == 4);
+	SSW_CHECK(!cleared.get());
+	const auto before = heap.stats();
+	const Node *oldRoot = root;
+	const Node *oldLocal = local;
+	const Node *oldWeak = weak.get();
+	
+	heap.compact();
+	SSW_CHECK(Node::live == 4);
+	// The live objects are slid over the garbage in front of them
+	SSW_CHECK(root.get() < oldRoot && local.get() < oldLocal && weak.get() < oldWeak);
+	SSW_CHECK(root->intact(1) && local->intact(2));
+	SSW_CHECK(root->left->intact(3) && root->left->left == weak.get() && weak.get()->intact(4));
+	SSW_CHECK(weak.get()->right == root.get() && !weak.get()->left && !root->right && !local->left && !local->right);
+	
+	const auto after = heap.stats();
+	SSW_CHECK(after.heapSize == before.heapSize);
+	SSW_CHECK(after.usedSize == before.usedSize && after.freeSize == before.freeSize);
+	SSW_CHECK(after.numObjects == before.numObjects && after.objectSize == before.objectSize);
+	SSW_CHECK(after.numLiveObjects == before.numLiveObjects && after.liveObjectSize == before.liveObjectSize);
+	// All free space is in one block at the end
+	SSW_CHECK(before.numFreeBlocks > 1 && after.numFreeBlocks == 1);
+	
+	root = nullptr;
+	local = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0 && !weak.get());
+}
+
+SSW_TEST(compactDoesNotMovePinnedObjects) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	Local<Node> first{nullptr};
+	std::vector<Node*> pinned;
+	for(std::size_t i = 0; i < 8; i++) {
+		allocateGarbage(50);
+		Node *node = new Node(i);
+		node->left = first;
+		first = node;
+		if(i % 2) {
+			heap.pin(node);
+			pinned.push_back(node);
+		}
+	}
+	
+	heap.compact();
+	SSW_CHECK(Node::live == 8);
+	std::size_t i = 8;
+	for(Node *node = first; node; node = node->left) {
+		SSW_CHECK(node->intact(--i));
+		if(i % 2) {
+			SSW_CHECK(node == pinned[i / 2]);
+		}
+	}
+	SSW_CHECK(i == 0);
+	
+	for(auto node : pinned) {
+		heap.unpin(node);
+	}
+	first = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
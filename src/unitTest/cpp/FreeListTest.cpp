@@ -0,0 +1,246 @@
+/**
+ * @file    FreeListTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests the segregated free lists of the heap.
+ */
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Heap.hpp"
+#include "Local.hpp"
+#include "Test.hpp"
+#include "TestHeap.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::TestHeap;
+using test::allocateUnits;
+
+namespace {
+
+/** The number of size classes with exact block sizes, see `HeapBase::sizeClass`. */
+constexpr std::size_t ExactClasses = 16;
+
+/**
+ * Allocate a blob of the specified number of units followed by a small blob that is never freed, so
+ * freeing the first one does not coalesce it with the blocks after it.
+ */
+template <std::size_t Units>
+byte* allocateGuarded(HeapBase &heap) noexcept {
+	byte *result = allocateUnits<Units>(heap);
+	allocateUnits<1>(heap);
+	return result;
+}
+
+// One blob of every exact size class, from two units up, since the smallest block with compact headers is
+// two units large
+template <std::size_t... Indices>
+std::vector<byte*> allocateExactSizes(HeapBase &heap, std::index_sequence<Indices...>) {
+	return {allocateGuarded<Indices + 2>(heap)...};
+}
+
+// The same sizes without guards
+template <std::size_t... Indices>
+std::vector<byte*> reallocateExactSizes(HeapBase &heap, std::index_sequence<Indices...>) {
+	return {allocateUnits<Indices + 2>(heap)...};
+}
+
+} // namespace
+
+SSW_TEST(freeListsReuseBlocksOfExactSizeClasses) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	const auto sizes = std::make_index_sequence<ExactClasses - 1>();
+	
+	const auto blocks = allocateExactSizes(heap, sizes);
+	const auto before = heap.stats();
+	for(auto blk : blocks) {
+		SSW_CHECK(blk);
+		heap.deallocate(blk);
+	}
+	auto stats = heap.stats();
+	SSW_CHECK(stats.numFreeBlocks == before.numFreeBlocks + blocks.size());
+	// Two up to sixteen units
+	const std::size_t units = ExactClasses * (ExactClasses + 1) / 2 - 1;
+	SSW_CHECK(stats.freeBlockSize == before.freeBlockSize + units * HeapBase::Align);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	// Every block is taken from its own class, none of them is split off a larger block
+	SSW_CHECK(reallocateExactSizes(heap, sizes) == blocks);
+	stats = heap.stats();
+	SSW_CHECK(stats.numFreeBlocks == before.numFreeBlocks && stats.freeBlockSize == before.freeBlockSize);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+}
+
+SSW_TEST(freeListBinsAreSearchedFirstFit) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	const auto unit = HeapBase::Align;
+	
+	// The largest exact size, the smallest and largest sizes of the first bin, the smallest size of the
+	// second bin, and a size far above all of them
+	byte *exact = allocateGuarded<ExactClasses>(heap);
+	byte *first = allocateGuarded<ExactClasses + 1>(heap);
+	byte *last = allocateGuarded<2 * ExactClasses - 1>(heap);
+	byte *second = allocateGuarded<2 * ExactClasses>(heap);
+	byte *huge = allocateGuarded<4096>(heap);
+	for(auto blk : {exact, first, last, second, huge}) {
+		heap.deallocate(blk);
+	}
+	SSW_CHECK(heap.stats().numFreeBlocks == 6);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	SSW_CHECK(allocateUnits<ExactClasses>(heap) == exact);
+	// The most recently freed block of the bin comes first, it is large enough and is split
+	SSW_CHECK(allocateUnits<ExactClasses + 1>(heap) == last);
+	// The remaining block of the bin is too small, the next bin has one that fits exactly
+	SSW_CHECK(allocateUnits<2 * ExactClasses - 1>(heap) == second);
+	// Nothing is left in the second bin, so the next bin that has a block is used
+	SSW_CHECK(allocateUnits<2 * ExactClasses>(heap) == huge);
+	SSW_CHECK(allocateUnits<ExactClasses + 1>(heap) == first);
+	// What was split off the block of the first bin went to an exact class
+	SSW_CHECK(allocateUnits<ExactClasses - 3>(heap) == last + (ExactClasses + 2) * unit);
+	
+	// The rest of the huge block and the rest of the heap
+	SSW_CHECK(heap.stats().numFreeBlocks == 2);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+}
+
+SSW_TEST(collectedBlocksAreReusedBySizeClass) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	// Garbage of different sizes between live nodes, so collecting it leaves holes of exactly these sizes
+	Local<Node> list{new Node(0)};
+	const auto keep = [&list](std::size_t id) {
+		Node *node = new Node(id);
+		node->left = list;
+		list = node;
+	};
+	byte *tiny = allocateUnits<2>(heap);
+	keep(1);
+	byte *exact = allocateUnits<ExactClasses>(heap);
+	keep(2);
+	byte *bin = allocateUnits<ExactClasses + 1>(heap);
+	keep(3);
+	byte *larger = allocateUnits<40>(heap);
+	keep(4);
+	byte *huge = allocateUnits<4096>(heap);
+	keep(5);
+	const auto before = heap.stats();
+	
+	heap.gc();
+	SSW_CHECK(Node::live == 6);
+	auto stats = heap.stats();
+	SSW_CHECK(stats.numFreeBlocks == before.numFreeBlocks + 5);
+	const std::size_t units = 2 + ExactClasses + ExactClasses + 1 + 40 + 4096;
+	SSW_CHECK(stats.freeBlockSize == before.freeBlockSize + units * HeapBase::Align);
+	SSW_CHECK(stats.numObjects == 6 && heap.statsMatchHeapWalk());
+	
+	SSW_CHECK(allocateUnits<4096>(heap) == huge);
+	SSW_CHECK(allocateUnits<40>(heap) == larger);
+	SSW_CHECK(allocateUnits<ExactClasses + 1>(heap) == bin);
+	SSW_CHECK(allocateUnits<ExactClasses>(heap) == exact);
+	SSW_CHECK(allocateUnits<2>(heap) == tiny);
+	stats = heap.stats();
+	SSW_CHECK(stats.numFreeBlocks == before.numFreeBlocks && stats.freeBlockSize == before.freeBlockSize);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	list = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(deallocateCoalescesWithFreeNeighbours) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	const auto unit = HeapBase::Align;
+	
+	// Three adjacent blocks of four units each, merged blocks take their headers as well
+	const auto allocateTriple = [&heap](byte **blocks) {
+		for(int i = 0; i < 3; i++) {
+			blocks[i] = allocateUnits<4>(heap);
+		}
+		allocateUnits<1>(heap);
+	};
+	byte *left[3], *right[3], *both[3];
+	allocateTriple(left);
+	allocateTriple(right);
+	allocateTriple(both);
+	const auto before = heap.stats();
+	
+	// Free the left neighbour first, then the block: one block of nine units
+	heap.deallocate(left[0]);
+	heap.deallocate(left[1]);
+	SSW_CHECK(heap.stats().numFreeBlocks == before.numFreeBlocks + 1);
+	// Free the right neighbour first
+	heap.deallocate(right[2]);
+	heap.deallocate(right[1]);
+	SSW_CHECK(heap.stats().numFreeBlocks == before.numFreeBlocks + 2);
+	// Free both neighbours first: one block of fourteen units
+	heap.deallocate(both[0]);
+	heap.deallocate(both[2]);
+	SSW_CHECK(heap.stats().numFreeBlocks == before.numFreeBlocks + 4);
+	heap.deallocate(both[1]);
+	auto stats = heap.stats();
+	SSW_CHECK(stats.numFreeBlocks == before.numFreeBlocks + 3);
+	SSW_CHECK(stats.freeBlockSize == before.freeBlockSize + (9 + 9 + 14) * unit);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	// The merged blocks are in the classes of their new sizes, so they are found by exact size, the most
+	// recently merged one first
+	SSW_CHECK(allocateUnits<14>(heap) == both[0]);
+	SSW_CHECK(allocateUnits<9>(heap) == right[1]);
+	SSW_CHECK(allocateUnits<9>(heap) == left[0]);
+	stats = heap.stats();
+	SSW_CHECK(stats.numFreeBlocks == before.numFreeBlocks && stats.freeBlockSize == before.freeBlockSize);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+}
+
+SSW_TEST(deallocateCoalescesIntoBins) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	
+	// Each part has an exact size class, but the merged block only fits into the first bin
+	byte *parts[3];
+	for(auto &part : parts) {
+		part = allocateUnits<ExactClasses / 2>(heap);
+	}
+	allocateUnits<1>(heap);
+	for(auto part : {parts[0], parts[2], parts[1]}) {
+		heap.deallocate(part);
+	}
+	SSW_CHECK(heap.stats().numFreeBlocks == 2);
+	
+	// A block of the first bin is split off the merged block, the rest has an exact size class again
+	SSW_CHECK(allocateUnits<ExactClasses + 1>(heap) == parts[0]);
+	SSW_CHECK(allocateUnits<ExactClasses / 2>(heap) == parts[0] + (ExactClasses + 2) * HeapBase::Align);
+	SSW_CHECK(heap.stats().numFreeBlocks == 1);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+}
+
+SSW_TEST(splitLeavesNoBlockWithoutRoomForBoundaryTags) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	const auto unit = HeapBase::Align;
+	byte *first = allocateGuarded<8>(heap);
+	byte *second = allocateGuarded<8>(heap);
+	heap.deallocate(first);
+	heap.deallocate(second);
+	const auto before = heap.stats();
+	
+	// The rest would be a header with a single unit, so the whole block is taken
+	SSW_CHECK(allocateUnits<6>(heap) == second);
+	auto stats = heap.stats();
+	SSW_CHECK(stats.numFreeBlocks == before.numFreeBlocks - 1);
+	SSW_CHECK(stats.freeBlockSize == before.freeBlockSize - 8 * unit);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	// With one more unit to spare, the rest becomes a free block of two units
+	SSW_CHECK(allocateUnits<5>(heap) == first);
+	stats = heap.stats();
+	SSW_CHECK(stats.numFreeBlocks == before.numFreeBlocks - 1);
+	SSW_CHECK(stats.freeBlockSize == before.freeBlockSize - 16 * unit + 2 * unit);
+	SSW_CHECK(allocateUnits<2>(heap) == first + 6 * unit);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+}
@@ -0,0 +1,132 @@
+/**
+ * @file    GcPolicyTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests automatic garbage collection during allocation.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/**
+ * Get a policy that collects when an allocation fails and never grows the heap.
+ */
+HeapBase::GcPolicy collectOnFailure() {
+	HeapBase::GcPolicy policy;
+	policy.collectOnFailure = true;
+	policy.growOnFailure = false;
+	return policy;
+}
+
+} // namespace
+
+SSW_TEST(allocationFailureCompletesIncrementalCycle) {
+	DynamicHeap heap{64 * 1024, 64 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.gcPolicy(collectOnFailure());
+	Node::live = 0;
+	
+	Local<Node> list{nullptr};
+	for(std::size_t i = 0; i < 100; i++) {
+		Node *node = new Node(i);
+		node->left = list;
+		list = node;
+	}
+	SSW_CHECK(!heap.gcStep(0));
+	
+	// Far more garbage than fits into the heap, allocated while the cycle is marking
+	bool failed = false;
+	try {
+		for(std::size_t i = 0; i < 64 * 1024; i++) {
+			new Node(i);
+		}
+	} catch(const std::bad_alloc&) {
+		failed = true;
+	}
+	SSW_CHECK(!failed);
+	SSW_CHECK(!heap.collecting());
+	
+	std::size_t count = 0;
+	for(const Node *node = list; node; node = node->left, count++) {
+		SSW_CHECK(node->id == 99 - count);
+	}
+	SSW_CHECK(count == 100);
+	
+	list = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(allocationBuffersOfOtherThreadsPreventAutomaticCollection) {
+	DynamicHeap heap{256 * 1024, 256 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.gcPolicy(collectOnFailure());
+	heap.tlabSize(4 * 1024);
+	Node::live = 0;
+	
+	// The other thread only holds its node in a plain pointer, which no collection would find
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool allocated = false;
+	bool done = false;
+	bool intact = false;
+	std::thread other{[&]() {
+		ThreadHeap::Scope otherScope{heap};
+		Node *node = new Node(1);
+		std::unique_lock<std::mutex> lock{mutex};
+		allocated = true;
+		changed.notify_all();
+		changed.wait(lock, [&]() { return done; });
+		intact = node->intact(1);
+	}};
+	{
+		std::unique_lock<std::mutex> lock{mutex};
+		changed.wait(lock, [&]() { return allocated; });
+	}
+	new Node(2);
+	
+	bool failed = false;
+	try {
+		for(std::size_t i = 0; i < 64 * 1024; i++) {
+			new Node(i);
+		}
+	} catch(const std::bad_alloc&) {
+		failed = true;
+	}
+	SSW_CHECK(failed);
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		done = true;
+		changed.notify_all();
+	}
+	other.join();
+	SSW_CHECK(intact);
+	
+	// Once the other thread is gone, allocations collect again
+	failed = false;
+	try {
+		for(std::size_t i = 0; i < 64 * 1024; i++) {
+			new Node(i);
+		}
+	} catch(const std::bad_alloc&) {
+		failed = true;
+	}
+	SSW_CHECK(!failed);
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
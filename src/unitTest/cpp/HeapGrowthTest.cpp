@@ -0,0 +1,162 @@
+/**
+ * @file    HeapGrowthTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests growing and shrinking the storage of dynamic heaps.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "Array.hpp"
+#include "Heap.hpp"
+#include "Local.hpp"
+#include "Test.hpp"
+#include "TestHeap.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::Slot;
+using test::TestHeap;
+
+namespace {
+
+/** The initial and minimum size of the heaps of the tests. */
+constexpr std::size_t InitialSize = 256 * 1024;
+
+/**
+ * Prepend nodes to the specified list until the used space of the heap reaches the specified size.
+ * 
+ * @return The number of nodes in the list.
+ */
+std::size_t fillTo(HeapBase &heap, Local<Node> &list, std::size_t usedSize) {
+	std::size_t count = list ? list->id + 1 : 0;
+	while(heap.stats().usedSize < usedSize) {
+		Node *node = new Node(count++);
+		node->left = list;
+		list = node;
+	}
+	return count;
+}
+
+/**
+ * Check that the specified list holds the ids from `count - 1` down to `0`.
+ */
+bool intact(const Node *node, std::size_t count) {
+	for(; count > 0; count--, node = node->left) {
+		if(!node || !node->intact(count - 1)) {
+			return false;
+		}
+	}
+	return !node;
+}
+
+} // namespace
+
+SSW_TEST(storageGrowsWhenLessThanAQuarterIsFree) {
+	TestHeap heap{4 * 1024 * 1024, InitialSize};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	SSW_CHECK(heap.stats().heapSize == InitialSize);
+	
+	// Between a quarter and three quarters free, the storage keeps its size
+	Local<Node> list{nullptr};
+	auto count = fillTo(heap, list, InitialSize / 2);
+	heap.gc();
+	SSW_CHECK(heap.stats().heapSize == InitialSize);
+	
+	// With less than a quarter free, it grows by half of its size
+	count = fillTo(heap, list, InitialSize * 7 / 8);
+	heap.gc();
+	SSW_CHECK(heap.stats().heapSize == InitialSize * 3 / 2);
+	SSW_CHECK(Node::live == count && intact(list, count));
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	list = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(storageShrinksWhenMoreThanThreeQuartersAreFree) {
+	TestHeap heap{4 * 1024 * 1024, InitialSize};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	// Allocations that find no free block grow the storage
+	Local<Node> list{nullptr};
+	auto count = fillTo(heap, list, 2 * 1024 * 1024);
+	const auto grown = heap.stats().heapSize;
+	SSW_CHECK(grown >= 2 * 1024 * 1024);
+	
+	// Keep the nodes at the start of the storage, twice their size is kept
+	Node *node = list;
+	while(node->id >= count / 8) {
+		node = node->left;
+	}
+	list = node;
+	count = node->id + 1;
+	heap.gc();
+	const auto shrunk = heap.stats();
+	SSW_CHECK(shrunk.heapSize < grown && shrunk.heapSize >= 2 * shrunk.usedSize);
+	SSW_CHECK(shrunk.heapSize <= 4 * shrunk.usedSize);
+	SSW_CHECK(Node::live == count && intact(list, count));
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	// The storage does not shrink below its initial size
+	list = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+	SSW_CHECK(heap.stats().heapSize == InitialSize);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+}
+
+SSW_TEST(growingTenuresYoungObjectsInPlace) {
+	TestHeap heap{4 * 1024 * 1024, InitialSize};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(32 * 1024);
+	Node::live = 0;
+	
+	Local<Node> young{new Node(1)};
+	young->left = new Node(2);
+	new Node(3);
+	const Node *address = young;
+	
+	// Arrays are allocated in the old generation, which is too small for this one
+	Local<Array<Slot>> array{Array<Slot>::make(InitialSize / sizeof(Slot))};
+	SSW_CHECK(array && heap.stats().heapSize > InitialSize);
+	(*array)[0].node = young;
+	// The young objects became old where they are, including the garbage
+	SSW_CHECK(young == address && young->intact(1) && young->left->intact(2));
+	SSW_CHECK(Node::live == 3);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	heap.minorGc();
+	SSW_CHECK(young == address && Node::live == 3);
+	// Their blocks are not reused
+	for(std::size_t i = 0; i < 1000; i++) {
+		new Node(4);
+	}
+	SSW_CHECK(young->intact(1) && young->left->intact(2));
+	
+	heap.gc();
+	SSW_CHECK(young == address && young->intact(1) && young->left->intact(2));
+	SSW_CHECK(Node::live == 2);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	young = nullptr;
+	array = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(reservationFailureThrowsBadAlloc) {
+	bool failed = false;
+	try {
+		// More address space than any system has
+		DynamicHeap heap{SIZE_MAX / 4};
+	} catch(const std::bad_alloc&) {
+		failed = true;
+	}
+	SSW_CHECK(failed);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file    HeapStatsTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests the heap statistics that are maintained during allocation and garbage collection.
+ */
+
+#include <cstddef>
+#include <vector>
+
+#include "Array.hpp"
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestHeap.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::Slot;
+using test::TestHeap;
+
+namespace {
+
+/**
+ * Allocate the specified number of nodes, linking every other one into the list after the specified head.
+ */
+void allocateNodes(Local<Node> &head, std::size_t count) {
+	for(std::size_t i = 0; i < count; i++) {
+		Node *node = new Node(i);
+		if(i % 2 == 0) {
+			node->left = head;
+			head = node;
+		}
+	}
+}
+
+} // namespace
+
+SSW_TEST(statsMatchHeapWalkAfterEveryOperation) {
+	TestHeap heap{4 * 1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	SSW_CHECK(heap.stats().numObjects == 0 && heap.stats().numLiveObjects == 0);
+	
+	// Explicit allocation and deallocation
+	Local<Node> list;
+	allocateNodes(list, 1000);
+	Local<Array<Slot>> array{Array<Slot>::make(100)};
+	std::vector<void*> batch(100);
+	SSW_CHECK(heap.allocateBatch(Slot::type, batch.size(), batch.data()) == batch.size());
+	heap.deallocate(static_cast<byte*>(batch[0]));
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	heap.gc();
+	SSW_CHECK(heap.statsMatchHeapWalk() && heap.liveStatsMatchHeapWalk());
+	
+	// Lazy sweeping, the heap walk finishes the sweep
+	heap.lazySweep(true);
+	allocateNodes(list, 1000);
+	heap.gc();
+	allocateNodes(list, 100);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	heap.lazySweep(false);
+	
+	// Young objects, promotion and compaction
+	heap.nurserySize(64 * 1024);
+	allocateNodes(list, 1000);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	heap.minorGc();
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	heap.compact();
+	SSW_CHECK(heap.statsMatchHeapWalk() && heap.liveStatsMatchHeapWalk());
+	heap.nurserySize(0);
+	
+	// Growing, and large objects, which use all of their mappings
+	const auto initialSize = heap.stats().heapSize;
+	Local<Array<Slot>> big{Array<Slot>::make(initialSize / sizeof(Slot))};
+	SSW_CHECK(heap.stats().heapSize > initialSize);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	heap.largeObjectThreshold(4096);
+	Local<Array<Slot>> large{Array<Slot>::make(1024)};
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	large = nullptr;
+	heap.gc();
+	SSW_CHECK(heap.statsMatchHeapWalk() && heap.liveStatsMatchHeapWalk());
+	
+	// Shrinking
+	const auto grownSize = heap.stats().heapSize;
+	list = nullptr;
+	array = nullptr;
+	big = nullptr;
+	heap.gc();
+	SSW_CHECK(heap.stats().heapSize < grownSize);
+	SSW_CHECK(heap.statsMatchHeapWalk() && heap.liveStatsMatchHeapWalk());
+	SSW_CHECK(heap.stats().numObjects == 0 && heap.stats().numLiveObjects == 0);
+}
+
+SSW_TEST(liveStatsCountObjectsOfTheLastCollection) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	
+	Local<Node> list;
+	allocateNodes(list, 1000);
+	heap.gc();
+	SSW_CHECK(heap.stats().numLiveObjects == 500 && heap.stats().liveObjectSize == 500 * sizeof(Node));
+	
+	// Objects allocated since, and garbage of the last cycle, are only taken into account by the next one
+	allocateNodes(list, 100);
+	list->left = nullptr;
+	SSW_CHECK(heap.stats().numLiveObjects == 500 && heap.stats().numObjects == 600);
+	heap.gc();
+	SSW_CHECK(heap.stats().numLiveObjects == 1 && heap.stats().numObjects == 1);
+	SSW_CHECK(heap.liveStatsMatchHeapWalk());
+}
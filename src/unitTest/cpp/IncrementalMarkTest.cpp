@@ -0,0 +1,140 @@
+/**
+ * @file    IncrementalMarkTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests incremental marking with mutations of the object graph between steps.
+ */
+
+#include <cstddef>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/**
+ * Get the nodes reachable from the specified node, checking that none of them was overwritten.
+ */
+std::vector<Node*> reachable(Node *root) {
+	std::unordered_set<Node*> visited;
+	std::vector<Node*> result;
+	std::vector<Node*> stack{root};
+	while(!stack.empty()) {
+		Node *node = stack.back();
+		stack.pop_back();
+		if(!node || !visited.insert(node).second) {
+			continue;
+		}
+		SSW_CHECK(node->check == ~node->id);
+		result.push_back(node);
+		stack.push_back(node->left);
+		stack.push_back(node->right);
+	}
+	return result;
+}
+
+} // namespace
+
+SSW_TEST(incrementalMarkKeepsWhiteObjectStoredIntoBlackObject) {
+	DynamicHeap heap{1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	// The white node is only reachable through the grey node
+	Local<Node> black{new Node(0)};
+	black->left = new Node(1);
+	black->left->left = new Node(2);
+	Node *grey = black->left;
+	Node *white = grey->left;
+	
+	// The first step greys the root, the second one scans it
+	SSW_CHECK(!heap.gcStep(0));
+	SSW_CHECK(!heap.gcStep(1));
+	
+	// Without the write barrier, the white node is not found anymore
+	black->right = white;
+	grey->left = nullptr;
+	while(!heap.gcStep(1)) {
+	}
+	SSW_CHECK(Node::live == 3);
+	SSW_CHECK(black->right == white && white->id == 2 && white->check == ~white->id);
+	
+	// The same for a new object
+	black->right = nullptr;
+	SSW_CHECK(!heap.gcStep(0));
+	SSW_CHECK(!heap.gcStep(1));
+	grey->right = new Node(3);
+	black->right = grey->right;
+	grey->right = nullptr;
+	while(!heap.gcStep(1)) {
+	}
+	SSW_CHECK(Node::live == 3);
+	SSW_CHECK(black->right->id == 3 && black->right->check == ~black->right->id);
+	
+	black = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(incrementalMarkKeepsReachableObjectsWhileGraphChanges) {
+	DynamicHeap heap{16 * 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	std::mt19937 rng{42};
+	const std::size_t count = 4000;
+	Local<Node> root{new Node(0)};
+	{
+		std::vector<Node*> nodes{root};
+		for(std::size_t i = 1; i < count; i++) {
+			nodes.push_back(new Node(i));
+			nodes[i - 1]->left = nodes[i];
+		}
+		for(auto node : nodes) {
+			node->right = nodes[rng() % count];
+		}
+	}
+	
+	for(int cycle = 0; cycle < 4; cycle++) {
+		bool done = false;
+		while(!done) {
+			done = heap.gcStep(16);
+			
+			// Move pointers between reachable nodes, which makes some of them garbage
+			auto nodes = reachable(root);
+			std::uniform_int_distribution<std::size_t> any{0, nodes.size() - 1};
+			for(int i = 0; i < 8; i++) {
+				Node *from = nodes[any(rng)];
+				Node *to = nodes[any(rng)];
+				if(rng() % 2) {
+					to->right = from->left;
+					from->left = nullptr;
+				} else {
+					to->left = from->right;
+					from->right = nodes[any(rng)];
+				}
+			}
+		}
+		
+		// Objects that became garbage during the cycle may have survived it, but the next collection frees them
+		const auto expected = reachable(root).size();
+		SSW_CHECK(Node::live >= expected);
+		heap.gc();
+		SSW_CHECK(Node::live == expected);
+		SSW_CHECK(reachable(root).size() == expected);
+	}
+	
+	root = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
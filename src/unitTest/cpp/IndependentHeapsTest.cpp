@@ -0,0 +1,118 @@
+/**
+ * @file    IndependentHeapsTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests that heap instances are collected independently of each other.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Root.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/** The ids of nodes allocated from the second heap start here. */
+constexpr std::size_t SecondIds = 1000;
+
+/**
+ * Get the sorted ids of the destroyed nodes, and clear them.
+ */
+std::vector<std::size_t> takeDestroyed(std::vector<std::size_t> &destroyed) {
+	std::vector<std::size_t> result;
+	result.swap(destroyed);
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+} // namespace
+
+SSW_TEST(heapsCollectOnlyTheirOwnObjects) {
+	DynamicHeap first{1024 * 1024};
+	DynamicHeap second{1024 * 1024};
+	Node::live = 0;
+	std::vector<std::size_t> destroyed;
+	Node::destroyed = &destroyed;
+	
+	ThreadHeap::Scope firstScope{first};
+	Root<Node> firstRoot{new Node(1)};
+	Local<Node> firstLocal{new Node(2)};
+	new Node(3);
+	{
+		// The locals of both heaps are interleaved on the native stack
+		ThreadHeap::Scope secondScope{second};
+		Root<Node> secondRoot{new Node(SecondIds + 1)};
+		Local<Node> secondLocal{new Node(SecondIds + 2)};
+		new Node(SecondIds + 3);
+		SSW_CHECK(Node::live == 6);
+		
+		// Neither heap sees the garbage of the other one
+		first.gc();
+		SSW_CHECK(takeDestroyed(destroyed) == std::vector<std::size_t>{3});
+		second.gc();
+		SSW_CHECK(takeDestroyed(destroyed) == std::vector<std::size_t>{SecondIds + 3});
+		
+		// The roots and locals of the first heap do not keep objects of the second one alive
+		secondRoot = nullptr;
+		secondLocal = nullptr;
+		second.gc();
+		SSW_CHECK(takeDestroyed(destroyed) == (std::vector<std::size_t>{SecondIds + 1, SecondIds + 2}));
+		SSW_CHECK(second.stats().numObjects == 0);
+	}
+	
+	// Roots are only accessible in a scope of their heap
+	SSW_CHECK(firstRoot->intact(1) && firstLocal->intact(2));
+	firstRoot = nullptr;
+	firstLocal = nullptr;
+	first.gc();
+	SSW_CHECK(takeDestroyed(destroyed) == (std::vector<std::size_t>{1, 2}));
+	SSW_CHECK(first.stats().numObjects == 0 && Node::live == 0);
+	Node::destroyed = nullptr;
+}
+
+SSW_TEST(heapsOfDifferentThreadsCollectConcurrently) {
+	constexpr std::size_t Threads = 4;
+	constexpr std::size_t Length = 1000;
+	std::vector<std::thread> threads;
+	std::vector<char> intact(Threads, false);
+	for(std::size_t t = 0; t < Threads; t++) {
+		threads.emplace_back([t, &intact] {
+			DynamicHeap heap{1024 * 1024};
+			ThreadHeap::Scope scope{heap};
+			Local<Node> list;
+			bool result = true;
+			for(std::size_t i = 0; i < Length; i++) {
+				Node *node = new Node(t * Length + i);
+				node->left = list;
+				list = node;
+				new Node(SIZE_MAX);
+				if(i % 100 == 0) {
+					heap.gc();
+					result = result && heap.stats().numObjects == i + 1;
+				}
+			}
+			heap.gc();
+			std::size_t count = 0;
+			for(const Node *node = list; node; node = node->left, count++) {
+				result = result && node->intact(t * Length + Length - 1 - count);
+			}
+			intact[t] = result && count == Length;
+		});
+	}
+	for(auto &thread : threads) {
+		thread.join();
+	}
+	SSW_CHECK(std::count(intact.begin(), intact.end(), true) == std::ptrdiff_t(Threads));
+}
@@ -0,0 +1,156 @@
+/**
+ * @file    LargeObjectTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests the large object space.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestHeap.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::TestHeap;
+
+namespace {
+
+/** The threshold of the tests, a large object is larger than this. */
+constexpr std::size_t Threshold = 4096;
+
+/**
+ * A large object that points to other large objects and to a small node.
+ */
+struct Big : public HeapObject<Big, ThreadHeap>
+{
+	static const TypeDescriptor &type;
+	/** The number of constructed and not yet destroyed objects. */
+	static std::size_t live;
+	
+	Member<Big> next;
+	Member<Node> node;
+	std::size_t id;
+	unsigned char payload[2 * Threshold];
+	
+	explicit Big(std::size_t id)
+			: next(nullptr), node(nullptr), id(id) {
+		payload[0] = payload[sizeof(payload) - 1] = static_cast<unsigned char>(id);
+		live++;
+	}
+	
+	~Big() {
+		live--;
+	}
+	
+	bool intact(std::size_t expected) const noexcept {
+		const auto check = static_cast<unsigned char>(expected);
+		return id == expected && payload[0] == check && payload[sizeof(payload) - 1] == check;
+	}
+};
+
+const TypeDescriptor &Big::type = *TypeDescriptor::make<Big>(&Big::next, &Big::node);
+std::size_t Big::live = 0;
+
+} // namespace
+
+SSW_TEST(largeObjectThresholdSelectsMappings) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	heap.largeObjectThreshold(Threshold);
+	const auto storage = heap.stats().heapSize;
+	
+	// At the threshold, objects are still allocated from the storage
+	byte *small = static_cast<byte*>(heap.allocate(test::Blob<Threshold>::type));
+	SSW_CHECK(small && heap.stats().heapSize == storage);
+	byte *large = static_cast<byte*>(heap.allocate(test::Blob<Threshold + HeapBase::Align>::type));
+	const auto stats = heap.stats();
+	// The mapping holds a header before the object, which is aligned like any other object
+	SSW_CHECK(large && stats.heapSize > storage + Threshold);
+	SSW_CHECK(reinterpret_cast<std::uintptr_t>(large) % HeapBase::Align == 0);
+	SSW_CHECK(stats.numObjects == 2 && stats.objectSize == 2 * Threshold + HeapBase::Align);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	// Deallocating a large object unmaps it right away
+	heap.deallocate(large);
+	SSW_CHECK(heap.stats().heapSize == storage && heap.stats().numObjects == 1);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	heap.deallocate(small);
+}
+
+SSW_TEST(largeObjectsAreSweptAndUnmapped) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.largeObjectThreshold(Threshold);
+	const auto storage = heap.stats().heapSize;
+	Big::live = 0;
+	Node::live = 0;
+	
+	// Every other large object is kept in a list, and each kept one keeps a small node alive
+	Local<Big> list{nullptr};
+	for(std::size_t i = 0; i < 10; i++) {
+		Big *big = new Big(i);
+		if(i % 2) {
+			big->next = list;
+			big->node = new Node(i);
+			list = big;
+		} else {
+			// Garbage that points to live objects
+			big->next = list;
+		}
+	}
+	const auto mapped = heap.stats().heapSize - storage;
+	SSW_CHECK(mapped >= 10 * sizeof(Big));
+	
+	heap.gc();
+	SSW_CHECK(Big::live == 5 && Node::live == 5);
+	SSW_CHECK(heap.stats().heapSize - storage == mapped / 2);
+	std::size_t i = 10;
+	for(const Big *big = list; big; big = big->next) {
+		i -= 2;
+		SSW_CHECK(big->intact(i + 1) && big->node->intact(i + 1));
+	}
+	SSW_CHECK(i == 0);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	// Unlink objects from the middle and both ends of the list of large objects
+	list->next->next = list->next->next->next;
+	list = list->next;
+	list->next->next = nullptr;
+	heap.gc();
+	SSW_CHECK(Big::live == 2 && Node::live == 2);
+	SSW_CHECK(list->intact(7) && list->next->intact(3) && !list->next->next);
+	SSW_CHECK(heap.stats().heapSize - storage == mapped / 5);
+	
+	list = nullptr;
+	heap.gc();
+	SSW_CHECK(Big::live == 0 && Node::live == 0);
+	SSW_CHECK(heap.stats().heapSize == storage);
+}
+
+SSW_TEST(minorGcUpdatesYoungObjectsReferencedByLargeObjects) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.largeObjectThreshold(Threshold);
+	heap.nurserySize(64 * 1024);
+	Big::live = 0;
+	Node::live = 0;
+	
+	// Large objects are never young, the card table does not cover them
+	Local<Big> big{new Big(1)};
+	Node *young = new Node(2);
+	big->node = young;
+	new Node(3);
+	heap.minorGc();
+	SSW_CHECK(Node::live == 1);
+	SSW_CHECK(big->node != young && big->node->intact(2));
+	
+	big = nullptr;
+	heap.gc();
+	SSW_CHECK(Big::live == 0 && Node::live == 0);
+}
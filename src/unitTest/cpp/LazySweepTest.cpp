@@ -0,0 +1,186 @@
+/**
+ * @file    LazySweepTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests lazy sweeping with the sweep cursor.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "Heap.hpp"
+#include "Local.hpp"
+#include "Test.hpp"
+#include "TestHeap.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::TestHeap;
+
+namespace {
+
+/** The size of the heaps of the tests, which are filled completely. */
+constexpr std::size_t HeapSize = 256 * 1024;
+
+/**
+ * Fill the current heap with nodes, keeping every other one in the specified list, so the free lists are
+ * empty and allocations have to sweep.
+ * 
+ * @param list Receives the kept nodes, the one with the highest id first.
+ * @param garbage Receives the ids of the nodes that are not kept, in ascending order.
+ * @return The number of allocated nodes.
+ */
+std::size_t fillHeap(Local<Node> &list, std::vector<std::size_t> &garbage) {
+	std::size_t i = 0;
+	try {
+		for(;; i++) {
+			Node *node = new Node(i);
+			if(i % 2) {
+				node->left = list;
+				list = node;
+			} else {
+				node->right = list;
+				garbage.push_back(i);
+			}
+		}
+	} catch(const std::bad_alloc&) {
+	}
+	return i;
+}
+
+/**
+ * Get the sorted ids of the destroyed nodes.
+ */
+std::vector<std::size_t> sorted(std::vector<std::size_t> ids) {
+	std::sort(ids.begin(), ids.end());
+	return ids;
+}
+
+/**
+ * Collect a full heap and sweep it completely, and get the ids of the nodes that were destroyed in the
+ * order of destruction.
+ */
+std::vector<std::size_t> collectFullHeap(bool lazy) {
+	TestHeap heap{HeapSize, HeapSize};
+	ThreadHeap::Scope scope{heap};
+	heap.lazySweep(lazy);
+	std::vector<std::size_t> destroyed;
+	Node::destroyed = &destroyed;
+	Node::live = 0;
+	
+	Local<Node> list{nullptr};
+	std::vector<std::size_t> garbage;
+	const auto count = fillHeap(list, garbage);
+	heap.gc();
+	// Without allocations, a lazy sweep does not destroy anything yet
+	SSW_CHECK(destroyed.empty() == lazy);
+	heap.lazySweep(false);
+	SSW_CHECK(sorted(destroyed) == garbage && Node::live == count - garbage.size());
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	Node::destroyed = nullptr;
+	return destroyed;
+}
+
+} // namespace
+
+SSW_TEST(lazySweepDestroysTheSameObjectsAsEagerSweep) {
+	const auto eager = collectFullHeap(false);
+	const auto lazy = collectFullHeap(true);
+	SSW_CHECK(!eager.empty());
+	// Both destroy every garbage node exactly once, in address order
+	SSW_CHECK(lazy == eager);
+	SSW_CHECK(sorted(eager) == eager && std::adjacent_find(eager.begin(), eager.end()) == eager.end());
+}
+
+SSW_TEST(allocationDuringLazySweepKeepsNewObjects) {
+	TestHeap heap{HeapSize, HeapSize};
+	ThreadHeap::Scope scope{heap};
+	heap.lazySweep(true);
+	std::vector<std::size_t> destroyed;
+	Node::destroyed = &destroyed;
+	Node::live = 0;
+	
+	Local<Node> list{nullptr};
+	std::vector<std::size_t> garbage;
+	const auto count = fillHeap(list, garbage);
+	heap.gc();
+	
+	// Each allocation sweeps up to the next garbage node, new nodes are not swept by the rest of the sweep
+	Local<Node> young{nullptr};
+	for(std::size_t i = 0; i < 10; i++) {
+		Node *node = new Node(count + i);
+		node->left = young;
+		young = node;
+	}
+	SSW_CHECK(destroyed.size() >= 10 && destroyed.size() < garbage.size() / 2);
+	SSW_CHECK(sorted(destroyed) == destroyed && destroyed.front() == garbage.front());
+	
+	heap.lazySweep(false);
+	SSW_CHECK(sorted(destroyed) == garbage);
+	SSW_CHECK(Node::live == count - garbage.size() + 10);
+	std::size_t i = 10;
+	for(const Node *node = young; node; node = node->left) {
+		SSW_CHECK(node->intact(count + --i));
+	}
+	SSW_CHECK(i == 0);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	Node::destroyed = nullptr;
+	list = nullptr;
+	young = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(gcDuringLazySweepFinishesTheSweepFirst) {
+	TestHeap heap{HeapSize, HeapSize};
+	ThreadHeap::Scope scope{heap};
+	heap.lazySweep(true);
+	std::vector<std::size_t> destroyed;
+	Node::destroyed = &destroyed;
+	Node::live = 0;
+	
+	Local<Node> list{nullptr};
+	std::vector<std::size_t> garbage;
+	const auto count = fillHeap(list, garbage);
+	heap.gc();
+	for(std::size_t i = 0; i < 10; i++) {
+		new Node(count + i);
+	}
+	const auto swept = destroyed.size();
+	SSW_CHECK(swept >= 10 && swept < garbage.size() / 2);
+	
+	// Cut the list of kept nodes in half, the nodes at its end are garbage now (along with the new ones)
+	Node *cut = list;
+	while(cut->id > count / 2) {
+		cut = cut->left;
+	}
+	for(const Node *node = cut->left; node; node = node->left) {
+		garbage.push_back(node->id);
+	}
+	cut->left = nullptr;
+	for(std::size_t i = 0; i < 10; i++) {
+		garbage.push_back(count + i);
+	}
+	
+	// The sweep of the first cycle is finished before marking, and nothing is destroyed twice
+	heap.gc();
+	heap.lazySweep(false);
+	SSW_CHECK(sorted(destroyed) == sorted(garbage));
+	SSW_CHECK(Node::live == count + 10 - garbage.size());
+	std::size_t kept = 0;
+	for(const Node *node = list; node; node = node->left, kept++) {
+		SSW_CHECK(node->intact(node->id) && node->id % 2 && node->id >= cut->id);
+	}
+	SSW_CHECK(kept == Node::live);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	Node::destroyed = nullptr;
+	list = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
@@ -0,0 +1,262 @@
+/**
+ * @file    LeafTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests that leaf objects are kept without being traced, and trivially destructible objects are reclaimed
+ *          without calling a destructor.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#include "Array.hpp"
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestHeap.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::Slot;
+using test::TestHeap;
+
+namespace {
+
+/**
+ * A leaf object with a destructor. Its pointer to a node is not described, so it must not keep the node alive.
+ */
+struct Text : public HeapObject<Text, ThreadHeap>
+{
+	static const TypeDescriptor &type;
+	/** The number of constructed and not yet destroyed objects, which the sweeper thread updates as well. */
+	static std::atomic<std::size_t> live;
+	
+	std::size_t id;
+	std::size_t check;
+	Node *unmanaged;
+	
+	explicit Text(std::size_t id, Node *unmanaged = nullptr)
+			: id(id), check(~id), unmanaged(unmanaged) {
+		live++;
+	}
+	
+	~Text() {
+		live--;
+	}
+	
+	bool intact(std::size_t expected) const noexcept {
+		return id == expected && check == ~id;
+	}
+};
+
+const TypeDescriptor &Text::type = *TypeDescriptor::make<Text>();
+std::atomic<std::size_t> Text::live{0};
+
+/**
+ * A trivially destructible leaf object.
+ */
+struct Plain : public HeapObject<Plain, ThreadHeap>
+{
+	static const TypeDescriptor &type;
+	
+	std::size_t id;
+	
+	explicit Plain(std::size_t id)
+			: id(id) {
+	}
+};
+
+const TypeDescriptor &Plain::type = *TypeDescriptor::make<Plain>();
+
+/**
+ * A trivially destructible object that references leaf objects and an empty array.
+ */
+struct Link : public HeapObject<Link, ThreadHeap>
+{
+	static const TypeDescriptor &type;
+	
+	Member<Link> next;
+	Member<Text> text;
+	Member<Text> shared;
+	Member<Plain> plain;
+	Member<Array<Slot>> empty;
+	
+	Link()
+			: next(nullptr), text(nullptr), shared(nullptr), plain(nullptr), empty(nullptr) {
+	}
+};
+
+const TypeDescriptor &Link::type = *TypeDescriptor::make<Link>(&Link::next, &Link::text, &Link::shared,
+		&Link::plain, &Link::empty);
+
+/**
+ * An array element with a destructor.
+ */
+struct Cell
+{
+	using HeapType = ThreadHeap;
+	static const TypeDescriptor &type;
+	static std::size_t live;
+	
+	Member<Node> node;
+	
+	Cell()
+			: node(nullptr) {
+		live++;
+	}
+	
+	~Cell() {
+		live--;
+	}
+};
+
+const TypeDescriptor &Cell::type = *TypeDescriptor::make<Cell>(&Cell::node);
+std::size_t Cell::live = 0;
+
+/** How a heap is marked or collected, full collections mark with a mark stack by default. */
+enum class Collection {
+	PointerReversal, Full, Parallel, Incremental, Compact, Minor, Lazy
+};
+
+/**
+ * Configure the specified heap for the requested collection.
+ */
+void configure(HeapBase &heap, Collection collection) {
+	switch(collection) {
+	case Collection::PointerReversal:
+		heap.markStackSize(0);
+		break;
+	case Collection::Parallel:
+		heap.markBitmap(true);
+		heap.markThreads(4);
+		break;
+	case Collection::Minor:
+		heap.nurserySize(64 * 1024);
+		break;
+	case Collection::Lazy:
+		heap.lazySweep(true);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Collect the specified heap as requested. Lazy sweeping is left pending.
+ */
+void collect(HeapBase &heap, Collection collection) {
+	switch(collection) {
+	case Collection::Incremental:
+		while(!heap.gcStep(100)) {
+		}
+		break;
+	case Collection::Compact:
+		heap.compact();
+		break;
+	case Collection::Minor:
+		heap.minorGc();
+		break;
+	default:
+		heap.gc();
+		break;
+	}
+}
+
+/**
+ * Build a list of links to leaf objects next to garbage ones, and check that collecting it keeps exactly the
+ * reachable leaf objects intact.
+ */
+void checkLeaves(Collection collection) {
+	constexpr std::size_t Count = 100;
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	configure(heap, collection);
+	Text::live = 0;
+	Node::live = 0;
+	
+	// A leaf root, and links that all point to it after it was marked
+	Local<Text> root{new Text(0, new Node(0))};
+	Local<Link> list;
+	for(std::size_t i = 1; i <= Count; i++) {
+		Link *link = new Link();
+		link->next = list;
+		list = link;
+		link->text = new Text(i, new Node(i));
+		link->shared = root;
+		link->plain = new Plain(i);
+		link->empty = Array<Slot>::make(0);
+		new Text(Count + i);
+		new Plain(Count + i);
+	}
+	
+	collect(heap, collection);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	SSW_CHECK(Text::live == Count + 1 && Node::live == 0);
+	SSW_CHECK(root->intact(0));
+	std::size_t expected = Count;
+	for(const Link *link = list; link; link = link->next, expected--) {
+		SSW_CHECK(link->text->intact(expected) && link->shared == root);
+		SSW_CHECK(link->plain->id == expected && link->empty->length() == 0);
+	}
+	SSW_CHECK(expected == 0);
+	
+	// Only the first link and the leaves it references remain, which were promoted by a minor collection
+	list->next = nullptr;
+	collect(heap, collection == Collection::Minor ? Collection::Full : collection);
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	SSW_CHECK(Text::live == 2 && root->intact(0) && list->text->intact(Count) && list->plain->id == Count);
+	
+	root = nullptr;
+	list = nullptr;
+	heap.gc();
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	SSW_CHECK(Text::live == 0 && heap.stats().numObjects == 0);
+}
+
+} // namespace
+
+SSW_TEST(leafPropertiesFollowTheDescribedTypes) {
+	static_assert(std::is_trivially_destructible<Plain>::value && std::is_trivially_destructible<Link>::value,
+			"The test types must be trivially destructible.");
+	SSW_CHECK(Text::type.leaf() && !Text::type.triviallyDestructible());
+	SSW_CHECK(Plain::type.leaf() && Plain::type.triviallyDestructible());
+	SSW_CHECK(!Link::type.leaf() && Link::type.triviallyDestructible());
+	SSW_CHECK(!Node::type.leaf() && !Node::type.triviallyDestructible());
+	SSW_CHECK(Slot::type.triviallyDestructible() && !Cell::type.triviallyDestructible());
+}
+
+SSW_TEST(leafObjectsAreKeptWithoutTracing) {
+	for(auto collection : {Collection::PointerReversal, Collection::Full, Collection::Parallel,
+			Collection::Incremental, Collection::Compact, Collection::Minor, Collection::Lazy}) {
+		checkLeaves(collection);
+	}
+}
+
+SSW_TEST(largeArraysAreDestroyedOnlyWithElementDestructors) {
+	TestHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.largeObjectThreshold(4096);
+	Cell::live = 0;
+	
+	// Large arrays of trivially destructible elements next to those of elements with destructors
+	Local<Array<Slot>> slots{Array<Slot>::make(1024)};
+	Local<Array<Cell>> cells{Array<Cell>::make(1024)};
+	Array<Slot>::make(1024);
+	Array<Cell>::make(1024);
+	SSW_CHECK(Cell::live == 2048);
+	heap.gc();
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	SSW_CHECK(heap.stats().numObjects == 2 && Cell::live == 1024);
+	SSW_CHECK(slots->length() == 1024 && cells->length() == 1024);
+	
+	slots = nullptr;
+	cells = nullptr;
+	heap.gc();
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	SSW_CHECK(heap.stats().numObjects == 0 && Cell::live == 0);
+}
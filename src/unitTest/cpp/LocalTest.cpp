@@ -0,0 +1,167 @@
+/**
+ * @file    LocalTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests local roots on the shadow stacks of threads.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/**
+ * Hold a local for each depth from the specified one down to `1`, plus a garbage node, and collect at the
+ * innermost depth. Every local must survive and be updated if the node was moved.
+ */
+void nest(std::size_t depth, std::size_t total) {
+	Local<Node> local{new Node(depth)};
+	new Node(SIZE_MAX);
+	if(depth > 1) {
+		nest(depth - 1, total);
+	} else {
+		auto &heap = ThreadHeap::instance();
+		heap.minorGc();
+		heap.gc();
+		SSW_CHECK(Node::live == total);
+	}
+	SSW_CHECK(local->intact(depth));
+}
+
+/**
+ * Hold a local for each depth from the specified one down to `1` and throw at the innermost depth.
+ */
+void nestAndThrow(std::size_t depth) {
+	Local<Node> local{new Node(depth)};
+	if(depth > 1) {
+		nestAndThrow(depth - 1);
+	} else {
+		throw std::runtime_error("unwind");
+	}
+}
+
+} // namespace
+
+SSW_TEST(nestedLocalsAreRootsUntilTheirScopeEnds) {
+	DynamicHeap heap{1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(64 * 1024);
+	Node::live = 0;
+	constexpr std::size_t Depth = 100;
+	
+	Local<Node> outer{new Node(0)};
+	nest(Depth, Depth + 1);
+	heap.gc();
+	SSW_CHECK(Node::live == 1 && outer->intact(0));
+	
+	// Locals in nested blocks, and locals that are reassigned or empty
+	{
+		Local<Node> first{new Node(1)};
+		Local<Node> empty;
+		{
+			Local<Node> second{first};
+			first = new Node(2);
+			heap.gc();
+			SSW_CHECK(Node::live == 3 && second->intact(1) && first->intact(2) && !empty);
+		}
+		heap.gc();
+		SSW_CHECK(Node::live == 2);
+	}
+	heap.gc();
+	SSW_CHECK(Node::live == 1 && outer->intact(0));
+}
+
+SSW_TEST(localsAreUnwoundByExceptions) {
+	DynamicHeap heap{1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	Local<Node> outer{new Node(0)};
+	bool thrown = false;
+	try {
+		nestAndThrow(10);
+	} catch(const std::runtime_error&) {
+		thrown = true;
+	}
+	SSW_CHECK(thrown);
+	SSW_CHECK(Node::live == 11);
+	heap.gc();
+	SSW_CHECK(Node::live == 1 && outer->intact(0));
+	
+	// The shadow stack is consistent, new locals are pushed onto the outer one
+	Local<Node> after{new Node(1)};
+	heap.gc();
+	SSW_CHECK(Node::live == 2 && after->intact(1));
+}
+
+SSW_TEST(localsOfOtherThreadsAreRoots) {
+	DynamicHeap heap{1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool ready = false;
+	bool collected = false;
+	// Checked by this thread, the test functions are not thread-safe
+	bool intact = false;
+	
+	std::thread thread{[&] {
+		ThreadHeap::Scope threadScope{heap};
+		{
+			Local<Node> local{new Node(1)};
+			local->left = new Node(2);
+			std::unique_lock<std::mutex> lock{mutex};
+			ready = true;
+			changed.notify_all();
+			changed.wait(lock, [&collected] { return collected; });
+			intact = local->intact(1) && local->left->intact(2);
+		}
+	}};
+	{
+		std::unique_lock<std::mutex> lock{mutex};
+		changed.wait(lock, [&ready] { return ready; });
+	}
+	heap.gc();
+	SSW_CHECK(Node::live == 2);
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		collected = true;
+		changed.notify_all();
+	}
+	thread.join();
+	SSW_CHECK(intact);
+	
+	// The locals of the thread were popped before it ended
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(localsWorkWithHeapsCreatedAfterOthersWereDestroyed) {
+	Node::live = 0;
+	for(std::size_t i = 0; i < 3; i++) {
+		// Locals cache the shadow stack of the last heap, which must not be used for the next one
+		DynamicHeap heap{1024 * 1024};
+		ThreadHeap::Scope scope{heap};
+		Local<Node> local{new Node(i)};
+		new Node(SIZE_MAX);
+		heap.gc();
+		SSW_CHECK(Node::live == 1 && local->intact(i));
+		local = nullptr;
+		heap.gc();
+		SSW_CHECK(Node::live == 0);
+	}
+}
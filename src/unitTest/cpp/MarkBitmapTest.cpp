@@ -0,0 +1,180 @@
+/**
+ * @file    MarkBitmapTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests that marking with the side mark bitmap keeps the same objects as marking in block headers.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Root.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/** The number of nodes in the random object graph. */
+constexpr std::size_t Count = 5000;
+
+/** How a heap is collected. */
+enum class Collection {
+	Full, Lazy, Incremental, Compact
+};
+
+/**
+ * A random object graph: the targets of the left and right members of each node, `Count` for `nullptr`.
+ */
+using Graph = std::vector<std::pair<std::size_t, std::size_t>>;
+
+/**
+ * Generate a sparse random graph, so that a good part of the nodes is unreachable.
+ */
+Graph randomGraph() {
+	std::mt19937 random{42};
+	std::uniform_int_distribution<std::size_t> target{0, 2 * Count - 1};
+	Graph graph;
+	for(std::size_t i = 0; i < Count; i++) {
+		// Half of the members are null
+		graph.emplace_back(std::min(target(random), Count), std::min(target(random), Count));
+	}
+	return graph;
+}
+
+/**
+ * Get the sorted ids of the nodes that are not reachable from the specified roots.
+ */
+std::vector<std::size_t> unreachable(const Graph &graph, std::vector<std::size_t> roots) {
+	std::vector<bool> reached(Count + 1, false);
+	reached[Count] = true;
+	while(!roots.empty()) {
+		const auto node = roots.back();
+		roots.pop_back();
+		if(reached[node]) {
+			continue;
+		}
+		reached[node] = true;
+		roots.push_back(graph[node].first);
+		roots.push_back(graph[node].second);
+	}
+	std::vector<std::size_t> result;
+	for(std::size_t i = 0; i < Count; i++) {
+		if(!reached[i]) {
+			result.push_back(i);
+		}
+	}
+	return result;
+}
+
+/**
+ * Collect the specified heap as requested, and finish sweeping.
+ */
+void collect(HeapBase &heap, Collection collection) {
+	switch(collection) {
+	case Collection::Incremental:
+		while(!heap.gcStep(100)) {
+		}
+		break;
+	case Collection::Compact:
+		heap.compact();
+		break;
+	default:
+		heap.gc();
+		break;
+	}
+	if(collection == Collection::Lazy) {
+		// Sweeps the rest before marking again, which finds no more garbage
+		heap.gc();
+	}
+}
+
+/**
+ * Build the specified graph in a new heap, collect it twice, the second time with the first root removed,
+ * and check that exactly the unreachable nodes were destroyed each time.
+ */
+void checkCollection(const Graph &graph, bool markBitmap, Collection collection) {
+	DynamicHeap heap{4 * 1024 * 1024, 4 * 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.markBitmap(markBitmap);
+	heap.lazySweep(collection == Collection::Lazy);
+	SSW_CHECK(heap.markBitmap() == markBitmap);
+	Node::live = 0;
+	std::vector<std::size_t> destroyed;
+	Node::destroyed = &destroyed;
+	
+	std::vector<Node*> nodes;
+	for(std::size_t i = 0; i < Count; i++) {
+		nodes.push_back(new Node(i));
+	}
+	nodes.push_back(nullptr);
+	for(std::size_t i = 0; i < Count; i++) {
+		nodes[i]->left = nodes[graph[i].first];
+		nodes[i]->right = nodes[graph[i].second];
+	}
+	Root<Node> first{nodes[0]};
+	Local<Node> second{nodes[1]};
+	nodes.clear();
+	
+	collect(heap, collection);
+	std::sort(destroyed.begin(), destroyed.end());
+	SSW_CHECK(destroyed == unreachable(graph, {0, 1}));
+	SSW_CHECK(first->intact(0) && second->intact(1));
+	
+	first = nullptr;
+	collect(heap, collection);
+	std::sort(destroyed.begin(), destroyed.end());
+	SSW_CHECK(destroyed == unreachable(graph, {1}));
+	SSW_CHECK(Node::live == Count - destroyed.size());
+	Node::destroyed = nullptr;
+}
+
+} // namespace
+
+SSW_TEST(markBitmapKeepsTheSameObjectsAsHeaderMarks) {
+	const auto graph = randomGraph();
+	// The graph must have garbage, and garbage that only becomes unreachable without the first root
+	SSW_CHECK(unreachable(graph, {0, 1}).size() > Count / 10);
+	SSW_CHECK(unreachable(graph, {1}).size() > unreachable(graph, {0, 1}).size());
+	
+	for(auto collection : {Collection::Full, Collection::Lazy, Collection::Incremental, Collection::Compact}) {
+		checkCollection(graph, false, collection);
+		checkCollection(graph, true, collection);
+	}
+}
+
+SSW_TEST(switchingMarkBitmapFinishesPendingSweep) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.lazySweep(true);
+	Node::live = 0;
+	
+	for(bool markBitmap : {true, false, true}) {
+		Local<Node> kept{new Node(0)};
+		for(std::size_t i = 1; i <= 1000; i++) {
+			new Node(i);
+		}
+		heap.gc();
+		// Without a full heap, nothing was swept yet
+		SSW_CHECK(Node::live == 1001);
+		heap.markBitmap(markBitmap);
+		SSW_CHECK(Node::live == 1 && kept->intact(0));
+		heap.gc();
+		heap.gc();
+		SSW_CHECK(Node::live == 1 && kept->intact(0));
+		kept = nullptr;
+		heap.gc();
+		heap.gc();
+		SSW_CHECK(Node::live == 0);
+	}
+}
@@ -0,0 +1,129 @@
+/**
+ * @file    MarkStackTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests serial marking with a bounded mark stack.
+ */
+
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+#include "Array.hpp"
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::Slot;
+
+namespace {
+
+/** The ids of garbage nodes start here, the ids of reachable nodes are below. */
+constexpr std::size_t GarbageIds = 1000000;
+
+/**
+ * Allocate a reachable node with the specified id, followed by a garbage node that points to it, so
+ * garbage and reachable nodes alternate in the heap.
+ */
+Node* allocate(std::size_t id, std::size_t &garbage) {
+	Node *node = new Node(id);
+	Node *dead = new Node(GarbageIds + garbage++);
+	dead->left = node;
+	return node;
+}
+
+/**
+ * Allocate a complete binary tree of the specified depth.
+ */
+Node* allocateTree(std::size_t depth, std::size_t &id, std::size_t &garbage) {
+	Node *node = allocate(id++, garbage);
+	if(depth > 1) {
+		node->left = allocateTree(depth - 1, id, garbage);
+		node->right = allocateTree(depth - 1, id, garbage);
+	}
+	return node;
+}
+
+/**
+ * Collect an object graph that is much deeper and wider than the mark stack with the specified capacity,
+ * and check that exactly the reachable nodes survive, in every collection.
+ */
+void checkMarking(std::size_t stackSize, bool markBitmap) {
+	DynamicHeap heap{16 * 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.markStackSize(stackSize);
+	heap.markBitmap(markBitmap);
+	Node::live = 0;
+	std::vector<std::size_t> destroyed;
+	Node::destroyed = &destroyed;
+	constexpr std::size_t Depth = 10000;
+	constexpr std::size_t Width = 1000;
+	std::size_t id = 0;
+	std::size_t garbage = 0;
+	
+	// A long chain with subtrees and back edges to earlier nodes of the chain
+	Local<Node> chain{allocate(id++, garbage)};
+	Node *last = chain;
+	for(std::size_t i = 1; i < Depth; i++) {
+		last->left = allocate(id++, garbage);
+		last = last->left;
+		if(i % 100 == 0) {
+			last->right = chain;
+		} else if(i % 3 == 0) {
+			last->right = allocateTree(3, id, garbage);
+		}
+	}
+	
+	// A wide array of chain nodes, which are shared, and of deep trees
+	Local<Array<Slot>> wide{Array<Slot>::make(Width)};
+	Node *node = chain;
+	for(std::size_t i = 0; i < Width; i++) {
+		if(i % 2 == 0) {
+			(*wide)[i].node = node;
+			node = node->left;
+		} else if(i % 50 == 1) {
+			(*wide)[i].node = allocateTree(8, id, garbage);
+		}
+	}
+	
+	for(std::size_t cycle = 0; cycle < 2; cycle++) {
+		destroyed.clear();
+		heap.gc();
+		SSW_CHECK(Node::live == id);
+		SSW_CHECK(destroyed.size() == (cycle == 0 ? garbage : 0));
+		for(auto destroyedId : destroyed) {
+			SSW_CHECK(destroyedId >= GarbageIds);
+		}
+	}
+	
+	// The pointers were restored by pointer reversal
+	std::size_t count = 0;
+	for(node = chain; node; node = node->left, count++) {
+		SSW_CHECK(node->intact(node->id));
+		SSW_CHECK(!node->right || node->right == chain || node->right->intact(node->right->id));
+	}
+	SSW_CHECK(count == Depth);
+	
+	chain = nullptr;
+	wide = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+	Node::destroyed = nullptr;
+}
+
+} // namespace
+
+SSW_TEST(markStackOverflowFallsBackToPointerReversal) {
+	for(bool markBitmap : {false, true}) {
+		// Without a stack, with tiny ones, and with the default capacity
+		checkMarking(0, markBitmap);
+		checkMarking(1, markBitmap);
+		checkMarking(8, markBitmap);
+		checkMarking(4096, markBitmap);
+	}
+}
@@ -0,0 +1,164 @@
+/**
+ * @file    NurseryTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests the nursery and minor collections.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Root.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/**
+ * Check that the list starting at the specified node holds the ids from `count - 1` down to `0`.
+ */
+void checkList(const Node *node, std::size_t count) {
+	for(; count > 0; count--, node = node->left) {
+		SSW_CHECK(node && node->id == count - 1 && node->check == ~node->id);
+		if(!node) {
+			return;
+		}
+	}
+	SSW_CHECK(!node);
+}
+
+/**
+ * Check that the specified node is the young node `3` that points to the young node `4`.
+ */
+void checkYoungPair(const Node *node) {
+	SSW_CHECK(node->id == 3 && node->check == ~node->id);
+	SSW_CHECK(node->left->id == 4 && node->left->check == ~node->left->id && !node->left->left);
+}
+
+/**
+ * Store young objects into old objects through members, and check that minor collections keep exactly the
+ * young objects that are reachable from the old generation and update all pointers to them.
+ */
+void checkOldToYoungPointers(bool cardTable) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(64 * 1024);
+	heap.cardTable(cardTable);
+	Node::live = 0;
+	
+	// Objects that survived a minor collection are old
+	Local<Node> first{new Node(1)};
+	Local<Node> second{new Node(2)};
+	heap.minorGc();
+	const Node *oldFirst = first;
+	
+	// Only reachable through the members of old objects, young objects may point to each other
+	Node *young = new Node(3);
+	young->left = new Node(4);
+	first->left = young;
+	second->left = young;
+	new Node(5);
+	SSW_CHECK(Node::live == 5);
+	
+	heap.minorGc();
+	SSW_CHECK(Node::live == 4);
+	SSW_CHECK(first == oldFirst);
+	// Promotion moved the young object, and both referrers point to the copy
+	SSW_CHECK(first->left != young && first->left == second->left);
+	checkYoungPair(first->left);
+	
+	// Promoted objects are old and stay where they are
+	young = first->left;
+	heap.minorGc();
+	SSW_CHECK(first->left == young && second->left == young);
+	checkYoungPair(young);
+	
+	first->left = nullptr;
+	second->left = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 2);
+}
+
+} // namespace
+
+SSW_TEST(gcTakesANewNurseryAfterPromotionFails) {
+	DynamicHeap heap{256 * 1024, 256 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(32 * 1024);
+	Node::live = 0;
+	
+	// Fill the nursery and then the old generation, so the young objects cannot be promoted
+	Local<Node> list{nullptr};
+	std::uintptr_t oldest = 0;
+	std::size_t count = 0;
+	try {
+		for(;; count++) {
+			Node *node = new Node(count);
+			node->left = list;
+			list = node;
+			if(!oldest && count > 32 * 1024 / sizeof(Node)) {
+				oldest = reinterpret_cast<std::uintptr_t>(node);
+			}
+		}
+	} catch(const std::bad_alloc&) {
+	}
+	SSW_CHECK(Node::live == count);
+	
+	// The nursery becomes part of the old generation
+	heap.minorGc();
+	SSW_CHECK(Node::live == count);
+	checkList(list, count);
+	
+	list = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+	
+	// New objects go to the new nursery at the end of the storage again, not to the start of the old generation
+	Local<Node> young{new Node(0)};
+	SSW_CHECK(reinterpret_cast<std::uintptr_t>(young.get()) > oldest + 128 * 1024);
+}
+
+SSW_TEST(minorGcKeepsYoungObjectsReachableFromOldObjects) {
+	checkOldToYoungPointers(false);
+}
+
+SSW_TEST(minorGcWithCardTableKeepsYoungObjectsReachableFromOldObjects) {
+	checkOldToYoungPointers(true);
+}
+
+SSW_TEST(minorGcUpdatesRootsOfYoungObjects) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(64 * 1024);
+	Node::live = 0;
+	
+	Node *young = new Node(1);
+	young->left = new Node(0);
+	Root<Node> root{young};
+	Root<Node> other;
+	other = new Node(2);
+	new Node(3);
+	
+	heap.minorGc();
+	SSW_CHECK(Node::live == 3);
+	SSW_CHECK(root.get() != young);
+	checkList(root, 2);
+	SSW_CHECK(other->id == 2 && other->check == ~other->id);
+	
+	heap.gc();
+	SSW_CHECK(Node::live == 3);
+	checkList(root, 2);
+	
+	root = nullptr;
+	other = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
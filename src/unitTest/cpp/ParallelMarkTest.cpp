@@ -0,0 +1,140 @@
+/**
+ * @file    ParallelMarkTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests parallel marking with work-stealing mark stacks.
+ */
+
+#include <cstddef>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "Array.hpp"
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::Slot;
+
+namespace {
+
+/**
+ * Get the nodes reachable from the specified node, checking that none of them was overwritten.
+ */
+std::unordered_set<const Node*> reachable(const Node *root) {
+	std::unordered_set<const Node*> result;
+	std::vector<const Node*> stack{root};
+	while(!stack.empty()) {
+		const Node *node = stack.back();
+		stack.pop_back();
+		if(!node || !result.insert(node).second) {
+			continue;
+		}
+		SSW_CHECK(node->check == ~node->id);
+		stack.push_back(node->left);
+		stack.push_back(node->right);
+	}
+	return result;
+}
+
+/**
+ * Build a graph of the specified number of nodes: the first half is a chain from the first node, deep enough
+ * to need stealing, and every node has a second edge to a random node, so the graph has many cycles and
+ * only part of the second half is reachable from the first node.
+ */
+Node* buildGraph(std::mt19937 &rng, std::size_t count) {
+	std::vector<Node*> nodes;
+	nodes.reserve(count);
+	for(std::size_t i = 0; i < count; i++) {
+		nodes.push_back(new Node(i));
+	}
+	std::uniform_int_distribution<std::size_t> any{0, count - 1};
+	for(std::size_t i = 0; i < count; i++) {
+		if(i + 1 < count / 2) {
+			nodes[i]->left = nodes[i + 1];
+		} else if(i >= count / 2) {
+			nodes[i]->left = nodes[any(rng)];
+		}
+		// Edges out of the chain only sometimes lead to the second half
+		if(i >= count / 2 || rng() % 8 == 0) {
+			nodes[i]->right = nodes[any(rng)];
+		} else if(i > 0) {
+			nodes[i]->right = nodes[any(rng) % i];
+		}
+	}
+	return nodes[0];
+}
+
+} // namespace
+
+SSW_TEST(parallelMarkKeepsExactlyTheReachableObjects) {
+	DynamicHeap heap{64 * 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.markBitmap(true);
+	heap.markThreads(4);
+	Node::live = 0;
+	
+	std::mt19937 rng{42};
+	Local<Node> root{buildGraph(rng, 100000)};
+	// Garbage that points into the live graph
+	buildGraph(rng, 50000)->right = root;
+	
+	for(int round = 0; round < 4; round++) {
+		const auto expected = reachable(root);
+		heap.gc();
+		SSW_CHECK(Node::live == expected.size());
+		SSW_CHECK(reachable(root) == expected);
+		SSW_CHECK(heap.stats().numLiveObjects == expected.size());
+		
+		// Cut the chain somewhere, which makes a different part of the graph garbage
+		Node *node = root;
+		for(auto steps = rng() % 20000; steps > 0 && node->left; steps--) {
+			node = node->left;
+		}
+		node->left = nullptr;
+	}
+	
+	root = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
+
+SSW_TEST(parallelMarkCompletesAfterMarkStackOverflow) {
+	DynamicHeap heap{64 * 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.markBitmap(true);
+	heap.markThreads(4);
+	Node::live = 0;
+	
+	// The children of the array do not fit onto a mark stack, and each of them is the start of a chain
+	const std::size_t count = 20000;
+	Local<Array<Slot>> array{Array<Slot>::make(count)};
+	for(std::size_t i = 0; i < count; i++) {
+		Node *node = new Node(i);
+		node->left = new Node(count + i);
+		node->left->right = node;
+		(*array)[i].node = node;
+	}
+	for(std::size_t i = 0; i < count; i++) {
+		// Garbage
+		new Node(2 * count + i);
+	}
+	
+	heap.gc();
+	SSW_CHECK(Node::live == 2 * count);
+	for(std::size_t i = 0; i < count; i++) {
+		const Node *node = (*array)[i].node;
+		SSW_CHECK(node->id == i && node->check == ~i);
+		SSW_CHECK(node->left->id == count + i && node->left->right == node);
+	}
+	
+	array = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+}
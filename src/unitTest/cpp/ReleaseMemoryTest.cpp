@@ -0,0 +1,93 @@
+/**
+ * @file    ReleaseMemoryTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests returning free memory of the heap to the operating system.
+ */
+
+#include <cstddef>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+namespace {
+
+/** The number of nodes that fill about a quarter of the heap. */
+constexpr std::size_t Count = 20000;
+
+/**
+ * Allocate garbage nodes with nonzero contents, and get the one in the middle, whose memory is far from the
+ * boundary tags of the free block it becomes.
+ */
+const Node* allocateGarbage() {
+	const Node *middle = nullptr;
+	for(std::size_t i = 0; i < Count; i++) {
+		Node *node = new Node(i + 1);
+		if(i == Count / 2) {
+			middle = node;
+		}
+	}
+	return middle;
+}
+
+/**
+ * Check whether the memory of the specified node reads as zero, which means that its page was discarded.
+ * Only Linux guarantees this for discarded pages, so it is always `true` on other systems.
+ */
+bool discarded(const Node *node) {
+#if defined(__linux__)
+	const auto words = reinterpret_cast<const volatile std::size_t*>(node);
+	for(std::size_t i = 0; i < sizeof(Node) / sizeof(std::size_t); i++) {
+		if(words[i]) {
+			return false;
+		}
+	}
+#else
+	static_cast<void>(node);
+#endif
+	return true;
+}
+
+} // namespace
+
+SSW_TEST(releasedPagesAreDiscardedAgainAfterReuse) {
+	DynamicHeap heap{4 * 1024 * 1024, 4 * 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Local<Node> live{new Node(0)};
+	
+	// Without a threshold, free memory keeps its contents
+	const Node *middle = allocateGarbage();
+	heap.gc();
+	SSW_CHECK(heap.releaseThreshold() == 0);
+#if defined(__linux__)
+	SSW_CHECK(!discarded(middle));
+#endif
+	
+	heap.releaseThreshold(64 * 1024);
+	heap.gc();
+	SSW_CHECK(discarded(middle));
+	
+	// Allocation from the discarded pages takes them back, so they are discarded again once they are free
+	for(std::size_t round = 0; round < 3; round++) {
+		SSW_CHECK(allocateGarbage() == middle);
+		SSW_CHECK(middle->intact(Count / 2 + 1));
+		heap.gc();
+		SSW_CHECK(discarded(middle));
+		SSW_CHECK(live->intact(0));
+	}
+	
+	// Live objects in released blocks are never discarded
+	SSW_CHECK(allocateGarbage() == middle);
+	Local<Node> keep{const_cast<Node*>(middle)};
+	heap.gc();
+	SSW_CHECK(keep->intact(Count / 2 + 1) && live->intact(0));
+	heap.compact();
+	SSW_CHECK(keep->intact(Count / 2 + 1) && live->intact(0));
+}
@@ -0,0 +1,83 @@
+/**
+ * @file    SnapshotTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests writing heap snapshots and computing dominators from them.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <unordered_map>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "HeapSnapshot.hpp"
+#include "Member.hpp"
+#include "Root.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+
+SSW_TEST(snapshotDominatorsOfDiamondAndCycle) {
+	DynamicHeap heap{1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	
+	// a -> b, c -> d (diamond), d -> e <-> f -> d (cycles), and garbage g -> d
+	Root<Node> a{new Node(0)};
+	Node *nodes[7] = {a};
+	for(std::size_t i = 1; i < 7; i++) {
+		nodes[i] = new Node(i);
+	}
+	Node *b = nodes[1], *c = nodes[2], *d = nodes[3], *e = nodes[4], *f = nodes[5], *g = nodes[6];
+	a->left = b;
+	a->right = c;
+	b->left = d;
+	c->left = d;
+	d->left = e;
+	e->left = f;
+	f->left = e;
+	f->right = d;
+	g->left = d;
+	
+	std::stringstream stream;
+	SSW_CHECK(heap.writeSnapshot(stream));
+	HeapSnapshot snapshot;
+	SSW_CHECK(snapshot.read(stream));
+	snapshot.computeDominators();
+	
+	const auto &objects = snapshot.objects();
+	SSW_CHECK(objects.size() == 7);
+	std::unordered_map<std::uint64_t, HeapSnapshot::Index> index;
+	for(std::size_t i = 0; i < objects.size(); i++) {
+		index[objects[i].address] = static_cast<HeapSnapshot::Index>(i);
+	}
+	const auto object = [&](const Node *node) -> const HeapSnapshot::Object& {
+		return objects[index.at(reinterpret_cast<std::uintptr_t>(node))];
+	};
+	const auto dominator = [&](const Node *node) {
+		return object(node).dominator;
+	};
+	const auto indexOf = [&](const Node *node) {
+		return index.at(reinterpret_cast<std::uintptr_t>(node));
+	};
+	
+	SSW_CHECK(snapshot.roots().size() == 1 && snapshot.roots()[0] == indexOf(a));
+	SSW_CHECK(dominator(a) == objects.size());
+	SSW_CHECK(dominator(b) == indexOf(a) && dominator(c) == indexOf(a));
+	// Reachable through both sides of the diamond, and from the cycle it dominates
+	SSW_CHECK(dominator(d) == indexOf(a));
+	SSW_CHECK(dominator(e) == indexOf(d) && dominator(f) == indexOf(e));
+	SSW_CHECK(dominator(g) == HeapSnapshot::Unreachable);
+	
+	const std::uint64_t size = object(a).size;
+	SSW_CHECK(size == sizeof(Node));
+	SSW_CHECK(object(f).retainedSize == size && object(e).retainedSize == 2 * size);
+	SSW_CHECK(object(d).retainedSize == 3 * size);
+	SSW_CHECK(object(b).retainedSize == size && object(c).retainedSize == size);
+	SSW_CHECK(object(a).retainedSize == 6 * size);
+	SSW_CHECK(object(g).retainedSize == 0);
+	SSW_CHECK(snapshot.reachableSize() == 6 * size);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file    StaticTypeDescriptorTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests type descriptors generated at compile time.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Test.hpp"
+#include "TypeDescriptor.hpp"
+
+using namespace ssw;
+
+namespace {
+
+/**
+ * A managed object with pointer fields around a plain field, described at compile time.
+ */
+struct Pair : public HeapObject<Pair, ThreadHeap>
+{
+	static const TypeDescriptor &type;
+	static std::size_t live;
+	
+	Member<Pair> first;
+	std::size_t value;
+	Member<Pair> second;
+	
+	explicit Pair(std::size_t value)
+			: first(nullptr), value(value), second(nullptr) {
+		live++;
+	}
+	
+	~Pair() {
+		live--;
+	}
+};
+
+std::size_t Pair::live = 0;
+
+constexpr StaticTypeDescriptor<Pair, offsetof(Pair, first), offsetof(Pair, second)> pairType{"Pair"};
+const TypeDescriptor &Pair::type = pairType;
+
+/** The same type, described at run time. */
+const TypeDescriptor &dynamicPairType = *TypeDescriptor::make<Pair>(&Pair::first, &Pair::second);
+
+/**
+ * A trivially destructible type without pointers.
+ */
+struct Leaf
+{
+	std::size_t value;
+};
+
+constexpr StaticTypeDescriptor<Leaf> leafType;
+
+} // namespace
+
+SSW_TEST(staticDescriptorsMatchDynamicOnes) {
+	const TypeDescriptor &type = pairType;
+	SSW_CHECK(&pairType.descriptor() == &type);
+	SSW_CHECK(type.size() == dynamicPairType.size() && type.size() == sizeof(Pair));
+	SSW_CHECK(type.offsets() == 2 && dynamicPairType.offsets() == 2);
+	SSW_CHECK(std::vector<std::ptrdiff_t>(type.begin(), type.end())
+			== std::vector<std::ptrdiff_t>(dynamicPairType.begin(), dynamicPairType.end()));
+	SSW_CHECK(type && !type.leaf() && !type.triviallyDestructible());
+	SSW_CHECK(std::strcmp(type.name(), "Pair") == 0);
+	
+	const TypeDescriptor &leaf = leafType;
+	SSW_CHECK(leaf.size() == sizeof(Leaf) && leaf.offsets() == 0 && leaf.begin() == leaf.end());
+	SSW_CHECK(!leaf && leaf.leaf() && leaf.triviallyDestructible());
+	SSW_CHECK(!leaf.name());
+}
+
+SSW_TEST(objectsWithStaticDescriptorsAreTracedAndDestroyed) {
+	DynamicHeap heap{1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(64 * 1024);
+	Pair::live = 0;
+	
+	// Both pointer fields are traced, and updated when their targets are moved
+	Local<Pair> root{new Pair(0)};
+	root->first = new Pair(1);
+	root->second = new Pair(2);
+	root->second->first = root;
+	new Pair(3);
+	heap.minorGc();
+	heap.compact();
+	SSW_CHECK(Pair::live == 3);
+	SSW_CHECK(root->first->value == 1 && root->second->value == 2 && root->second->first == root);
+	
+	root->first = nullptr;
+	heap.gc();
+	SSW_CHECK(Pair::live == 2);
+	root = nullptr;
+	heap.gc();
+	SSW_CHECK(Pair::live == 0);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file    SweeperTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests sweeping on the background sweeper thread.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "Heap.hpp"
+#include "Local.hpp"
+#include "Test.hpp"
+#include "TestHeap.hpp"
+#include "TestNode.hpp"
+
+using namespace ssw;
+using test::Node;
+using test::TestHeap;
+
+namespace {
+
+/**
+ * Allocate the specified number of nodes with consecutive ids, keeping every other one in the specified
+ * list.
+ * 
+ * @param garbage Receives the ids of the nodes that are not kept.
+ */
+void allocateNodes(Local<Node> &list, std::size_t first, std::size_t count, std::vector<std::size_t> &garbage) {
+	for(std::size_t i = first; i < first + count; i++) {
+		Node *node = new Node(i);
+		if(i % 2) {
+			node->left = list;
+			list = node;
+		} else {
+			garbage.push_back(i);
+		}
+	}
+}
+
+} // namespace
+
+SSW_TEST(backgroundSweeperDestroysEveryDeadObjectOnce) {
+	TestHeap heap{4 * 1024 * 1024, 4 * 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.backgroundSweep(true);
+	SSW_CHECK(heap.backgroundSweep());
+	// Only touched with the heap lock held, by the sweeper or by allocations that sweep on their own
+	std::vector<std::size_t> destroyed;
+	Node::destroyed = &destroyed;
+	Node::live = 0;
+	
+	const std::size_t count = 20000;
+	Local<Node> list{nullptr};
+	std::vector<std::size_t> garbage;
+	std::size_t next = 0;
+	allocateNodes(list, next, count, garbage);
+	next += count;
+	for(int round = 0; round < 4; round++) {
+		// Drop the older half of the kept nodes, and allocate while the sweeper sweeps
+		Node *node = list;
+		for(std::size_t i = 0; i < count / 4 && node->left; i++) {
+			node = node->left;
+		}
+		for(const Node *dead = node->left; dead; dead = dead->left) {
+			garbage.push_back(dead->id);
+		}
+		node->left = nullptr;
+		heap.gc();
+		allocateNodes(list, next, count, garbage);
+		next += count;
+	}
+	
+	// Stopping the sweeper joins it and finishes the sweep
+	heap.backgroundSweep(false);
+	SSW_CHECK(!heap.backgroundSweep());
+	std::sort(destroyed.begin(), destroyed.end());
+	// The garbage of the last round has not been collected yet
+	std::sort(garbage.begin(), garbage.end());
+	const auto collected = std::lower_bound(garbage.begin(), garbage.end(), next - count);
+	SSW_CHECK(std::adjacent_find(destroyed.begin(), destroyed.end()) == destroyed.end());
+	SSW_CHECK(std::equal(destroyed.begin(), destroyed.end(), garbage.begin(), collected)
+			&& destroyed.size() == static_cast<std::size_t>(collected - garbage.begin()));
+	SSW_CHECK(Node::live == next - destroyed.size());
+	SSW_CHECK(heap.statsMatchHeapWalk());
+	
+	// The sweeper can be started again
+	heap.backgroundSweep(true);
+	list = nullptr;
+	heap.gc();
+	heap.backgroundSweep(false);
+	SSW_CHECK(Node::live == 0);
+	Node::destroyed = nullptr;
+}
+
+SSW_TEST(destroyingHeapStopsBackgroundSweeper) {
+	std::vector<std::size_t> destroyed;
+	Node::destroyed = &destroyed;
+	std::vector<std::size_t> garbage;
+	{
+		DynamicHeap heap{4 * 1024 * 1024, 4 * 1024 * 1024};
+		ThreadHeap::Scope scope{heap};
+		heap.backgroundSweep(true);
+		Local<Node> list{nullptr};
+		allocateNodes(list, 0, 50000, garbage);
+		list = nullptr;
+		// The heap goes away while the sweeper is busy with this cycle
+		heap.gc();
+	}
+	// Whatever was swept before the sweeper stopped was destroyed once
+	std::sort(destroyed.begin(), destroyed.end());
+	SSW_CHECK(std::adjacent_find(destroyed.begin(), destroyed.end()) == destroyed.end());
+	SSW_CHECK(destroyed.size() <= 50000);
+	Node::destroyed = nullptr;
+}
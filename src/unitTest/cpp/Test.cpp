@@ -0,0 +1,62 @@
+/**
+ * @file    Test.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Implements the minimal test framework used by the tests of the managed heap.
+ */
+
+#include "Test.hpp"
+
+#include <iostream>
+#include <vector>
+
+namespace ssw {
+namespace test {
+
+namespace {
+
+struct TestCase {
+	const char *name;
+	void (*run)();
+};
+
+/**
+ * Get the registered tests. Tests are registered during static initialization, so the list must be
+ * constructed on first use.
+ */
+std::vector<TestCase>& testCases() {
+	static std::vector<TestCase> cases;
+	return cases;
+}
+
+/** The number of failed checks of the running test. */
+int failedChecks = 0;
+
+} // namespace
+
+TestRegistration::TestRegistration(const char *name, void (*run)()) {
+	testCases().push_back({name, run});
+}
+
+void fail(const char *expression, const char *file, int line) noexcept {
+	failedChecks++;
+	std::cout << "  " << file << ':' << line << ": check failed: " << expression << std::endl;
+}
+
+int runTests() {
+	int failed = 0;
+	for(const auto &test : testCases()) {
+		std::cout << test.name << std::endl;
+		failedChecks = 0;
+		test.run();
+		if(failedChecks) {
+			failed++;
+			std::cout << "  FAILED" << std::endl;
+		}
+	}
+	std::cout << testCases().size() - failed << " of " << testCases().size() << " tests passed" << std::endl;
+	return failed;
+}
+
+} // namespace test
+} // namespace ssw
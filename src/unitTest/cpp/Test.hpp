@@ -0,0 +1,57 @@
+/**
+ * @file    Test.hpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Declares the minimal test framework used by the tests of the managed heap.
+ */
+
+#ifndef TEST_HPP_
+#define TEST_HPP_
+#pragma once
+
+namespace ssw {
+namespace test {
+
+/**
+ * Registers a test function, which is run by {@link runTests}. Created by {@link SSW_TEST}.
+ */
+struct TestRegistration {
+	TestRegistration(const char *name, void (*run)());
+};
+
+/**
+ * Record a failed check of the running test and print the failed expression.
+ * 
+ * @param expression The expression that was `false`.
+ * @param file The source file of the check.
+ * @param line The line of the check.
+ */
+void fail(const char *expression, const char *file, int line) noexcept;
+
+/**
+ * Run all registered tests in the order of registration, printing the name and result of each.
+ * 
+ * @return The number of failed tests.
+ */
+int runTests();
+
+} // namespace test
+} // namespace ssw
+
+/**
+ * Define a test function with the specified name and register it to be run by {@link ssw::test::runTests}.
+ * The body of the function follows the macro.
+ */
+#define SSW_TEST(name) \
+	static void name(); \
+	static const ssw::test::TestRegistration name##Registration{#name, &name}; \
+	static void name()
+
+/**
+ * Check that the specified expression is `true`, and fail the running test otherwise. The test goes on after
+ * a failed check.
+ */
+#define SSW_CHECK(expression) \
+	((expression) ? static_cast<void>(0) : ssw::test::fail(#expression, __FILE__, __LINE__))
+
+#endif /* TEST_HPP_ */
@@ -0,0 +1,78 @@
+/**
+ * @file    TestHeap.hpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Declares helpers shared by the tests that look at the blocks of a heap.
+ */
+
+#ifndef TESTHEAP_HPP_
+#define TESTHEAP_HPP_
+#pragma once
+
+#include <cstddef>
+
+#include "Heap.hpp"
+
+namespace ssw {
+namespace test {
+
+/**
+ * A dynamic heap that also offers statistics collected by walking the heap, so tests can compare them to
+ * the statistics that are maintained during allocation and garbage collection.
+ */
+class TestHeap : public DynamicHeap
+{
+public:
+	
+	using DynamicHeap::DynamicHeap;
+	using HeapBase::collectHeapStats;
+	
+	/**
+	 * Check whether the maintained statistics (see {@link HeapBase::stats}) agree with those of a heap walk.
+	 * The heap walk sweeps all blocks first, so this is only meaningful without a pending sweep.
+	 */
+	bool statsMatchHeapWalk() noexcept {
+		const auto walk = this->collectHeapStats();
+		const auto kept = this->stats();
+		return kept.heapSize == walk.heapSize && kept.usedSize == walk.usedSize && kept.freeSize == walk.freeSize
+				&& kept.numFreeBlocks == walk.numFreeBlocks && kept.freeBlockSize == walk.freeBlockSize
+				&& kept.numObjects == walk.numObjects && kept.objectSize == walk.objectSize;
+	}
+	
+	/**
+	 * Check whether the live objects recorded by the last collection agree with those found by marking the
+	 * heap, which is only the case until objects are allocated or become unreachable.
+	 */
+	bool liveStatsMatchHeapWalk() noexcept {
+		const auto walk = this->collectHeapStats(true);
+		const auto kept = this->stats();
+		return kept.numLiveObjects == walk.numLiveObjects && kept.liveObjectSize == walk.liveObjectSize;
+	}
+};
+
+/**
+ * A managed type without pointers that is exactly the specified number of bytes large.
+ */
+template <std::size_t Size>
+struct Blob
+{
+	static const TypeDescriptor &type;
+	
+	unsigned char data[Size];
+};
+
+template <std::size_t Size>
+const TypeDescriptor &Blob<Size>::type = *TypeDescriptor::make<Blob<Size>>();
+
+/**
+ * Allocate a blob of the specified number of heap alignment units (see {@link HeapBase::Align}).
+ */
+template <std::size_t Units>
+byte* allocateUnits(HeapBase &heap) noexcept {
+	return static_cast<byte*>(heap.allocate(Blob<Units * HeapBase::Align>::type));
+}
+
+} // namespace test
+} // namespace ssw
+
+#endif /* TESTHEAP_HPP_ */
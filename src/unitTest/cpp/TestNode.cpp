@@ -0,0 +1,20 @@
+/**
+ * @file    TestNode.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Defines the type descriptors and counters of the shared test node types.
+ */
+
+#include "TestNode.hpp"
+
+namespace ssw {
+namespace test {
+
+const TypeDescriptor &Node::type = *TypeDescriptor::make<Node>(&Node::left, &Node::right);
+std::atomic<std::size_t> Node::live{0};
+std::vector<std::size_t> *Node::destroyed = nullptr;
+
+const TypeDescriptor &Slot::type = *TypeDescriptor::make<Slot>(&Slot::node);
+
+} // namespace test
+} // namespace ssw
@@ -0,0 +1,76 @@
+/**
+ * @file    TestNode.hpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Declares the managed node types shared by the tests of the managed heap.
+ */
+
+#ifndef TESTNODE_HPP_
+#define TESTNODE_HPP_
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Member.hpp"
+
+namespace ssw {
+namespace test {
+
+/**
+ * A node with two pointers to other nodes, allocated on the heap of the running thread (see
+ * {@link ThreadHeap::Scope}). Nodes count how many of them are alive, so tests can check that exactly the
+ * expected nodes were destroyed.
+ */
+struct Node : public HeapObject<Node, ThreadHeap>
+{
+	static const TypeDescriptor &type;
+	/** The number of constructed and not yet destroyed nodes, which the sweeper thread updates as well. */
+	static std::atomic<std::size_t> live;
+	/** If set, the ids of destroyed nodes are appended to this list. */
+	static std::vector<std::size_t> *destroyed;
+	
+	Member<Node> left;
+	Member<Node> right;
+	std::size_t id;
+	/** Derived from the id, to detect nodes that were overwritten. */
+	std::size_t check;
+	
+	explicit Node(std::size_t id)
+			: left(nullptr), right(nullptr), id(id), check(~id) {
+		live++;
+	}
+	
+	~Node() {
+		live--;
+		if(destroyed) {
+			destroyed->push_back(id);
+		}
+	}
+	
+	/**
+	 * Check whether this node has the specified id and was not overwritten.
+	 */
+	bool intact(std::size_t expected) const noexcept {
+		return id == expected && check == ~id;
+	}
+};
+
+/**
+ * An element of managed arrays of nodes (see {@link Array}).
+ */
+struct Slot
+{
+	using HeapType = ThreadHeap;
+	static const TypeDescriptor &type;
+	
+	Member<Node> node;
+};
+
+} // namespace test
+} // namespace ssw
+
+#endif /* TESTNODE_HPP_ */
@@ -0,0 +1,189 @@
+/**
+ * @file    WeakRefTest.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Tests weak references and weak maps.
+ */
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Heap.hpp"
+#include "HeapObject.hpp"
+#include "Local.hpp"
+#include "Member.hpp"
+#include "Root.hpp"
+#include "Test.hpp"
+#include "TestNode.hpp"
+#include "WeakMap.hpp"
+#include "WeakRef.hpp"
+
+using namespace ssw;
+using test::Node;
+
+SSW_TEST(weakRefsAreClearedOnlyForGarbage) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	Local<Node> strong{new Node(1)};
+	WeakRef<Node> alive{strong};
+	WeakRef<Node> dead{new Node(2)};
+	WeakRef<Node> empty;
+	WeakRef<Node> copy{dead};
+	WeakRef<Node> moved{std::move(copy)};
+	SSW_CHECK(!copy.get() && moved.get() == dead.get());
+	SSW_CHECK(empty.expired());
+	
+	// Weak references alone do not keep objects alive, but the targets can be reassigned
+	heap.gc();
+	SSW_CHECK(Node::live == 1);
+	SSW_CHECK(alive.get() == strong && strong->intact(1));
+	SSW_CHECK(dead.expired() && moved.expired());
+	dead = strong;
+	empty = alive;
+	SSW_CHECK(dead.get() == strong && empty.get() == strong);
+	
+	strong = nullptr;
+	heap.gc();
+	SSW_CHECK(Node::live == 0);
+	SSW_CHECK(alive.expired() && dead.expired() && empty.expired());
+}
+
+SSW_TEST(weakRefsFollowMovedObjects) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(64 * 1024);
+	Node::live = 0;
+	
+	// Promotion moves young objects out of the nursery, garbage is cleared by minor collections as well
+	Local<Node> strong{new Node(1)};
+	const Node *young = strong;
+	WeakRef<Node> weak{strong};
+	WeakRef<Node> dead{new Node(2)};
+	heap.minorGc();
+	SSW_CHECK(Node::live == 1);
+	SSW_CHECK(strong != young && weak.get() == strong && weak.get()->intact(1));
+	SSW_CHECK(dead.expired());
+	
+	// Compaction slides old objects into the gaps of garbage in front of them
+	Local<Node> old{new Node(3)};
+	WeakRef<Node> weakOld{old};
+	heap.minorGc();
+	const Node *before = old;
+	strong = nullptr;
+	heap.compact();
+	SSW_CHECK(Node::live == 1);
+	SSW_CHECK(old != before && weakOld.get() == old && old->intact(3));
+	SSW_CHECK(weak.expired());
+}
+
+SSW_TEST(weakRefsDuringIncrementalMarking) {
+	DynamicHeap heap{1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	Local<Node> strong{new Node(1)};
+	WeakRef<Node> alive{strong};
+	WeakRef<Node> dead{new Node(2)};
+	WeakRef<Node> revived{new Node(3)};
+	// Greys the roots
+	SSW_CHECK(!heap.gcStep(0));
+	
+	// Unreachable objects are still available while marking, and storing them makes them reachable again
+	SSW_CHECK(dead.get() && revived.get());
+	Local<Node> local{revived.get()};
+	WeakRef<Node> young{new Node(4)};
+	strong = nullptr;
+	while(!heap.gcStep(1)) {
+	}
+	SSW_CHECK(dead.expired());
+	SSW_CHECK(revived.get() == local && local->intact(3));
+	// Removing the last strong reference during the cycle only takes effect in the next one
+	SSW_CHECK(alive.get() && alive.get()->intact(1));
+	// Objects allocated during marking survive the cycle
+	SSW_CHECK(young.get() && young.get()->intact(4));
+	SSW_CHECK(Node::live == 3);
+	
+	heap.gc();
+	SSW_CHECK(Node::live == 1);
+	SSW_CHECK(alive.expired() && young.expired() && revived.get() == local);
+}
+
+SSW_TEST(weakMapDropsEntriesOfGarbageKeys) {
+	DynamicHeap heap{1024 * 1024, 1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	heap.nurserySize(64 * 1024);
+	Node::live = 0;
+	constexpr std::size_t Keys = 100;
+	
+	// The map does not keep its keys alive, every other key is garbage
+	WeakMap<Node, std::size_t> map;
+	std::vector<Root<Node>> keys;
+	for(std::size_t i = 0; i < Keys; i++) {
+		Node *key = new Node(i);
+		map.insert(key, i);
+		if(i % 2 == 0) {
+			keys.emplace_back(key);
+		}
+	}
+	std::size_t value = 0;
+	map.insert(keys[0], Keys);
+	SSW_CHECK(map.size() == Keys && map.find(keys[0], value) && value == Keys);
+	map.insert(keys[0], 0);
+	
+	// Promotion moves the keys, the entries are found at the new addresses
+	const Node *young = keys[1];
+	heap.minorGc();
+	SSW_CHECK(Node::live == Keys / 2 && map.size() == Keys / 2);
+	SSW_CHECK(keys[1] != young && !map.contains(young));
+	for(std::size_t i = 0; i < keys.size(); i++) {
+		SSW_CHECK(map.find(keys[i], value) && value == 2 * i);
+	}
+	
+	// Compaction moves them again
+	const Node *before = keys.back();
+	for(std::size_t i = 0; i < keys.size(); i += 2) {
+		keys[i] = nullptr;
+	}
+	heap.compact();
+	SSW_CHECK(Node::live == Keys / 4 && map.size() == Keys / 4);
+	SSW_CHECK(keys.back() != before);
+	for(std::size_t i = 1; i < keys.size(); i += 2) {
+		SSW_CHECK(map.find(keys[i], value) && value == 2 * i && keys[i]->intact(2 * i));
+	}
+	
+	// Erased entries are gone although their keys are alive
+	SSW_CHECK(map.erase(keys[1]) && !map.erase(keys[1]));
+	SSW_CHECK(!map.contains(keys[1]) && map.size() == Keys / 4 - 1);
+	map.clear();
+	SSW_CHECK(map.size() == 0 && !map.contains(keys[3]));
+	heap.gc();
+	SSW_CHECK(Node::live == Keys / 4);
+}
+
+SSW_TEST(weakMapDuringIncrementalMarking) {
+	DynamicHeap heap{1024 * 1024};
+	ThreadHeap::Scope scope{heap};
+	Node::live = 0;
+	
+	WeakMap<Node, std::size_t> map;
+	Local<Node> alive{new Node(1)};
+	map.insert(alive, 1);
+	map.insert(new Node(2), 2);
+	SSW_CHECK(!heap.gcStep(0));
+	
+	// Keys inserted during marking are new objects, which survive the cycle
+	Node *young = new Node(3);
+	map.insert(young, 3);
+	while(!heap.gcStep(1)) {
+	}
+	std::size_t value = 0;
+	SSW_CHECK(map.size() == 2 && Node::live == 2);
+	SSW_CHECK(map.find(alive, value) && value == 1);
+	SSW_CHECK(map.find(young, value) && value == 3);
+	
+	heap.gc();
+	SSW_CHECK(map.size() == 1 && Node::live == 1);
+}
@@ -0,0 +1,13 @@
+/**
+ * @file    main.cpp
+ * @author  niob
+ * @date    Oct 15, 2026
+ * @brief   Runs the tests of the managed heap.
+ */
+
+#include "Test.hpp"
+
+// The tests are registered with SSW_TEST in the other source files, and each of them uses heaps of its own
+int main() {
+	return ssw::test::runTests() ? 1 : 0;
+}